@@ -0,0 +1,222 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// CARE headers
+#include "care/care.h"
+#include "care/array_utils.h"
+#include "care/SearchIndex.h"
+
+// Other library headers
+#include <benchmark/benchmark.h>
+
+// Each benchmark runs the array_utils host path once per instruction set
+// (state.range(1)), so the vector kernels can be compared against the
+// portable ones for each element type.
+
+template <typename T>
+static care::host_device_ptr<T> setupArray(benchmark::State& state) {
+   const int size = state.range(0);
+   care::simd::setLevel(static_cast<care::simd::Level>(state.range(1)));
+
+   care::host_device_ptr<T> data(size, "data");
+   care_utils::ArrayFill<T>(data, size, T(1));
+   return data;
+}
+
+template <typename T>
+static void benchmark_array_min(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<T> data = setupArray<T>(state);
+
+   while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(care_utils::ArrayMin<T>(data, size, T(2)));
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(T));
+   data.free();
+}
+
+template <typename T>
+static void benchmark_array_max(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<T> data = setupArray<T>(state);
+
+   while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(care_utils::ArrayMax<T>(data, size, T(0)));
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(T));
+   data.free();
+}
+
+template <typename T>
+static void benchmark_array_sum(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<T> data = setupArray<T>(state);
+
+   while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(care_utils::ArraySum<T>(data, size, T(0)));
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(T));
+   data.free();
+}
+
+template <typename T>
+static void benchmark_array_count(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<T> data = setupArray<T>(state);
+
+   while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(care_utils::ArrayCount<T>(data, size, T(1)));
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(T));
+   data.free();
+}
+
+template <typename T>
+static void benchmark_array_fill(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<T> data = setupArray<T>(state);
+
+   while (state.KeepRunning()) {
+      care_utils::ArrayFill<T>(data, size, T(3));
+      benchmark::ClobberMemory();
+   }
+
+   state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(T));
+   data.free();
+}
+
+// Sizes from L1 resident to main memory, for scalar, AVX2 and AVX-512
+// (levels the cpu does not support fall back to the widest one it does)
+static void arguments(benchmark::internal::Benchmark* benchmark) {
+   for (int size : {1 << 10, 1 << 16, 1 << 22}) {
+      for (int level = 0; level <= 2; ++level) {
+         benchmark->Args({size, level});
+      }
+   }
+}
+
+#define CARE_ARRAY_UTILS_BENCHMARKS(TYPE) \
+   BENCHMARK_TEMPLATE(benchmark_array_min, TYPE)->Apply(arguments); \
+   BENCHMARK_TEMPLATE(benchmark_array_max, TYPE)->Apply(arguments); \
+   BENCHMARK_TEMPLATE(benchmark_array_sum, TYPE)->Apply(arguments); \
+   BENCHMARK_TEMPLATE(benchmark_array_count, TYPE)->Apply(arguments); \
+   BENCHMARK_TEMPLATE(benchmark_array_fill, TYPE)->Apply(arguments);
+
+CARE_ARRAY_UTILS_BENCHMARKS(int)
+CARE_ARRAY_UTILS_BENCHMARKS(float)
+CARE_ARRAY_UTILS_BENCHMARKS(double)
+
+// Searches for every entry of a sorted map of state.range(0) even values, in
+// a scattered order, once per query with BinarySearch and then as one batch
+// against a prebuilt SearchIndex.
+static care::host_device_ptr<int> setupQueries(int size, care::host_device_ptr<int> & map) {
+   map = care::host_device_ptr<int>(size, "map");
+   care::host_device_ptr<int> queries(size, "queries");
+
+   LOOP_SEQUENTIAL(i, 0, size) {
+      map[i] = 2 * i;
+      unsigned long long hash = (i + 1) * 0x9E3779B97F4A7C15ull;
+      hash ^= hash >> 31;
+      queries[i] = 2 * (int) ((hash * 0xBF58476D1CE4E5B9ull >> 32) % size);
+   } LOOP_SEQUENTIAL_END
+
+   return queries;
+}
+
+static void benchmark_binary_search(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<int> map;
+   care::host_device_ptr<int> queries = setupQueries(size, map);
+   care::host_device_ptr<int> results(size, "results");
+
+   while (state.KeepRunning()) {
+      LOOP_STREAM(i, 0, size) {
+         results[i] = care_utils::BinarySearch<int>(map, 0, size, queries[i]);
+      } LOOP_STREAM_END
+      benchmark::ClobberMemory();
+   }
+
+   state.SetItemsProcessed(int64_t(state.iterations()) * size);
+   results.free();
+   queries.free();
+   map.free();
+}
+
+static void benchmark_batch_binary_search(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<int> map;
+   care::host_device_ptr<int> queries = setupQueries(size, map);
+   care::host_device_ptr<int> results(size, "results");
+   care::SearchIndex<int> index(map, 0, size);
+
+   while (state.KeepRunning()) {
+      care::BatchBinarySearch<int>(index, queries, size, results);
+      benchmark::ClobberMemory();
+   }
+
+   state.SetItemsProcessed(int64_t(state.iterations()) * size);
+   index.free();
+   results.free();
+   queries.free();
+   map.free();
+}
+
+BENCHMARK(benchmark_binary_search)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(benchmark_batch_binary_search)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+
+// Finds the median of state.range(0) scattered doubles, by sorting a copy and
+// by radix select.
+static care::host_device_ptr<double> setupScattered(int size) {
+   care::host_device_ptr<double> data(size, "data");
+
+   LOOP_SEQUENTIAL(i, 0, size) {
+      data[i] = (double) ((i * 2654435761ull) % 1000003) - 500000.0;
+   } LOOP_SEQUENTIAL_END
+
+   return data;
+}
+
+static void benchmark_sort_median(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<double> data = setupScattered(size);
+
+   while (state.KeepRunning()) {
+      care::host_device_ptr<double> copy = care_utils::ArrayDup<double>(data, size);
+#ifdef RAJA_GPU_ACTIVE
+      care_utils::sortArray(RAJAExec{}, copy, size);
+#else
+      care_utils::sortArray(RAJA::seq_exec{}, copy, size);
+#endif
+      benchmark::DoNotOptimize(copy.pick(size / 2));
+      copy.free();
+   }
+
+   state.SetItemsProcessed(int64_t(state.iterations()) * size);
+   data.free();
+}
+
+static void benchmark_nth_element_median(benchmark::State& state) {
+   const int size = state.range(0);
+   care::host_device_ptr<double> data = setupScattered(size);
+
+   while (state.KeepRunning()) {
+      benchmark::DoNotOptimize(care_utils::NthElement<double>(data, size, size / 2));
+   }
+
+   state.SetItemsProcessed(int64_t(state.iterations()) * size);
+   data.free();
+}
+
+BENCHMARK(benchmark_sort_median)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(benchmark_nth_element_median)->Arg(1 << 16)->Arg(1 << 22);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,197 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_CHAINED_SCAN_H_
+#define _CARE_CHAINED_SCAN_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other CARE headers
+#include "care/forall.h"
+#include "care/policies.h"
+
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+#include <omp.h>
+#endif
+
+// Std library headers
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace care {
+   namespace detail {
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Progress of one chunk of a chained scan. The flag is 0 until the
+      ///        aggregate of the chunk is published, 1 once it is, and 2 once the
+      ///        inclusive prefix through the chunk is.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T>
+      struct ChainedScanChunk {
+         std::atomic<int> flag;
+         T aggregate;
+         T inclusive;
+      };
+
+      /// Keeps a template parameter from being deduced from an argument
+      template <typename T>
+      struct NonDeduced {
+         using type = T;
+      };
+   } // namespace detail
+
+   /// The number of indices in a chunk of a chained scan, small enough that a
+   /// chunk's values stay in cache between the two halves of its single pass
+   constexpr int chainedScanChunkSize = 4096;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Single pass host scan of transform(i) over [start, end), with the
+   ///        output fused into the scan.
+   ///
+   /// Threads claim chunks of the range in order. Each evaluates transform over
+   /// its chunk into a buffer, publishes the chunk aggregate, then looks back
+   /// over the preceding chunks, combining their aggregates until it reaches one
+   /// that has published its inclusive prefix (decoupled look-back). It then
+   /// publishes its own inclusive prefix and calls scatter over the buffered
+   /// values. Every index is read and written once, and transform is evaluated
+   /// once per index. Chunks are claimed in order and a chunk publishes its
+   /// aggregate before it waits, so the look-back cannot deadlock.
+   ///
+   /// binop must be associative but need not be commutative, and no identity
+   /// is needed. Short ranges and single threaded runs scan sequentially.
+   ///
+   /// The indices are of type Index, int unless given explicitly, so ranges
+   /// of more than 2^31 indices can be scanned with a 64 bit Index, signed or
+   /// not. SCAN_LOOP_64 and SCAN_EVERYWHERE_LOOP_64 use a std::int64_t Index.
+   ///
+   /// @arg[in] fileName The name of the file where the scan is
+   /// @arg[in] lineNumber The line number of the scan
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] init The exclusive prefix of start
+   /// @arg[in] transform Returns the value of index i
+   /// @arg[in] binop The scan operation
+   /// @arg[in] scatter Called as scatter(i, prefix, value), where prefix is the
+   ///                  exclusive prefix of i and value is transform(i)
+   ///
+   /// @return init combined with the value of every index in the range
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename T, typename Index = int, typename Transform, typename BinaryOp, typename Scatter>
+   T chained_scan(const char * fileName, const int lineNumber,
+                  const typename detail::NonDeduced<Index>::type start,
+                  const typename detail::NonDeduced<Index>::type end,
+                  const T init, Transform transform, BinaryOp binop, Scatter scatter) {
+      const Index length = end - start;
+
+      if (length <= 0) {
+         return init;
+      }
+
+      const Index numChunks = (length + chainedScanChunkSize - 1) / chainedScanChunkSize;
+
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+      const int maxThreads = omp_get_max_threads();
+      const int numWorkers = (Index) maxThreads < numChunks ? maxThreads : (int) numChunks;
+#else
+      const int numWorkers = 1;
+#endif
+
+      if (numWorkers < 2) {
+         T total = init;
+         T * const totalPtr = &total;
+
+         care::forall(care::sequential{}, fileName, lineNumber, 0, 1, [=] (const int) {
+            T running = init;
+
+            for (Index i = start; i < end; ++i) {
+               const T value = transform(i);
+               scatter(i, running, value);
+               running = binop(running, value);
+            }
+
+            *totalPtr = running;
+         });
+
+         return total;
+      }
+
+      std::unique_ptr<detail::ChainedScanChunk<T>[]> chunks(new detail::ChainedScanChunk<T>[numChunks]());
+      std::atomic<Index> nextChunk(0);
+
+      for (Index chunk = 0; chunk < numChunks; ++chunk) {
+         chunks[chunk].flag.store(0, std::memory_order_relaxed);
+      }
+
+      detail::ChainedScanChunk<T> * const status = chunks.get();
+      std::atomic<Index> * const counter = &nextChunk;
+
+      care::forall(care::openmp{}, fileName, lineNumber, 0, numWorkers, [=] (const int) {
+         std::vector<T> values(chainedScanChunkSize);
+
+         for (Index chunk = counter->fetch_add(1); chunk < numChunks; chunk = counter->fetch_add(1)) {
+            const Index chunkStart = start + chunk * chainedScanChunkSize;
+            const Index chunkEnd = end - chunkStart < chainedScanChunkSize ? end : chunkStart + chainedScanChunkSize;
+
+            T aggregate = values[0] = transform(chunkStart);
+
+            for (Index i = chunkStart + 1; i < chunkEnd; ++i) {
+               const T value = transform(i);
+               values[i - chunkStart] = value;
+               aggregate = binop(aggregate, value);
+            }
+
+            T prefix = init;
+
+            if (chunk > 0) {
+               status[chunk].aggregate = aggregate;
+               status[chunk].flag.store(1, std::memory_order_release);
+
+               bool havePrefix = false;
+
+               for (Index previous = chunk - 1; ; --previous) {
+                  int flag = status[previous].flag.load(std::memory_order_acquire);
+
+                  while (flag == 0) {
+                     std::this_thread::yield();
+                     flag = status[previous].flag.load(std::memory_order_acquire);
+                  }
+
+                  const T value = flag == 2 ? status[previous].inclusive : status[previous].aggregate;
+                  prefix = havePrefix ? binop(value, prefix) : value;
+                  havePrefix = true;
+
+                  if (flag == 2) {
+                     break;
+                  }
+               }
+            }
+
+            status[chunk].inclusive = binop(prefix, aggregate);
+            status[chunk].flag.store(2, std::memory_order_release);
+
+            T running = prefix;
+
+            for (Index i = chunkStart; i < chunkEnd; ++i) {
+               const T value = values[i - chunkStart];
+               scatter(i, running, value);
+               running = binop(running, value);
+            }
+         }
+      });
+
+      return chunks[numChunks - 1].inclusive;
+   }
+} // namespace care
+
+#endif // !defined(_CARE_CHAINED_SCAN_H_)
+
@@ -15,6 +15,9 @@
 #include "care/forall.h"
 #include "care/policies.h"
 
+// Std library headers
+#include <cstdint>
+
 // This makes sure the lambdas get decorated with the right __host__ and or
 // __device__ specifiers
 #if defined(__GPUCC__) && defined(GPU_ACTIVE)
@@ -64,6 +67,20 @@
 
 #define CARE_CHECKED_FOR_LOOP_END(CHECK) CARE_NEST_END(CHECK)
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a vanilla for loop over 64 bit indices.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_FOR_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK) for (std::int64_t INDEX = START_INDEX; INDEX < END_INDEX; ++INDEX) CARE_NEST_BEGIN(CHECK)
+
+#define CARE_CHECKED_FOR_LOOP_64_END(CHECK) CARE_NEST_END(CHECK)
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end a region of raw host code.
@@ -89,6 +106,36 @@
 
 #define CARE_CHECKED_OPENMP_FOR_LOOP_END(CHECK) CARE_NEST_END(CHECK) OMP_FOR_END }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a vanilla OpenMP 3.0 for loop over 64 bit
+///        indices.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_OPENMP_FOR_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK) { std::int64_t const __end_ndx = END_INDEX; OMP_FOR_BEGIN for (std::int64_t INDEX = START_INDEX; INDEX < __end_ndx; ++INDEX) CARE_NEST_BEGIN(CHECK)
+
+#define CARE_CHECKED_OPENMP_FOR_LOOP_64_END(CHECK) CARE_NEST_END(CHECK) OMP_FOR_END }
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a vanilla OpenMP 3.0 for loop with dynamic
+///        scheduling.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_OPENMP_DYNAMIC_FOR_LOOP_START(INDEX, START_INDEX, END_INDEX, CHECK) { int const __end_ndx = END_INDEX; OMP_DYNAMIC_FOR_BEGIN for (int INDEX = START_INDEX; INDEX < __end_ndx; ++INDEX) CARE_NEST_BEGIN(CHECK)
+
+#define CARE_CHECKED_OPENMP_DYNAMIC_FOR_LOOP_END(CHECK) CARE_NEST_END(CHECK) OMP_DYNAMIC_FOR_END }
+
 
 
 
@@ -154,6 +201,23 @@
 
 #define CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_END(CHECK) CARE_CHECKED_FOR_LOOP_END(CHECK)
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a sequential RAJA loop over 64 bit indices
+///        that captures some variables by reference. The legacy version uses a
+///        raw for loop.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+/// @arg[in] __VA_ARGS__ The variables to capture by reference
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_START(INDEX, START_INDEX, END_INDEX, CHECK, ...) CARE_CHECKED_FOR_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK)
+
+#define CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_END(CHECK) CARE_CHECKED_FOR_LOOP_64_END(CHECK)
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end a sequential RAJA loop of length one.
@@ -196,6 +260,23 @@
 
 #define CARE_CHECKED_OPENMP_LOOP_END(CHECK) CARE_CHECKED_OPENMP_FOR_LOOP_END(CHECK)
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a work stealing loop, for iterations that
+///        vary widely in cost. If OpenMP is not available, executes
+///        sequentially on the host. The legacy version uses raw OpenMP with
+///        dynamic scheduling.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_DYNAMIC_LOOP_START(INDEX, START_INDEX, END_INDEX, CHECK) CARE_CHECKED_OPENMP_DYNAMIC_FOR_LOOP_START(INDEX, START_INDEX, END_INDEX, CHECK)
+
+#define CARE_CHECKED_DYNAMIC_LOOP_END(CHECK) CARE_CHECKED_OPENMP_DYNAMIC_FOR_LOOP_END(CHECK)
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end an OpenMP RAJA loop that captures some
@@ -257,6 +338,21 @@
 
 #define CARE_CHECKED_PARALLEL_LOOP_END(CHECK) CARE_CHECKED_OPENMP_FOR_LOOP_END(CHECK)
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a parallel RAJA loop over 64 bit indices.
+///        The legacy version uses raw OpenMP.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_PARALLEL_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK) CARE_CHECKED_OPENMP_FOR_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK)
+
+#define CARE_CHECKED_PARALLEL_LOOP_64_END(CHECK) CARE_CHECKED_OPENMP_FOR_LOOP_64_END(CHECK)
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end a GPU RAJA loop of length one. If GPU is
@@ -366,6 +462,26 @@
 #define CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_END(CHECK) }); \
    CARE_NEST_END(CHECK) }}
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a sequential RAJA loop over 64 bit indices
+///        that captures some variables by reference.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+/// @arg[in] __VA_ARGS__ The variables to capture by reference
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_START(INDEX, START_INDEX, END_INDEX, CHECK, ...) { \
+   if (END_INDEX > START_INDEX) { \
+      CARE_NEST_BEGIN(CHECK) \
+      care::forall_64(care::sequential{}, __FILE__, __LINE__, START_INDEX, END_INDEX, [= FOR_EACH(REF_CAPTURE, __VA_ARGS__)] (const std::int64_t INDEX) {
+
+#define CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_END(CHECK) }); \
+   CARE_NEST_END(CHECK) }}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end a sequential RAJA loop of length one.
@@ -415,6 +531,26 @@
 #define CARE_CHECKED_OPENMP_LOOP_END(CHECK) }); \
    CARE_NEST_END(CHECK) }}
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a work stealing loop, for iterations that
+///        vary widely in cost. If OpenMP is not available, executes
+///        sequentially on the host.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_DYNAMIC_LOOP_START(INDEX, START_INDEX, END_INDEX, CHECK) { \
+   if (END_INDEX > START_INDEX) { \
+      CARE_NEST_BEGIN(CHECK) \
+      care::forall(care::dynamic{}, __FILE__, __LINE__, START_INDEX, END_INDEX, [=] (const int INDEX) {
+
+#define CARE_CHECKED_DYNAMIC_LOOP_END(CHECK) }); \
+   CARE_NEST_END(CHECK) }}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end an OpenMP RAJA loop that captures some
@@ -505,6 +641,26 @@
 #define CARE_CHECKED_PARALLEL_LOOP_END(CHECK) }); \
    CARE_NEST_END(CHECK) }}
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a parallel RAJA loop over 64 bit indices,
+///        executed as CARE_CHECKED_PARALLEL_LOOP_START is, except that the
+///        OpenMP policy is not adaptive.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+/// @arg[in] CHECK The variable to check that the start and end macros match
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_CHECKED_PARALLEL_LOOP_64_START(INDEX, START_INDEX, END_INDEX, CHECK) { \
+   if (END_INDEX > START_INDEX) { \
+      CARE_NEST_BEGIN(CHECK) \
+      care::forall_64(care::parallel{}, __FILE__, __LINE__, START_INDEX, END_INDEX, [=] CARE_DEVICE_ACTIVE (const std::int64_t INDEX) {
+
+#define CARE_CHECKED_PARALLEL_LOOP_64_END(CHECK) }); \
+   CARE_NEST_END(CHECK) }}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end a GPU RAJA loop of length one. If GPU is
@@ -665,6 +821,22 @@
 
 #define CARE_OPENMP_LOOP_END CARE_CHECKED_OPENMP_LOOP_END(care_openmp_loop_check)
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @brief Macros that start and end a work stealing loop on the host, for
+///        loops whose iterations vary widely in cost, such as loops over
+///        mixed material zones. If OpenMP is not available, executes
+///        sequentially on the host.
+///
+/// @arg[in] INDEX The index variable
+/// @arg[in] START_INDEX The starting index (inclusive)
+/// @arg[in] END_INDEX The ending index (exclusive)
+///
+////////////////////////////////////////////////////////////////////////////////
+#define CARE_DYNAMIC_LOOP(INDEX, START_INDEX, END_INDEX) CARE_CHECKED_DYNAMIC_LOOP_START(INDEX, START_INDEX, END_INDEX, care_dynamic_loop_check)
+
+#define CARE_DYNAMIC_LOOP_END CARE_CHECKED_DYNAMIC_LOOP_END(care_dynamic_loop_check)
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief Macros that start and end an OpenMP RAJA loop that captures some
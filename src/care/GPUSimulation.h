@@ -0,0 +1,127 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_GPU_SIMULATION_H_
+#define _CARE_GPU_SIMULATION_H_
+
+// CARE config header
+#include "care/config.h"
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace care {
+   /// The number of simulated GPU threads in a block, matching CARE_CUDA_BLOCK_SIZE
+   constexpr int gpuSimulationBlockSize = 256;
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// An index or dimension of a simulated kernel launch, like
+   /// the dim3 of CUDA and HIP.
+   ///
+   ////////////////////////////////////////////////////////////////
+   struct SimulatedDim3 {
+      unsigned int x = 0;
+      unsigned int y = 0;
+      unsigned int z = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// The launch coordinates of the simulated GPU thread that the
+   /// calling host thread is running, so code written against
+   /// threadIdx, blockIdx, blockDim and gridDim can be checked in
+   /// the GPU simulation mode. Outside a simulated kernel they are
+   /// all zero.
+   ///
+   ////////////////////////////////////////////////////////////////
+   struct SimulatedGPUThread {
+      SimulatedDim3 threadIdx;
+      SimulatedDim3 blockIdx;
+      SimulatedDim3 blockDim;
+      SimulatedDim3 gridDim;
+   };
+
+   namespace detail {
+      inline SimulatedGPUThread& simulatedGPUThreadState() {
+         static thread_local SimulatedGPUThread state;
+         return state;
+      }
+   } // namespace detail
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Returns the launch coordinates of the simulated GPU thread that the
+   ///        calling host thread is running
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   inline const SimulatedGPUThread& simulatedGPUThread() {
+      return detail::simulatedGPUThreadState();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Simulates a one dimensional GPU kernel over [start, end) on the host.
+   ///        The range is split into blocks of gpuSimulationBlockSize indices, and
+   ///        with OpenMP the blocks are run concurrently by the OpenMP threads.
+   ///        The indices of a block run in order on one thread, with the launch
+   ///        coordinates of simulatedGPUThread set for each. Atomics in the body
+   ///        must therefore be thread safe, as on the device.
+   ///
+   ///        Each thread runs its own copy of the body, as RAJA's OpenMP
+   ///        reducers require, so the caller must have set the CHAI execution
+   ///        space before calling this.
+   ///
+   /// The indices are of type Index, so 64 bit ranges can be simulated too.
+   ///
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename Index, typename LB>
+   void simulate_gpu_kernel(const Index start, const Index end, const LB& body) {
+      const Index length = end - start;
+
+      if (length <= 0) {
+         return;
+      }
+
+      const Index numBlocks = (length + gpuSimulationBlockSize - 1) / gpuSimulationBlockSize;
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+#pragma omp parallel
+#endif
+      {
+         const LB threadBody = body;
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+         for (Index block = 0; block < numBlocks; ++block) {
+            SimulatedGPUThread& state = detail::simulatedGPUThreadState();
+            state.blockIdx.x = (unsigned int) block;
+            state.blockDim.x = gpuSimulationBlockSize;
+            state.gridDim.x = (unsigned int) numBlocks;
+
+            const Index blockStart = start + block * gpuSimulationBlockSize;
+            const Index blockEnd = end - blockStart < gpuSimulationBlockSize ? end : blockStart + gpuSimulationBlockSize;
+
+            for (Index i = blockStart; i < blockEnd; ++i) {
+               state.threadIdx.x = (unsigned int) (i - blockStart);
+               threadBody(i);
+            }
+
+            state = SimulatedGPUThread{};
+         }
+      }
+   }
+} // namespace care
+
+#endif // !defined(_CARE_GPU_SIMULATION_H_)
+
@@ -14,6 +14,7 @@
 // Other CARE headers
 #include "care/care.h"
 #include "care/LoopFuser.h"
+#include "care/LoopTrace.h"
 #include "care/array_utils.h"
 
 // Other library headers
@@ -29,6 +30,10 @@
 #endif
 #endif
 
+// Std library headers
+#include <type_traits>
+#include <vector>
+
 namespace care {
 
 ///////////////////////////////////////////////////////////////////////////
@@ -53,6 +58,54 @@ class KeyValueSorter {};
 template <typename T, typename Exec>
 using LocalKeyValueSorter = KeyValueSorter<T, Exec> ;
 
+///////////////////////////////////////////////////////////////////////////
+/// @brief Algorithms available to KeyValueSorter::eliminateDuplicates
+///    SORT      - Stable sort by value, remove adjacent duplicates, then
+///                sort by key to restore the original ordering.
+///    HASH      - Mark the first occurrence of each value with an open
+///                addressing hash set and compact in a single pass. No sort
+///                is needed if the keys are already in ascending order.
+///    AUTOMATIC - HASH for arithmetic value types, SORT otherwise.
+///////////////////////////////////////////////////////////////////////////
+enum class DuplicateElimination {
+   AUTOMATIC,
+   SORT,
+   HASH
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// @brief Resolves DuplicateElimination::AUTOMATIC for the value type T
+/// @param[in] method - The requested algorithm
+/// @return DuplicateElimination::SORT or DuplicateElimination::HASH
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline DuplicateElimination resolveDuplicateElimination(DuplicateElimination method) {
+   if (method == DuplicateElimination::AUTOMATIC) {
+      return std::is_arithmetic<T>::value ? DuplicateElimination::HASH
+                                          : DuplicateElimination::SORT;
+   }
+   else {
+      return method;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// @brief Returns the capacity of the open addressing hash set used to
+///    eliminate duplicates from len values. The capacity is a power of two
+///    at least twice len so that the load factor is at most one half.
+/// @param[in] len - The number of values to be inserted
+/// @return the number of slots in the hash set
+///////////////////////////////////////////////////////////////////////////
+inline int duplicateEliminationCapacity(const size_t len) {
+   int capacity = 2;
+
+   while ((size_t) capacity < 2 * len) {
+      capacity <<= 1;
+   }
+
+   return capacity;
+}
+
 
 #ifdef RAJA_GPU_ACTIVE
 
@@ -74,7 +127,10 @@ template <typename KeyT, typename ValueT, typename Exec=RAJAExec>
 inline void sortKeyValueArrays(host_device_ptr<KeyT> & keys,
                                host_device_ptr<ValueT> & values,
                                const size_t start, const size_t len,
-                               const bool noCopy=false) {
+                               const bool noCopy=false,
+                               const care::SourceLocation & caller = CARE_CALLER) {
+   care::LoopTraceScope trace("sort", caller, CHAIDataGetter<KeyT, Exec>::ChaiPolicy, len);
+
    // Allocate space for the result
    host_device_ptr<KeyT> keyResult{len};
    host_device_ptr<ValueT> valueResult{len};
@@ -440,8 +496,9 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void sort(const size_t start, const size_t len) {
-         sortKeyValueArrays(m_values, m_keys, start, len, false);
+      void sort(const size_t start, const size_t len,
+                const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_values, m_keys, start, len, false, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -450,8 +507,8 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @param[in] len - The number of elements to sort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sort(const size_t len) {
-         sort(0, len);
+      void sort(const size_t len, const care::SourceLocation & caller = CARE_CALLER) {
+         sort(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -459,8 +516,8 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @brief Sorts all the elements
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sort() {
-         sortKeyValueArrays(m_values, m_keys, 0, m_len, true);
+      void sort(const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_values, m_keys, 0, m_len, true, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -471,8 +528,9 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey(const size_t start, const size_t len) {
-         sortKeyValueArrays(m_keys, m_values, start, len, false);
+      void sortByKey(const size_t start, const size_t len,
+                     const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_keys, m_values, start, len, false, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -481,8 +539,8 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @param[in] len - The number of elements to sort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey(const size_t len) {
-         sortByKey(0, len);
+      void sortByKey(const size_t len, const care::SourceLocation & caller = CARE_CALLER) {
+         sortByKey(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -490,8 +548,8 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @brief Sorts all the elements by key
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey() {
-         sortKeyValueArrays(m_keys, m_values, 0, m_len, true);
+      void sortByKey(const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_keys, m_values, 0, m_len, true, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -503,8 +561,9 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// TODO: investigate whether radix device sort is a stable sort
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort(const size_t start, const size_t len) {
-         sortKeyValueArrays(m_values, m_keys, start, len, false);
+      void stableSort(const size_t start, const size_t len,
+                      const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_values, m_keys, start, len, false, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -513,8 +572,8 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @param[in] len - The number of elements to sort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort(const size_t len) {
-         stableSort(0, len);
+      void stableSort(const size_t len, const care::SourceLocation & caller = CARE_CALLER) {
+         stableSort(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -523,8 +582,25 @@ class KeyValueSorter<T, RAJADeviceExec> {
       /// @return void
       /// TODO: investigate whether radix device sort is a stable sort
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort() {
-         sortKeyValueArrays(m_values, m_keys, 0, m_len, true);
+      void stableSort(const care::SourceLocation & caller = CARE_CALLER) {
+         sortKeyValueArrays(m_values, m_keys, 0, m_len, true, caller);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @author Jeff Keasler, Alan Dayton
+      /// @brief Eliminates duplicate values
+      /// Of each set of duplicate values, the one with the smallest key is
+      ///    kept, and the result is ordered by key.
+      /// @param[in] method - Which algorithm to use. See DuplicateElimination.
+      /// @return void
+      ///////////////////////////////////////////////////////////////////////////
+      void eliminateDuplicates(DuplicateElimination method = DuplicateElimination::AUTOMATIC) {
+         if (resolveDuplicateElimination<T>(method) == DuplicateElimination::HASH) {
+            eliminateDuplicatesByHashing();
+         }
+         else {
+            eliminateDuplicatesBySorting();
+         }
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -535,7 +611,7 @@ class KeyValueSorter<T, RAJADeviceExec> {
       ///    step is to unsort.
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void eliminateDuplicates() {
+      void eliminateDuplicatesBySorting() {
          if (m_len > 1) {
             // Do a STABLE sort by value.
             // I believe cub::DeviceRadixSort is a
@@ -574,6 +650,104 @@ class KeyValueSorter<T, RAJADeviceExec> {
          }
       }
 
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Eliminates duplicate values
+      /// Inserts every value into an open addressing hash set in parallel.
+      ///    Each slot records the index of the element with the smallest key
+      ///    for its value, so the first occurrences can then be compacted in
+      ///    a single pass that preserves the current ordering. The final sort
+      ///    by key is skipped if the keys are already in ascending order.
+      ///    Public because device lambdas cannot be in private functions.
+      /// @return void
+      ///////////////////////////////////////////////////////////////////////////
+      void eliminateDuplicatesByHashing() {
+         if (m_len > 1) {
+            const int len = (int) m_len;
+            const int capacity = duplicateEliminationCapacity(m_len);
+            const unsigned int mask = (unsigned int) (capacity - 1);
+
+            host_device_ptr<int> table{(size_t) capacity, "eliminateDuplicates table"};
+            host_device_ptr<int> slots{m_len, "eliminateDuplicates slots"};
+            care_utils::ArrayFill<int>(table, capacity, -1);
+
+            host_device_ptr<size_t const> keys = m_keys;
+            host_device_ptr<T const> values = m_values;
+            RAJAReduceMin<int> keysAscending(1);
+
+            LOOP_REDUCE(i, 0, len) {
+               if (i > 0 && keys[i-1] > keys[i]) {
+                  keysAscending.min(0);
+               }
+
+               const T value = values[i];
+               unsigned int slot = hashValue(value) & mask;
+
+               while (true) {
+                  int owner = table[slot];
+
+                  if (owner == -1) {
+                     owner = ATOMIC_CAS(table[slot], -1, i);
+
+                     if (owner == -1) {
+                        break;
+                     }
+                  }
+
+                  if (values[owner] == value) {
+                     // Only an index with the same value ever replaces the
+                     // owner of a slot, so retry until the smallest key wins.
+                     while (keys[i] < keys[owner]) {
+                        const int previous = ATOMIC_CAS(table[slot], owner, i);
+
+                        if (previous == owner) {
+                           break;
+                        }
+
+                        owner = previous;
+                     }
+
+                     break;
+                  }
+
+                  slot = (slot + 1) & mask;
+               }
+
+               slots[i] = (int) slot;
+            } LOOP_REDUCE_END
+
+            // Allocate storage for the key value pairs without duplicates
+            host_device_ptr<size_t> newKeys{m_len, "newKeys"};
+            host_device_ptr<T> newValues{m_len, "newValues"};
+
+            // Keep the elements that own their slot
+            int newSize = 0;
+
+            SCAN_LOOP(i, 0, len, idx, newSize, table[slots[i]] == i) {
+               newKeys[idx] = keys[i];
+               newValues[idx] = values[i];
+            } SCAN_LOOP_END(len, idx, newSize)
+
+            table.free();
+            slots.free();
+
+            // Free the original key value pairs
+            free();
+
+            // Update space for the key value pairs without duplicates
+            newKeys.realloc(newSize);
+            newValues.realloc(newSize);
+
+            m_keys = newKeys;
+            m_values = newValues;
+            m_len = newSize;
+
+            // Restore original ordering
+            if (!(int) keysAscending) {
+               sortByKey();
+            }
+         }
+      }
+
    private:
       size_t m_len = 0;
       bool m_ownsPointers = false; /// Prevents memory from being freed by lambda captures
@@ -652,9 +826,9 @@ inline bool cmpValsStable(_kv<T> const & left, _kv<T> const & right)
    }
 }
 
-/// cmpValsStable<real8> specialization
+/// cmpValsStable<double> specialization
 template <>
-inline bool cmpValsStable<real8>(_kv<real8> const & left, _kv<real8> const & right)
+inline bool cmpValsStable<double>(_kv<double> const & left, _kv<double> const & right)
 {
    if (left < right) {
       return true;
@@ -984,7 +1158,9 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void sort(const size_t start, const size_t len) const {
+      void sort(const size_t start, const size_t len,
+                const care::SourceLocation & caller = CARE_CALLER) const {
+         care::LoopTraceScope trace("sort", caller, chai::CPU, len);
          CHAIDataGetter<_kv<T>, RAJA::seq_exec> getter {};
          _kv<T> * rawData = getter.getRawArrayData(m_keyValues) + start;
          std::sort(rawData, rawData + len);
@@ -996,8 +1172,8 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @param[in] len - The number of elements to sort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sort(const size_t len) const {
-         sort(0, len);
+      void sort(const size_t len, const care::SourceLocation & caller = CARE_CALLER) const {
+         sort(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1005,8 +1181,8 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @brief Sorts all the elements by value
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sort() const {
-         sort(m_len);
+      void sort(const care::SourceLocation & caller = CARE_CALLER) const {
+         sort(m_len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1019,7 +1195,9 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey(const size_t start, const size_t len) const {
+      void sortByKey(const size_t start, const size_t len,
+                     const care::SourceLocation & caller = CARE_CALLER) const {
+         care::LoopTraceScope trace("sort", caller, chai::CPU, len);
          CHAIDataGetter<_kv<T>, RAJA::seq_exec> getter {};
          _kv<T> * rawData = getter.getRawArrayData(m_keyValues) + start;
          std::sort(rawData, rawData + len, cmpKeys<T>);
@@ -1031,8 +1209,8 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @param[in] len - The number of elements to unsort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey(const size_t len) const {
-         sortByKey(0, len);
+      void sortByKey(const size_t len, const care::SourceLocation & caller = CARE_CALLER) const {
+         sortByKey(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1040,8 +1218,8 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @brief Sorts all the elements by key
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void sortByKey() const {
-         sortByKey(m_len);
+      void sortByKey(const care::SourceLocation & caller = CARE_CALLER) const {
+         sortByKey(m_len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1053,7 +1231,9 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort(const size_t start, const size_t len) {
+      void stableSort(const size_t start, const size_t len,
+                      const care::SourceLocation & caller = CARE_CALLER) {
+         care::LoopTraceScope trace("sort", caller, chai::CPU, len);
          CHAIDataGetter<_kv<T>, RAJA::seq_exec> getter {};
          _kv<T> * rawData = getter.getRawArrayData(m_keyValues) + start;
          std::sort(rawData, rawData + len, cmpValsStable<T>);
@@ -1067,8 +1247,8 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @param[in] len - The number of elements to sort
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort(const size_t len) {
-         stableSort(0, len);
+      void stableSort(const size_t len, const care::SourceLocation & caller = CARE_CALLER) {
+         stableSort(0, len, caller);
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1077,8 +1257,25 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       /// @return void
       /// TODO: add bounds checking
       ///////////////////////////////////////////////////////////////////////////
-      void stableSort() {
-         stableSort(m_len);
+      void stableSort(const care::SourceLocation & caller = CARE_CALLER) {
+         stableSort(m_len, caller);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @author Jeff Keasler, Alan Dayton
+      /// @brief Eliminates duplicate values
+      /// Of each set of duplicate values, the one with the smallest key is
+      ///    kept, and the result is ordered by key.
+      /// @param[in] method - Which algorithm to use. See DuplicateElimination.
+      /// @return void
+      ///////////////////////////////////////////////////////////////////////////
+      void eliminateDuplicates(DuplicateElimination method = DuplicateElimination::AUTOMATIC) {
+         if (resolveDuplicateElimination<T>(method) == DuplicateElimination::HASH) {
+            eliminateDuplicatesByHashing();
+         }
+         else {
+            eliminateDuplicatesBySorting();
+         }
       }
 
       ///////////////////////////////////////////////////////////////////////////
@@ -1089,7 +1286,7 @@ class KeyValueSorter<T, RAJA::seq_exec> {
       ///    step is to unsort.
       /// @return void
       ///////////////////////////////////////////////////////////////////////////
-      void eliminateDuplicates() {
+      void eliminateDuplicatesBySorting() {
          if (m_len > 1) {
             CHAIDataGetter<_kv<T>, RAJA::seq_exec> getter {};
             _kv<T> * rawData = getter.getRawArrayData(m_keyValues);
@@ -1151,6 +1348,90 @@ class KeyValueSorter<T, RAJA::seq_exec> {
          }
       }
 
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Eliminates duplicate values
+      /// Inserts every value into an open addressing hash set, where each
+      ///    slot records the index of the element with the smallest key for
+      ///    its value. The first occurrences are then compacted in place in a
+      ///    single pass that preserves the current ordering. The final sort by
+      ///    key is skipped if the keys are already in ascending order.
+      /// @return void
+      ///////////////////////////////////////////////////////////////////////////
+      void eliminateDuplicatesByHashing() {
+         if (m_len > 1) {
+            CHAIDataGetter<_kv<T>, RAJA::seq_exec> getter {};
+            _kv<T> * rawData = getter.getRawArrayData(m_keyValues);
+
+            const int capacity = duplicateEliminationCapacity(m_len);
+            const unsigned int mask = (unsigned int) (capacity - 1);
+
+            std::vector<int> table(capacity, -1);
+            std::vector<unsigned int> slots(m_len);
+            bool keysAscending = true;
+
+            for (size_t i = 0; i < m_len; ++i) {
+               if (i > 0 && rawData[i-1].key > rawData[i].key) {
+                  keysAscending = false;
+               }
+
+               unsigned int slot = hashValue(rawData[i].value) & mask;
+
+               while (true) {
+                  const int owner = table[slot];
+
+                  if (owner == -1) {
+                     table[slot] = (int) i;
+                     break;
+                  }
+                  else if (rawData[owner].value == rawData[i].value) {
+                     if (rawData[i].key < rawData[owner].key) {
+                        table[slot] = (int) i;
+                     }
+
+                     break;
+                  }
+
+                  slot = (slot + 1) & mask;
+               }
+
+               slots[i] = slot;
+            }
+
+            // Keep the elements that own their slot
+            size_t lsize = 0;
+
+            for (size_t i = 0; i < m_len; ++i) {
+               if (table[slots[i]] == (int) i) {
+                  if (lsize != i) {
+                     rawData[lsize] = rawData[i];
+                  }
+
+                  ++lsize;
+               }
+            }
+
+            // Restore the original ordering
+            if (!keysAscending) {
+               std::sort(rawData, rawData + lsize, cmpKeys<T>);
+            }
+
+            // Reallocate memory
+            m_keyValues.realloc(lsize);
+            m_len = lsize;
+
+            // Refresh the separate copies of the keys and values
+            if (m_keys) {
+               m_keys.free();
+               initializeKeys();
+            }
+
+            if (m_values) {
+               m_values.free();
+               initializeValues();
+            }
+         }
+      }
+
       ///////////////////////////////////////////////////////////////////////////
       /// @author Alan Dayton
       /// @brief Initializes the keys
@@ -1284,86 +1565,43 @@ class KeyValueSorter<T, RAJA::seq_exec> {
 
 
 #ifdef RAJA_GPU_ACTIVE
+///////////////////////////////////////////////////////////////////////////
+/// @brief Intersects the values of two KeyValueSorters that have been sorted
+///    by value. Uses the merge path/galloping intersection of IntersectArrays,
+///    then translates the matching positions into keys.
+/// @param[in]  exec       - Used to choose this overload
+/// @param[in]  sorter1    - The first sorter, sorted by value
+/// @param[in]  size1      - The number of elements in sorter1
+/// @param[in]  sorter2    - The second sorter, sorted by value
+/// @param[in]  size2      - The number of elements in sorter2
+/// @param[out] matches1   - The keys in sorter1 of the matching values
+/// @param[out] matches2   - The keys in sorter2 of the matching values
+/// @param[out] numMatches - The number of matching values
+/// @return void
+///////////////////////////////////////////////////////////////////////////
 template <typename T>
 void IntersectKeyValueSorters(RAJAExec exec, KeyValueSorter<T> sorter1, int size1,
                               KeyValueSorter<T> sorter2, int size2,
                               host_device_ptr<int> &matches1, host_device_ptr<int>& matches2,
                               int & numMatches) {
- 
-   
-   int smaller = (size1 < size2) ? size1 : size2 ;
-   int start1 = 0;
-   int start2 = 0;
+   host_device_ptr<const T> values1 = sorter1.values();
+   host_device_ptr<const T> values2 = sorter2.values();
 
-   numMatches = 0 ;
-   if (smaller == 0) {
-      matches1 = nullptr ;
-      matches2 = nullptr ;
-      return ;
-   }
-   else {
-      matches1.alloc(smaller);
+   care_utils::IntersectArrays<T>(exec, values1, size1, 0, values2, size2, 0,
+                                  matches1, matches2, &numMatches);
+
+   if (numMatches > 0) {
       matches1.namePointer("matches1");
-      matches2.alloc(smaller);
       matches2.namePointer("matches2");
-   }
 
-   host_device_ptr<int> smallerMatches, largerMatches;
-   host_device_ptr<size_t> smallerKeys, largerKeys;
-   int larger, smallStart, largeStart;
-   host_device_ptr<const T> smallerArray, largerArray;
-   if (smaller == size1) {
-      smallerArray = sorter1.values();
-      largerArray = sorter2.values();
-      smallerKeys = sorter1.keys();
-      largerKeys = sorter2.keys();
-      larger = size2;
-      smallStart = start1;
-      largeStart = start2;
-      smallerMatches = matches1;
-      largerMatches = matches2;
-   }
-   else {
-      smallerArray = sorter2.values();
-      largerArray = sorter1.values();
-      smallerKeys = sorter2.keys();
-      largerKeys = sorter1.keys();
-      larger = size1;
-      smallStart = start2;
-      largeStart = start1;
-      smallerMatches = matches2;
-      largerMatches = matches1;
-   }
+      host_device_ptr<size_t const> keys1 = sorter1.keys();
+      host_device_ptr<size_t const> keys2 = sorter2.keys();
 
-   host_device_ptr<int> searches{smaller+1};
-   host_device_ptr<int> matched{smaller+1};
-   LOOP_STREAM(i, 0, smaller+1) {
-      searches[i] = i != smaller ? care_utils::BinarySearch<T>(largerArray, largeStart, larger, smallerArray[i+smallStart]) : -1;
-      matched[i] = i != smaller && searches[i] > -1;
-   } LOOP_STREAM_END
-
-   exclusive_scan<int, RAJAExec>(matched, nullptr, smaller+1, RAJA::operators::plus<int>{}, 0, true);
-
-   LOOP_STREAM(i, 0, smaller) {
-      if (searches[i] > -1) {
-         smallerMatches[matched[i]] = smallerKeys[i+smallStart];
-         largerMatches[matched[i]] = largerKeys[searches[i]];
-      }
-   } LOOP_STREAM_END
-   numMatches =  matched.pick(smaller);
-   searches.free();
-   matched.free();
-   
-   /* change the size of the array */
-   if (numMatches == 0) {
-      matches1.free();
-      matches2.free();
-   }
-   else {
-      matches1.realloc(numMatches);
-      matches2.realloc(numMatches);
+      LOOP_STREAM(i, 0, numMatches) {
+         matches1[i] = (int) keys1[matches1[i]];
+         matches2[i] = (int) keys2[matches2[i]];
+      } LOOP_STREAM_END
    }
-
 }
 #endif
 
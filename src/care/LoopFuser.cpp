@@ -14,6 +14,7 @@
 
 // Other CARE headers
 #include "care/care.h"
+#include "care/LoopTrace.h"
 #include "care/util.h"
 #include "care/LoopFuser.h"
 
@@ -422,6 +423,9 @@ void LoopFuser::flush_parallel_counts_to_offsets_scans() {
 }
 
 void LoopFuser::flush() {
+   care::LoopTraceScope trace("fused flush", __FILE__, __LINE__,
+                              care::ExecutionPolicyToSpace<RAJAExec>::value, m_action_count);
+
    if (m_action_count > 0) {
       if (m_is_scan) {
          flush_parallel_scans();
@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// CARE headers
+#include "care/LoopPolicyTable.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+// Std library headers
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace care {
+   /// What is known about one call site. Everything but the threshold is
+   /// guarded by the table's mutex. The threshold is also written under the
+   /// mutex, but may be read without it.
+   struct LoopPolicyRecord {
+      std::string fileName;
+      int lineNumber = 0;
+      double sequentialSecondsPerIndex = 0.0; //!< Running average
+      double parallelOverheadSeconds = 0.0; //!< Running average
+      int sequentialSamples = 0;
+      int parallelSamples = 0;
+      std::atomic<int> threshold; //!< -1 until calibrated
+      bool fixed = false; //!< Loaded or set, so not recalibrated
+
+      LoopPolicyRecord() : threshold(-1) {}
+
+      void reset() {
+         sequentialSecondsPerIndex = 0.0;
+         parallelOverheadSeconds = 0.0;
+         sequentialSamples = 0;
+         parallelSamples = 0;
+         threshold.store(-1, std::memory_order_release);
+         fixed = false;
+      }
+
+      void fix(const int fixedThreshold) {
+         threshold.store(fixedThreshold, std::memory_order_release);
+         fixed = true;
+      }
+   };
+
+   namespace {
+      /// Call sites are looked up by the address of the file name, which
+      /// comes from __FILE__, so the name is only compared when it is first seen
+      struct CallSite {
+         const char * fileName;
+         int lineNumber;
+
+         bool operator==(const CallSite & other) const {
+            return fileName == other.fileName && lineNumber == other.lineNumber;
+         }
+      };
+
+      struct CallSiteHash {
+         size_t operator()(const CallSite & site) const {
+            return std::hash<const void *>()(site.fileName) ^ (std::hash<int>()(site.lineNumber) << 1);
+         }
+      };
+
+      std::atomic<bool> s_enabled(true);
+      std::mutex s_mutex;
+      // Records are never erased, so LoopPolicySite can keep pointers to them
+      std::unordered_map<CallSite, std::unique_ptr<LoopPolicyRecord>, CallSiteHash> s_records;
+      std::map<std::pair<std::string, int>, int> s_loaded_thresholds;
+
+      int maxThreads() {
+#if defined(_OPENMP)
+         return omp_get_max_threads();
+#else
+         return 1;
+#endif
+      }
+
+      double runningAverage(const double average, const int samples, const double value) {
+         return samples == 0 ? value : 0.75 * average + 0.25 * value;
+      }
+
+      // Must be called with s_mutex held
+      LoopPolicyRecord & findRecord(const char * fileName, const int lineNumber) {
+         const CallSite site{fileName, lineNumber};
+         auto it = s_records.find(site);
+
+         if (it == s_records.end()) {
+            std::unique_ptr<LoopPolicyRecord> record(new LoopPolicyRecord());
+            record->fileName = fileName;
+            record->lineNumber = lineNumber;
+
+            auto loaded = s_loaded_thresholds.find(std::make_pair(record->fileName, lineNumber));
+
+            if (loaded != s_loaded_thresholds.end()) {
+               record->fix(loaded->second);
+            }
+
+            it = s_records.emplace(site, std::move(record)).first;
+         }
+
+         return *it->second;
+      }
+
+      // The length at which a sequential run and a parallel run take the same
+      // time, assuming the parallel run divides the sequential work evenly.
+      // Must be called with s_mutex held.
+      void calibrate(LoopPolicyRecord & record) {
+         if (record.threshold.load(std::memory_order_relaxed) >= 0 ||
+             record.sequentialSamples < LoopPolicyTable::calibrationSamples ||
+             record.parallelSamples < LoopPolicyTable::calibrationSamples) {
+            return;
+         }
+
+         const int numThreads = maxThreads();
+         const double savedPerIndex = record.sequentialSecondsPerIndex * (1.0 - 1.0 / numThreads);
+         int threshold = LoopPolicyTable::maxCalibrationLength;
+
+         if (savedPerIndex > 0.0) {
+            const double breakEven = record.parallelOverheadSeconds / savedPerIndex;
+
+            if (breakEven < 1.0) {
+               threshold = 1;
+            }
+            else if (breakEven < LoopPolicyTable::maxCalibrationLength) {
+               threshold = (int) breakEven;
+            }
+         }
+
+         record.threshold.store(threshold, std::memory_order_release);
+      }
+   } // namespace
+
+   constexpr int LoopPolicyTable::calibrationSamples;
+   constexpr int LoopPolicyTable::maxCalibrationLength;
+
+   bool LoopPolicyTable::runInParallel(const char * fileName, int lineNumber, int length) {
+      return LoopPolicySite(fileName, lineNumber).runInParallel(length);
+   }
+
+   void LoopPolicyTable::record(const char * fileName, int lineNumber, int length,
+                                bool parallel, double seconds) {
+      LoopPolicySite(fileName, lineNumber).record(length, parallel, seconds);
+   }
+
+   void LoopPolicyTable::setEnabled(bool enabled) {
+      s_enabled.store(enabled);
+   }
+
+   bool LoopPolicyTable::isEnabled() {
+      return s_enabled.load();
+   }
+
+   int LoopPolicyTable::getThreshold(const char * fileName, int lineNumber) {
+      return LoopPolicySite(fileName, lineNumber).getThreshold();
+   }
+
+   void LoopPolicyTable::setThreshold(const char * fileName, int lineNumber, int threshold) {
+      std::lock_guard<std::mutex> guard(s_mutex);
+      findRecord(fileName, lineNumber).fix(threshold);
+   }
+
+   void LoopPolicyTable::dump(FILE * file) {
+      std::lock_guard<std::mutex> guard(s_mutex);
+
+      fprintf(file, "[CARE] Loop policy table (%zu call sites)\n", s_records.size());
+      fprintf(file, "[CARE] %10s %14s %14s %8s %8s  %s\n",
+              "threshold", "seq ns/index", "par start us", "seq runs", "par runs", "call site");
+
+      for (const auto & entry : s_records) {
+         const LoopPolicyRecord & record = *entry.second;
+
+         fprintf(file, "[CARE] %10d %14.3f %14.3f %8d %8d  %s:%d%s\n",
+                 record.threshold.load(),
+                 record.sequentialSecondsPerIndex * 1.0e9,
+                 record.parallelOverheadSeconds * 1.0e6,
+                 record.sequentialSamples,
+                 record.parallelSamples,
+                 record.fileName.c_str(),
+                 record.lineNumber,
+                 record.fixed ? " (fixed)" : "");
+      }
+
+      fflush(file);
+   }
+
+   bool LoopPolicyTable::save(const std::string & path) {
+      FILE * file = fopen(path.c_str(), "w");
+
+      if (!file) {
+         return false;
+      }
+
+      std::lock_guard<std::mutex> guard(s_mutex);
+
+      for (const auto & entry : s_records) {
+         const LoopPolicyRecord & record = *entry.second;
+         const int threshold = record.threshold.load();
+
+         if (threshold >= 0) {
+            fprintf(file, "%d %d %s\n", threshold, record.lineNumber, record.fileName.c_str());
+         }
+      }
+
+      return fclose(file) == 0;
+   }
+
+   bool LoopPolicyTable::load(const std::string & path) {
+      FILE * file = fopen(path.c_str(), "r");
+
+      if (!file) {
+         return false;
+      }
+
+      // Read the whole file first, so a malformed file loads nothing
+      std::map<std::pair<std::string, int>, int> thresholds;
+      char line[4200];
+      int fileLine = 0;
+
+      while (fgets(line, sizeof(line), file)) {
+         ++fileLine;
+
+         if (line[0] == '\n') {
+            continue;
+         }
+
+         int threshold = 0;
+         int lineNumber = 0;
+         char fileName[4096];
+         const size_t length = strlen(line);
+         const bool complete = (length > 0 && line[length - 1] == '\n') || feof(file);
+
+         // The file name is the rest of the line, so it may contain spaces
+         if (!complete ||
+             sscanf(line, "%d %d %4095[^\n]", &threshold, &lineNumber, fileName) != 3) {
+            printf("[CARE] Warning: LoopPolicyTable::load: %s:%d is not \"threshold lineNumber fileName\"; nothing was loaded\n",
+                   path.c_str(), fileLine);
+            fclose(file);
+            return false;
+         }
+
+         thresholds[std::make_pair(std::string(fileName), lineNumber)] = threshold;
+      }
+
+      fclose(file);
+
+      std::lock_guard<std::mutex> guard(s_mutex);
+
+      for (const auto & entry : thresholds) {
+         s_loaded_thresholds[entry.first] = entry.second;
+      }
+
+      // Apply the thresholds to the call sites that have already been seen
+      for (auto & entry : s_records) {
+         LoopPolicyRecord & record = *entry.second;
+         auto loaded = s_loaded_thresholds.find(std::make_pair(record.fileName, record.lineNumber));
+
+         if (loaded != s_loaded_thresholds.end()) {
+            record.fix(loaded->second);
+         }
+      }
+
+      return true;
+   }
+
+   void LoopPolicyTable::clear() {
+      std::lock_guard<std::mutex> guard(s_mutex);
+
+      // Sites may be held by LoopPolicySite, so they are reset rather than erased
+      for (auto & entry : s_records) {
+         entry.second->reset();
+      }
+
+      s_loaded_thresholds.clear();
+   }
+
+   LoopPolicySite::LoopPolicySite(const char * fileName, int lineNumber) :
+      m_file_name(fileName),
+      m_line_number(lineNumber)
+   {
+      std::lock_guard<std::mutex> guard(s_mutex);
+      m_record = &findRecord(fileName, lineNumber);
+      m_threshold = &m_record->threshold;
+   }
+
+   bool LoopPolicySite::runInParallel(int length) const {
+      if (!s_enabled.load(std::memory_order_relaxed)) {
+         return true;
+      }
+
+      if (length < 2 || maxThreads() < 2) {
+         return false;
+      }
+
+      const int threshold = getThreshold();
+
+      if (threshold >= 0) {
+         return length >= threshold;
+      }
+      else if (length > LoopPolicyTable::maxCalibrationLength) {
+         return true;
+      }
+      else {
+         // Calibrate with sequential runs first, so the parallel runs can be
+         // compared against them
+         std::lock_guard<std::mutex> guard(s_mutex);
+         return m_record->parallelSamples < m_record->sequentialSamples;
+      }
+   }
+
+   void LoopPolicySite::record(int length, bool parallel, double seconds) const {
+      if (!s_enabled.load(std::memory_order_relaxed) || length < 2) {
+         return;
+      }
+
+      std::lock_guard<std::mutex> guard(s_mutex);
+      LoopPolicyRecord & record = *m_record;
+
+      if (record.fixed) {
+         return;
+      }
+
+      if (parallel) {
+         // The overhead can only be estimated against a sequential run
+         if (record.sequentialSamples > 0) {
+            const double work = length * record.sequentialSecondsPerIndex / maxThreads();
+            const double overhead = seconds > work ? seconds - work : 0.0;
+            record.parallelOverheadSeconds = runningAverage(record.parallelOverheadSeconds,
+                                                            record.parallelSamples,
+                                                            overhead);
+            ++record.parallelSamples;
+         }
+      }
+      else {
+         record.sequentialSecondsPerIndex = runningAverage(record.sequentialSecondsPerIndex,
+                                                           record.sequentialSamples,
+                                                           seconds / length);
+         ++record.sequentialSamples;
+      }
+
+      calibrate(record);
+   }
+} // namespace care
+
@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_LOOP_POLICY_TABLE_H_
+#define _CARE_LOOP_POLICY_TABLE_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Std library headers
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+namespace care {
+   struct LoopPolicyRecord;
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// Decides, for each parallel loop call site, whether a launch
+   /// of a given length runs on the OpenMP threads or inline on
+   /// the calling thread. Starting a parallel region costs far
+   /// more than a short loop, so each call site has a threshold
+   /// below which it runs sequentially.
+   ///
+   /// Thresholds are calibrated from the loops themselves. The
+   /// first launches of a call site alternate between sequential
+   /// and parallel runs and are timed, giving the sequential cost
+   /// per index and the parallel startup cost. The threshold is
+   /// the length at which the two break even. Launches too long
+   /// to calibrate on always run in parallel. Once a call site
+   /// has a threshold, its launches are no longer timed and are
+   /// decided through a LoopPolicySite without locking.
+   ///
+   /// The table can be dumped, and saved to and loaded from a
+   /// file so a later run starts with the thresholds of this one.
+   /// Loaded and set thresholds are fixed and not recalibrated.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class LoopPolicyTable {
+      public:
+         /// The number of timed launches of each kind before a call
+         /// site is calibrated
+         static constexpr int calibrationSamples = 3;
+
+         /// The longest launch that may be run sequentially to
+         /// calibrate, and the largest threshold
+         static constexpr int maxCalibrationLength = 1 << 16;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether a launch of the given length at the given
+         ///        call site should run in parallel
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static bool runInParallel(const char * fileName,
+                                                int lineNumber,
+                                                int length);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Records the time taken by a launch chosen by runInParallel
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void record(const char * fileName,
+                                         int lineNumber,
+                                         int length,
+                                         bool parallel,
+                                         double seconds);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Turns the table on or off. While it is off, every launch runs
+         ///        in parallel.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void setEnabled(bool enabled);
+
+         CARE_DLL_API static bool isEnabled();
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the threshold of a call site, or -1 if it has not been
+         ///        calibrated
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static int getThreshold(const char * fileName, int lineNumber);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Fixes the threshold of a call site. Launches shorter than the
+         ///        threshold run sequentially.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void setThreshold(const char * fileName, int lineNumber,
+                                               int threshold);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Writes the call sites, their thresholds and measurements
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void dump(FILE * file = stdout);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Saves the thresholds of the calibrated and fixed call sites,
+         ///        one per line as "threshold lineNumber fileName"
+         /// @return whether the file could be written
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static bool save(const std::string & path);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Loads thresholds written by save, fixing those call sites.
+         ///        If a line is malformed, a warning naming it is printed and
+         ///        nothing is loaded.
+         /// @return whether the file could be read and every line was valid
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static bool load(const std::string & path);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Forgets every call site and loaded threshold
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void clear();
+   }; // class LoopPolicyTable
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// A handle to the LoopPolicyTable entry of one call site,
+   /// looked up once and kept by the caller. Entries live as long
+   /// as the program, so a handle stays valid across clear.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class LoopPolicySite {
+      public:
+         CARE_DLL_API LoopPolicySite(const char * fileName, int lineNumber);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether this is the handle of the given call site
+         ///////////////////////////////////////////////////////////////////////////
+         bool isAt(const char * fileName, int lineNumber) const {
+            return m_file_name == fileName && m_line_number == lineNumber;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the threshold of the call site, or -1 if it is still
+         ///        being calibrated. Does not lock.
+         ///////////////////////////////////////////////////////////////////////////
+         int getThreshold() const {
+            return m_threshold->load(std::memory_order_acquire);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Same as LoopPolicyTable::runInParallel. Only locks while the
+         ///        call site is being calibrated.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API bool runInParallel(int length) const;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Same as LoopPolicyTable::record
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API void record(int length, bool parallel, double seconds) const;
+
+      private:
+         const char * m_file_name;
+         int m_line_number;
+         LoopPolicyRecord * m_record;
+         const std::atomic<int> * m_threshold;
+   }; // class LoopPolicySite
+} // namespace care
+
+#endif // !defined(_CARE_LOOP_POLICY_TABLE_H_)
+
@@ -0,0 +1,310 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// CARE headers
+#include "care/LoopTrace.h"
+
+// Std library headers
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace care {
+   namespace {
+      struct LoopTraceEvent {
+         const char * category;
+         const char * fileName;
+         long long length;
+         long long startNanoseconds;
+         long long endNanoseconds;
+         int lineNumber;
+         chai::ExecutionSpace space;
+      };
+
+      /// A single producer, single consumer ring buffer. The owning thread
+      /// advances the head and the writer thread advances the tail. The
+      /// owning thread sets writing while it records, so that stop can wait
+      /// for events that saw the trace enabled.
+      struct LoopTraceBuffer {
+         std::unique_ptr<LoopTraceEvent[]> events;
+         unsigned long long capacity = 0;
+         std::atomic<unsigned long long> head;
+         std::atomic<unsigned long long> tail;
+         std::atomic<bool> writing;
+         int threadId = 0;
+         unsigned int generation = 0;
+
+         LoopTraceBuffer(const unsigned long long eventCapacity, const int id,
+                         const unsigned int traceGeneration) :
+            events(new LoopTraceEvent[eventCapacity]),
+            capacity(eventCapacity),
+            head(0),
+            tail(0),
+            writing(false),
+            threadId(id),
+            generation(traceGeneration)
+         {
+         }
+      };
+
+      std::atomic<bool> s_enabled(false);
+      std::atomic<unsigned int> s_generation(0);
+      std::atomic<long long> s_dropped(0);
+
+      // Guards everything below
+      std::mutex s_mutex;
+      std::condition_variable s_writer_wakeup;
+      std::vector<std::unique_ptr<LoopTraceBuffer> > s_buffers;
+      // Buffers of earlier traces, kept without their events since their
+      // threads may still hold them
+      std::vector<std::unique_ptr<LoopTraceBuffer> > s_retired_buffers;
+      std::thread s_writer;
+      bool s_stop_writer = false;
+      FILE * s_file = nullptr;
+      bool s_first_event = true;
+      bool s_stop_at_exit = false;
+      std::size_t s_events_per_thread = LoopTrace::defaultEventsPerThread;
+      LoopTrace::Clock::time_point s_epoch;
+
+      thread_local LoopTraceBuffer * t_buffer = nullptr;
+      thread_local unsigned int t_generation = 0;
+
+      // Must be called with s_mutex held
+      LoopTraceBuffer * addBuffer(const unsigned int generation) {
+         s_buffers.emplace_back(new LoopTraceBuffer(s_events_per_thread, (int) s_buffers.size(), generation));
+         return s_buffers.back().get();
+      }
+
+      // Buffers from an earlier trace are replaced on first use
+      LoopTraceBuffer * threadBuffer() {
+         const unsigned int generation = s_generation.load(std::memory_order_acquire);
+
+         if (t_buffer == nullptr || t_generation != generation) {
+            std::lock_guard<std::mutex> guard(s_mutex);
+            t_buffer = addBuffer(generation);
+            t_generation = generation;
+         }
+
+         return t_buffer;
+      }
+
+      void writeEscaped(const char * text) {
+         for (const char * c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+               fputc('\\', s_file);
+               fputc(*c, s_file);
+            }
+            else if ((unsigned char) *c < 0x20) {
+               fprintf(s_file, "\\u%04x", (unsigned int) (unsigned char) *c);
+            }
+            else {
+               fputc(*c, s_file);
+            }
+         }
+      }
+
+      const char * spaceName(const chai::ExecutionSpace space) {
+         switch (space) {
+            case chai::CPU:
+               return "CPU";
+            case chai::GPU:
+               return "GPU";
+            default:
+               return "NONE";
+         }
+      }
+
+      // Must be called with s_mutex held
+      void writeEvent(const LoopTraceEvent & event, const int threadId) {
+         fputs(s_first_event ? "\n" : ",\n", s_file);
+         s_first_event = false;
+
+         fputs("{\"name\":\"", s_file);
+         writeEscaped(event.fileName);
+         fprintf(s_file, ":%d\",\"cat\":\"", event.lineNumber);
+         writeEscaped(event.category);
+         fprintf(s_file, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,"
+                         "\"args\":{\"space\":\"%s\",\"length\":%lld}}",
+                 event.startNanoseconds * 1.0e-3,
+                 (event.endNanoseconds - event.startNanoseconds) * 1.0e-3,
+                 threadId,
+                 spaceName(event.space),
+                 event.length);
+      }
+
+      // Must be called with s_mutex held
+      void drainBuffers() {
+         for (const auto & buffer : s_buffers) {
+            const unsigned long long head = buffer->head.load(std::memory_order_acquire);
+            unsigned long long tail = buffer->tail.load(std::memory_order_relaxed);
+
+            for (; tail < head; ++tail) {
+               writeEvent(buffer->events[tail % buffer->capacity], buffer->threadId);
+            }
+
+            buffer->tail.store(tail, std::memory_order_release);
+         }
+      }
+
+      void writerLoop() {
+         std::unique_lock<std::mutex> lock(s_mutex);
+
+         while (!s_stop_writer) {
+            s_writer_wakeup.wait_for(lock, std::chrono::milliseconds(10));
+            drainBuffers();
+         }
+      }
+
+      void stopAtExit() {
+         LoopTrace::stop();
+      }
+   } // namespace
+
+   constexpr std::size_t LoopTrace::defaultEventsPerThread;
+
+   bool LoopTrace::start(const std::string & path, std::size_t eventsPerThread) {
+      stop();
+
+      std::lock_guard<std::mutex> guard(s_mutex);
+      s_file = fopen(path.c_str(), "w");
+
+      if (!s_file) {
+         return false;
+      }
+
+      fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", s_file);
+
+      s_first_event = true;
+      s_events_per_thread = eventsPerThread > 0 ? eventsPerThread : 1;
+      s_epoch = Clock::now();
+      s_dropped.store(0);
+
+      for (auto & buffer : s_buffers) {
+         buffer->events.reset();
+         s_retired_buffers.push_back(std::move(buffer));
+      }
+
+      s_buffers.clear();
+      s_stop_writer = false;
+      s_writer = std::thread(writerLoop);
+
+      // Preallocate the buffer of the thread that starts the trace
+      t_generation = s_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+      t_buffer = addBuffer(t_generation);
+
+      if (!s_stop_at_exit) {
+         s_stop_at_exit = true;
+         std::atexit(stopAtExit);
+      }
+
+      s_enabled.store(true, std::memory_order_release);
+      return true;
+   }
+
+   void LoopTrace::stop() {
+      if (!s_enabled.exchange(false)) {
+         return;
+      }
+
+      {
+         std::lock_guard<std::mutex> guard(s_mutex);
+         s_stop_writer = true;
+      }
+
+      s_writer_wakeup.notify_one();
+      s_writer.join();
+
+      std::lock_guard<std::mutex> guard(s_mutex);
+
+      // Events that saw the trace enabled finish before the last drain, and
+      // later ones are dropped (see record)
+      for (const auto & buffer : s_buffers) {
+         while (buffer->writing.load()) {
+            std::this_thread::yield();
+         }
+      }
+
+      drainBuffers();
+
+      for (const auto & buffer : s_buffers) {
+         fprintf(s_file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                         "\"args\":{\"name\":\"CARE thread %d\"}}",
+                 buffer->threadId, buffer->threadId);
+      }
+
+      fprintf(s_file, "\n],\"otherData\":{\"droppedEvents\":%lld}}\n", s_dropped.load());
+      fclose(s_file);
+      s_file = nullptr;
+   }
+
+   bool LoopTrace::isEnabled() {
+      return s_enabled.load(std::memory_order_acquire);
+   }
+
+   void LoopTrace::record(const char * category,
+                          const char * fileName,
+                          int lineNumber,
+                          chai::ExecutionSpace space,
+                          long long length,
+                          Clock::time_point startTime,
+                          Clock::time_point endTime) {
+      // The event started while the trace was enabled, but ends after it
+      if (!s_enabled.load(std::memory_order_acquire)) {
+         s_dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      LoopTraceBuffer * buffer = threadBuffer();
+
+      // Paired with stop, which clears s_enabled and then waits for writing
+      // to clear, so either this sees the trace stopped or stop drains this
+      // event. A buffer of an earlier trace is never written to again.
+      buffer->writing.store(true);
+
+      if (!s_enabled.load() || buffer->generation != s_generation.load()) {
+         buffer->writing.store(false, std::memory_order_release);
+         s_dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      const unsigned long long head = buffer->head.load(std::memory_order_relaxed);
+      const unsigned long long used = head - buffer->tail.load(std::memory_order_acquire);
+
+      if (used >= buffer->capacity) {
+         buffer->writing.store(false, std::memory_order_release);
+         s_dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      LoopTraceEvent & event = buffer->events[head % buffer->capacity];
+      event.category = category;
+      event.fileName = fileName;
+      event.length = length;
+      event.startNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(startTime - s_epoch).count();
+      event.endNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - s_epoch).count();
+      event.lineNumber = lineNumber;
+      event.space = space;
+
+      buffer->head.store(head + 1, std::memory_order_release);
+      buffer->writing.store(false, std::memory_order_release);
+
+      // Wake the writer early once the buffer is half full
+      if (used + 1 == buffer->capacity / 2) {
+         s_writer_wakeup.notify_one();
+      }
+   }
+
+   long long LoopTrace::droppedEvents() {
+      return s_dropped.load();
+   }
+} // namespace care
+
@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_LOOP_TRACE_H_
+#define _CARE_LOOP_TRACE_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other library headers
+#include "chai/ExecutionSpaces.hpp"
+
+// Std library headers
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// The file and line a function is called from, when given as the default
+// argument of a parameter. Compilers without the builtins give the file and
+// line of care::SourceLocation instead.
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define CARE_HAVE_BUILTIN_SOURCE_LOCATION 1
+#else
+#define CARE_HAVE_BUILTIN_SOURCE_LOCATION 0
+#endif
+
+#define CARE_CALLER care::SourceLocation::current()
+
+namespace care {
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// A file and line. Library functions that are traced take
+   /// their caller's as a last parameter defaulting to CARE_CALLER,
+   /// so their events are named after the call rather than the
+   /// library header, as loops are. The builtins are default
+   /// arguments of current itself, since that is the only place
+   /// they are evaluated at the call.
+   ///
+   ////////////////////////////////////////////////////////////////
+   struct SourceLocation {
+#if CARE_HAVE_BUILTIN_SOURCE_LOCATION
+      static SourceLocation current(const char * fileName = __builtin_FILE(),
+                                    int lineNumber = __builtin_LINE()) {
+#else
+      static SourceLocation current(const char * fileName = __FILE__,
+                                    int lineNumber = __LINE__) {
+#endif
+         return SourceLocation{fileName, lineNumber};
+      }
+
+      const char * fileName;
+      int lineNumber;
+   };
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// Records a timeline of the loops, fused loop flushes, sorts
+   /// and scans that CARE runs, and writes it as a Chrome trace
+   /// (JSON) that chrome://tracing and Perfetto can open. Each
+   /// event is named by the file and line it was called from and
+   /// carries the execution space and length as arguments.
+   ///
+   /// Events are recorded into a preallocated ring buffer owned by
+   /// the calling thread, without locking or allocating. A
+   /// background thread drains the buffers to the file, so writing
+   /// is kept off the hot path. If a buffer fills faster than it is
+   /// drained, new events are dropped and counted rather than
+   /// stalling the loop.
+   ///
+   /// Device events cover the kernel launch unless loops are
+   /// synchronized afterwards (see RAJAPlugin::setSynchronization).
+   /// start and stop may be called while other threads are running
+   /// loops. Events that end after stop are dropped and counted.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class LoopTrace {
+      public:
+         using Clock = std::chrono::steady_clock;
+
+         /// The default number of events each thread can hold before
+         /// they are written
+         static constexpr std::size_t defaultEventsPerThread = 1 << 16;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Starts tracing to the given file, which is completed by stop or
+         ///        when the program exits
+         /// @param[in] path The file to write
+         /// @param[in] eventsPerThread The capacity of each thread's buffer
+         /// @return whether the file could be opened
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static bool start(const std::string & path,
+                                        std::size_t eventsPerThread = defaultEventsPerThread);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Writes the remaining events and closes the trace
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void stop();
+
+         CARE_DLL_API static bool isEnabled();
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Records an event on the calling thread's buffer
+         /// @param[in] category The kind of event, such as "forall". Must outlive
+         ///                     the trace, as a string literal does.
+         /// @param[in] fileName The file the event was called from. Must outlive
+         ///                     the trace, as __FILE__ does.
+         /// @param[in] lineNumber The line the event was called from
+         /// @param[in] space The execution space
+         /// @param[in] length The number of iterations or elements
+         /// @param[in] startTime When the event started
+         /// @param[in] endTime When the event ended
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void record(const char * category,
+                                         const char * fileName,
+                                         int lineNumber,
+                                         chai::ExecutionSpace space,
+                                         long long length,
+                                         Clock::time_point startTime,
+                                         Clock::time_point endTime);
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the number of events dropped by the current or last
+         ///        trace because a buffer was full or the trace had stopped
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static long long droppedEvents();
+   }; // class LoopTrace
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// Records the lifetime of this object as a LoopTrace event if
+   /// tracing is enabled when it is constructed.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class LoopTraceScope {
+      public:
+         LoopTraceScope(const char * category, const char * fileName, int lineNumber,
+                        chai::ExecutionSpace space, long long length) :
+            m_category(category),
+            m_file_name(fileName),
+            m_line_number(lineNumber),
+            m_space(space),
+            m_length(length),
+            m_enabled(LoopTrace::isEnabled()),
+            m_start_time(m_enabled ? LoopTrace::Clock::now() : LoopTrace::Clock::time_point())
+         {
+         }
+
+         LoopTraceScope(const char * category, const SourceLocation & caller,
+                        chai::ExecutionSpace space, long long length) :
+            LoopTraceScope(category, caller.fileName, caller.lineNumber, space, length)
+         {
+         }
+
+         ~LoopTraceScope() {
+            if (m_enabled) {
+               LoopTrace::record(m_category, m_file_name, m_line_number, m_space, m_length,
+                                 m_start_time, LoopTrace::Clock::now());
+            }
+         }
+
+         LoopTraceScope(const LoopTraceScope &) = delete;
+         LoopTraceScope & operator=(const LoopTraceScope &) = delete;
+
+      private:
+         const char * m_category;
+         const char * m_file_name;
+         int m_line_number;
+         chai::ExecutionSpace m_space;
+         long long m_length;
+         bool m_enabled;
+         LoopTrace::Clock::time_point m_start_time;
+   }; // class LoopTraceScope
+} // namespace care
+
+#endif // !defined(_CARE_LOOP_TRACE_H_)
+
@@ -7,6 +7,7 @@
 
 // CARE headers
 #include "care/CHAICallback.h"
+#include "care/LoopTrace.h"
 #include "care/RAJAPlugin.h"
 #include "care/Setup.h"
 #include "care/util.h"
@@ -24,14 +25,90 @@
 #include <execinfo.h>
 #endif // defined(CARE_DEBUG) && !defined(_WIN32)
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace care {
+   namespace {
+      /// Loops are profiled by the address of the file name, which comes from
+      /// __FILE__, so no strings are built or compared while profiling
+      struct LoopProfileSite {
+         const char * fileName;
+         int lineNumber;
+
+         bool operator==(const LoopProfileSite & other) const {
+            return fileName == other.fileName && lineNumber == other.lineNumber;
+         }
+      };
+
+      struct LoopProfileSiteHash {
+         size_t operator()(const LoopProfileSite & site) const {
+            return std::hash<const void *>()(site.fileName) ^ (std::hash<int>()(site.lineNumber) << 1);
+         }
+      };
+
+      struct LoopProfileData {
+         long long calls = 0;
+         long long iterations = 0;
+         double totalSeconds = 0.0;
+         double minSeconds = 0.0;
+         double maxSeconds = 0.0;
+         chai::ExecutionSpace space = chai::CPU;
+
+         void add(const LoopProfileData & other) {
+            minSeconds = calls == 0 ? other.minSeconds : std::min(minSeconds, other.minSeconds);
+            maxSeconds = calls == 0 ? other.maxSeconds : std::max(maxSeconds, other.maxSeconds);
+            calls += other.calls;
+            iterations += other.iterations;
+            totalSeconds += other.totalSeconds;
+            space = other.space;
+         }
+      };
+
+      /// The profile of the loops launched on one thread. Its mutex is only
+      /// contended while the profile is written or cleared.
+      struct LoopProfileTable {
+         std::mutex mutex;
+         std::unordered_map<LoopProfileSite, LoopProfileData, LoopProfileSiteHash> sites;
+      };
+
+      // The table of every thread that has profiled a loop. The tables are
+      // kept after their threads exit, so their loops stay in the profile.
+      std::mutex s_loop_profile_tables_mutex;
+      std::vector<std::unique_ptr<LoopProfileTable> > s_loop_profile_tables;
+
+      LoopProfileTable & threadLoopProfileTable() {
+         static thread_local LoopProfileTable * table = nullptr;
+
+         if (table == nullptr) {
+            std::unique_ptr<LoopProfileTable> newTable(new LoopProfileTable());
+            table = newTable.get();
+
+            std::lock_guard<std::mutex> guard(s_loop_profile_tables_mutex);
+            s_loop_profile_tables.push_back(std::move(newTable));
+         }
+
+         return *table;
+      }
+
+      void writeLoopProfileAtExit() {
+         RAJAPlugin::writeLoopProfile(stdout);
+      }
+   } // namespace
+
    bool RAJAPlugin::s_update_chai_execution_space = true;
    bool RAJAPlugin::s_debug_chai_data = true;
    bool RAJAPlugin::s_profile_host_loops = true;
    bool RAJAPlugin::s_synchronize_before = false;
    bool RAJAPlugin::s_synchronize_after = false;
+   bool RAJAPlugin::s_profile_loops = false;
+   bool RAJAPlugin::s_report_loop_profile_at_exit = false;
 
    uint32_t RAJAPlugin::s_colors[7] = { 0x0000ff00, 0x000000ff, 0x00ffff00, 0x00ff00ff, 0x0000ffff, 0x00ff0000, 0x00ffffff };
    int RAJAPlugin::s_num_colors = sizeof(s_colors) / sizeof(uint32_t);
@@ -42,15 +119,19 @@ namespace care {
 
    std::vector<const chai::PointerRecord*> RAJAPlugin::s_active_pointers_in_loop = std::vector<const chai::PointerRecord*>{};
 
+   thread_local std::vector<RAJAPlugin::ProfiledLoop> RAJAPlugin::s_profiled_loops;
+
    /////////////////////////////////////////////////////////////////////////////////
    ///
    /// @brief Set up to be done before executing a RAJA loop.
    ///
    /// @arg[in] space The execution space
-   /// @arg[in] name The name of the loop
+   /// @arg[in] fileName The file where the loop macro was called
+   /// @arg[in] lineNumber The line number where the loop macro was called
+   /// @arg[in] length The number of iterations of the loop, for the profiler
    ///
    /////////////////////////////////////////////////////////////////////////////////
-   void RAJAPlugin::pre_forall_hook(chai::ExecutionSpace space, const char* fileName, int lineNumber) {
+   void RAJAPlugin::pre_forall_hook(chai::ExecutionSpace space, const char* fileName, int lineNumber, int length) {
 #if !defined(CHAI_DISABLE_RM)
       // Update the CHAI execution space
       if (s_update_chai_execution_space) {
@@ -100,6 +181,18 @@ namespace care {
       }
 #endif // CARE_HAVE_NVTOOLSEXT
 #endif // defined(__GPUCC__)
+
+      // Start the clock last, so the set up above is not timed
+      ProfiledLoop loop;
+      loop.length = length > 0 ? length : 0;
+      loop.profiled = s_profile_loops;
+      loop.traced = LoopTrace::isEnabled();
+
+      if (loop.profiled || loop.traced) {
+         loop.startTime = std::chrono::steady_clock::now();
+      }
+
+      s_profiled_loops.push_back(loop);
    }
 
    /////////////////////////////////////////////////////////////////////////////////
@@ -184,6 +277,43 @@ namespace care {
    }
 
    void RAJAPlugin::post_forall_hook(chai::ExecutionSpace space, const char* fileName, int lineNumber) {
+      // Stop the clock first
+      if (!s_profiled_loops.empty()) {
+         const ProfiledLoop loop = s_profiled_loops.back();
+         s_profiled_loops.pop_back();
+
+         if (loop.profiled || loop.traced) {
+#if defined(__GPUCC__)
+            // Profile the kernel rather than its launch
+            if (loop.profiled && space == chai::GPU) {
+               care::gpuAssert(gpuDeviceSynchronize(), fileName, lineNumber, true);
+            }
+#endif // defined(__GPUCC__)
+
+            const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+            if (loop.profiled) {
+               const std::chrono::duration<double> elapsed = endTime - loop.startTime;
+               const double seconds = elapsed.count();
+
+               LoopProfileTable & table = threadLoopProfileTable();
+               std::lock_guard<std::mutex> guard(table.mutex);
+               LoopProfileData & data = table.sites[LoopProfileSite{fileName, lineNumber}];
+               data.minSeconds = data.calls == 0 ? seconds : std::min(data.minSeconds, seconds);
+               data.maxSeconds = data.calls == 0 ? seconds : std::max(data.maxSeconds, seconds);
+               data.totalSeconds += seconds;
+               data.iterations += loop.length;
+               data.space = space;
+               ++data.calls;
+            }
+
+            // Recorded even if tracing has stopped since, so it is counted as dropped
+            if (loop.traced) {
+               LoopTrace::record("forall", fileName, lineNumber, space, loop.length, loop.startTime, endTime);
+            }
+         }
+      }
+
 #if defined(__GPUCC__)
 #if CARE_HAVE_NVTOOLSEXT
       if (s_profile_host_loops) {
@@ -245,5 +375,85 @@ namespace care {
       s_synchronize_before = synchronizeBefore;
       s_synchronize_after = synchronizeAfter;
    }
+
+   void RAJAPlugin::enableLoopProfiling(bool reportAtExit) {
+      s_profile_loops = true;
+
+      if (reportAtExit && !s_report_loop_profile_at_exit) {
+         s_report_loop_profile_at_exit = true;
+         std::atexit(writeLoopProfileAtExit);
+      }
+   }
+
+   void RAJAPlugin::disableLoopProfiling() {
+      s_profile_loops = false;
+   }
+
+   bool RAJAPlugin::loopProfilingIsEnabled() {
+      return s_profile_loops;
+   }
+
+   void RAJAPlugin::writeLoopProfile(FILE * file) {
+      // The same call site may have been seen through more than one copy of
+      // its file name, so merge by name before sorting
+      std::map<std::pair<std::string, int>, LoopProfileData> merged;
+
+      {
+         std::lock_guard<std::mutex> tablesGuard(s_loop_profile_tables_mutex);
+
+         for (const std::unique_ptr<LoopProfileTable> & table : s_loop_profile_tables) {
+            std::lock_guard<std::mutex> guard(table->mutex);
+
+            for (const auto & entry : table->sites) {
+               merged[std::make_pair(std::string(entry.first.fileName), entry.first.lineNumber)].add(entry.second);
+            }
+         }
+      }
+
+      std::vector<std::pair<std::pair<std::string, int>, LoopProfileData> > sites(merged.begin(), merged.end());
+
+      std::stable_sort(sites.begin(), sites.end(),
+                       [] (const std::pair<std::pair<std::string, int>, LoopProfileData> & a,
+                           const std::pair<std::pair<std::string, int>, LoopProfileData> & b) {
+                          return a.second.totalSeconds > b.second.totalSeconds;
+                       });
+
+      double totalSeconds = 0.0;
+
+      for (const auto & site : sites) {
+         totalSeconds += site.second.totalSeconds;
+      }
+
+      fprintf(file, "[CARE] Loop profile (%zu call sites, %.6f s)\n", sites.size(), totalSeconds);
+      fprintf(file, "[CARE] %12s %6s %10s %12s %12s %12s %14s %6s  %s\n",
+              "total s", "%", "calls", "mean us", "min us", "max us", "iterations", "space", "call site");
+
+      for (const auto & site : sites) {
+         const LoopProfileData & data = site.second;
+
+         fprintf(file, "[CARE] %12.6f %6.2f %10lld %12.3f %12.3f %12.3f %14lld %6s  %s:%d\n",
+                 data.totalSeconds,
+                 totalSeconds > 0.0 ? 100.0 * data.totalSeconds / totalSeconds : 0.0,
+                 data.calls,
+                 1.0e6 * data.totalSeconds / data.calls,
+                 1.0e6 * data.minSeconds,
+                 1.0e6 * data.maxSeconds,
+                 data.iterations,
+                 data.space == chai::GPU ? "GPU" : "CPU",
+                 site.first.first.c_str(),
+                 site.first.second);
+      }
+
+      fflush(file);
+   }
+
+   void RAJAPlugin::clearLoopProfile() {
+      std::lock_guard<std::mutex> tablesGuard(s_loop_profile_tables_mutex);
+
+      for (const std::unique_ptr<LoopProfileTable> & table : s_loop_profile_tables) {
+         std::lock_guard<std::mutex> guard(table->mutex);
+         table->sites.clear();
+      }
+   }
 } // namespace care
 
@@ -15,6 +15,8 @@
 #include "chai/ExecutionSpaces.hpp"
 
 // Std library headers
+#include <chrono>
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -28,7 +30,8 @@ namespace care {
       public:
          CARE_DLL_API static void pre_forall_hook(chai::ExecutionSpace space,
                                                   const char * fileName,
-                                                  int lineNumber);
+                                                  int lineNumber,
+                                                  int length = 0);
 
          CARE_DLL_API static void post_forall_hook(chai::ExecutionSpace space,
                                                    const char * fileName,
@@ -45,6 +48,28 @@ namespace care {
          CARE_DLL_API static void setSynchronization(bool synchronizeBefore,
                                                      bool synchronizeAfter);
 
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Starts timing every loop, accumulating the number of calls,
+         ///        the total, minimum and maximum wall time, and the number of
+         ///        iterations of each call site. Device loops are synchronized
+         ///        after they run so their time is that of the kernel.
+         /// @param[in] reportAtExit Whether to write the profile to stdout when
+         ///                         the program exits
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void enableLoopProfiling(bool reportAtExit = true);
+
+         CARE_DLL_API static void disableLoopProfiling();
+
+         CARE_DLL_API static bool loopProfilingIsEnabled();
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Writes the loop profile, one call site per line, sorted by
+         ///        total time
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_DLL_API static void writeLoopProfile(FILE * file = stdout);
+
+         CARE_DLL_API static void clearLoopProfile();
+
       private:
          static void writeLoopData(chai::ExecutionSpace space,
                                    const char * fileName,
@@ -55,6 +80,8 @@ namespace care {
          static bool s_profile_host_loops;
          static bool s_synchronize_before;
          static bool s_synchronize_after;
+         static bool s_profile_loops;
+         static bool s_report_loop_profile_at_exit;
 
          static uint32_t s_colors[7];
          static int s_num_colors;
@@ -64,6 +91,20 @@ namespace care {
          static int s_current_loop_line_number;
 
          static std::vector<const chai::PointerRecord*> s_active_pointers_in_loop;
+
+         /// A loop started on this thread, and whether it was profiled or
+         /// traced when it started
+         struct ProfiledLoop {
+            std::chrono::steady_clock::time_point startTime;
+            int length;
+            bool profiled;
+            bool traced;
+         };
+
+         /// The loops running on this thread, innermost last. Every loop has
+         /// an entry, so the hooks stay paired even if profiling or tracing is
+         /// turned on or off while a loop runs.
+         static thread_local std::vector<ProfiledLoop> s_profiled_loops;
    }; // class RAJAPlugin
 } // namespace care
 
@@ -0,0 +1,381 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_SCAN_WORKSPACE_H_
+#define _CARE_SCAN_WORKSPACE_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other library headers
+#include "chai/ExecutionSpaces.hpp"
+#include "chai/ManagedArray.hpp"
+
+// Std library headers
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace care {
+   namespace detail {
+      ////////////////////////////////////////////////////////////////
+      ///
+      /// The workspaces of one type held by one thread
+      ///
+      ////////////////////////////////////////////////////////////////
+      class WorkspaceSet {
+         public:
+            virtual ~WorkspaceSet() = default;
+
+            /// Frees the arrays of the workspaces
+            virtual void release() = 0;
+
+            bool orphaned = false; //!< Whether the thread has exited
+      };
+
+      ////////////////////////////////////////////////////////////////
+      ///
+      /// Keeps track of the scan and scratch workspaces of every
+      /// thread, so that care::release_scan_workspaces can free them
+      /// all, including those of OpenMP worker threads. The
+      /// workspaces of a thread that exits are kept until then.
+      ///
+      ////////////////////////////////////////////////////////////////
+      class WorkspaceRegistry {
+         public:
+            static WorkspaceRegistry& getInstance() {
+               // Never destroyed, since threads may exit after static destruction
+               static WorkspaceRegistry* registry = new WorkspaceRegistry();
+               return *registry;
+            }
+
+            void add(WorkspaceSet* set) {
+               std::lock_guard<std::mutex> guard(m_mutex);
+               m_sets.push_back(set);
+            }
+
+            void orphan(WorkspaceSet* set) {
+               std::lock_guard<std::mutex> guard(m_mutex);
+               set->orphaned = true;
+            }
+
+            void releaseAll() {
+               std::lock_guard<std::mutex> guard(m_mutex);
+               std::vector<WorkspaceSet*> live;
+
+               for (WorkspaceSet* set : m_sets) {
+                  set->release();
+
+                  if (set->orphaned) {
+                     delete set;
+                  }
+                  else {
+                     live.push_back(set);
+                  }
+               }
+
+               m_sets.swap(live);
+            }
+
+         private:
+            std::mutex m_mutex;
+            std::vector<WorkspaceSet*> m_sets;
+      };
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Returns the calling thread's workspaces of the given type, one
+      ///        per execution space. They are owned by the registry.
+      ///////////////////////////////////////////////////////////////////////////
+      template <typename Workspace>
+      Workspace* threadWorkspaces() {
+         struct Set : public WorkspaceSet {
+            Workspace workspaces[chai::NUM_EXECUTION_SPACES];
+
+            void release() override {
+               for (Workspace& workspace : workspaces) {
+                  workspace.free();
+               }
+            }
+         };
+
+         // Hands the workspaces back to the registry when the thread exits
+         struct Holder {
+            Set* set = new Set();
+
+            Holder() { WorkspaceRegistry::getInstance().add(set); }
+            ~Holder() { WorkspaceRegistry::getInstance().orphan(set); }
+         };
+
+         static thread_local Holder holder;
+         return holder.set->workspaces;
+      }
+   } // namespace detail
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// Reusable storage for the scan idioms, so that scans do not
+   /// allocate. Each thread has one workspace per execution space
+   /// and scan type, holding
+   ///  - a grow-only scan array, resident in that space,
+   ///  - grow-only temporary storage for exclusive_scan, and
+   ///  - a ring of pinned count slots for reading back scan lengths.
+   ///
+   /// The arrays are handed out as shallow copies. A scan array
+   /// must be given back with releaseScanArray. If a scan starts
+   /// while another on the same thread still holds the scan array,
+   /// as can happen when a host scan body calls a function that
+   /// scans, it gets a fresh allocation instead. Consecutive scans
+   /// get different count slots, so a slot is not overwritten while
+   /// the host may still be reading it.
+   ///
+   /// care::release_scan_workspaces frees the workspaces of every
+   /// type and thread.
+   ///
+   ////////////////////////////////////////////////////////////////
+   template <typename T>
+   class ScanWorkspace {
+      public:
+         /// The number of pinned count slots in the ring
+         static constexpr int numCountSlots = 64;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the calling thread's workspace for the given space
+         /// @param[in] space The execution space the scan runs in
+         ///////////////////////////////////////////////////////////////////////////
+         static ScanWorkspace& get(chai::ExecutionSpace space) {
+            ScanWorkspace& workspace = detail::threadWorkspaces<ScanWorkspace>()[space];
+            workspace.m_space = space;
+            return workspace;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns a scan array of at least size elements. Its contents
+         ///        are unspecified.
+         ///////////////////////////////////////////////////////////////////////////
+         chai::ManagedArray<T> scanArray(size_t size) {
+            if (m_scanArrayInUse) {
+               return chai::ManagedArray<T>(size, allocationSpace(m_space));
+            }
+
+            grow(m_scanArray, m_scanCapacity, size, m_space);
+            m_scanArrayInUse = true;
+            return m_scanArray;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Gives back an array returned by scanArray
+         ///////////////////////////////////////////////////////////////////////////
+         void releaseScanArray(chai::ManagedArray<T> array) {
+            if (array == m_scanArray) {
+               m_scanArrayInUse = false;
+            }
+            else {
+               array.free();
+            }
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns temporary storage of at least bytes bytes, for the
+         ///        device scan libraries
+         ///////////////////////////////////////////////////////////////////////////
+         chai::ManagedArray<char> tempStorage(size_t bytes) {
+            grow(m_tempStorage, m_tempCapacity, bytes, m_space);
+            return m_tempStorage;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the ring of pinned count slots
+         ///////////////////////////////////////////////////////////////////////////
+         chai::ManagedArray<T> counts() {
+            if (m_counts == nullptr) {
+               m_counts = chai::ManagedArray<T>(numCountSlots, chai::PINNED);
+            }
+
+            return m_counts;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Claims the next slot of the ring returned by counts()
+         ///////////////////////////////////////////////////////////////////////////
+         int nextCountSlot() {
+            const int slot = m_nextSlot;
+            m_nextSlot = (m_nextSlot + 1) % numCountSlots;
+            return slot;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Frees the arrays. Used by care::release_scan_workspaces.
+         ///////////////////////////////////////////////////////////////////////////
+         void free() {
+            if (m_scanArray != nullptr) {
+               m_scanArray.free();
+               m_scanArray = nullptr;
+            }
+
+            if (m_tempStorage != nullptr) {
+               m_tempStorage.free();
+               m_tempStorage = nullptr;
+            }
+
+            if (m_counts != nullptr) {
+               m_counts.free();
+               m_counts = nullptr;
+            }
+
+            m_scanArrayInUse = false;
+            m_scanCapacity = 0;
+            m_tempCapacity = 0;
+         }
+
+      private:
+         chai::ExecutionSpace m_space = chai::CPU; //!< Where the arrays are allocated
+         chai::ManagedArray<T> m_scanArray = nullptr; //!< The scan array
+         bool m_scanArrayInUse = false; //!< Whether a scan holds the scan array
+         size_t m_scanCapacity = 0; //!< The number of elements in the scan array
+         chai::ManagedArray<char> m_tempStorage = nullptr; //!< The temporary storage
+         size_t m_tempCapacity = 0; //!< The number of bytes of temporary storage
+         chai::ManagedArray<T> m_counts = nullptr; //!< The pinned count slots
+         int m_nextSlot = 0; //!< The next count slot to hand out
+
+         static chai::ExecutionSpace allocationSpace(const chai::ExecutionSpace space) {
+            return space == chai::NONE ? chai::CPU : space;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Replaces array with one of at least size elements if it is
+         ///        smaller. Grows geometrically and does not keep the contents.
+         ///////////////////////////////////////////////////////////////////////////
+         template <typename U>
+         static void grow(chai::ManagedArray<U>& array, size_t& capacity,
+                          const size_t size, const chai::ExecutionSpace space) {
+            if (size > capacity) {
+               const size_t newCapacity = size > 2 * capacity ? size : 2 * capacity;
+
+               if (array != nullptr) {
+                  array.free();
+               }
+
+               array = chai::ManagedArray<U>(newCapacity, allocationSpace(space));
+               capacity = newCapacity;
+            }
+         }
+   };
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// Reusable scratch storage for the array utilities, so that
+   /// they do not allocate on every call. Each thread has one
+   /// workspace per execution space, holding grow-only buffers
+   /// sized in bytes, so that values of any type can reuse them.
+   ///
+   /// A buffer is held from acquire until it is given back with
+   /// release, so callers that need several buffers at once, or
+   /// that nest, get different buffers.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class ScratchWorkspace {
+      public:
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the calling thread's workspace for the given space
+         /// @param[in] space The execution space the scratch is used in
+         ///////////////////////////////////////////////////////////////////////////
+         static ScratchWorkspace& get(chai::ExecutionSpace space) {
+            ScratchWorkspace& workspace = detail::threadWorkspaces<ScratchWorkspace>()[space];
+            workspace.m_space = space;
+            return workspace;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns a buffer of at least bytes bytes. Its contents are
+         ///        unspecified.
+         ///////////////////////////////////////////////////////////////////////////
+         chai::ManagedArray<char> acquire(size_t bytes) {
+            Buffer* chosen = nullptr;
+
+            // The first free buffer that is large enough, or else the first
+            // free buffer, which is grown
+            for (Buffer& buffer : m_buffers) {
+               if (!buffer.inUse) {
+                  if (buffer.capacity >= bytes) {
+                     chosen = &buffer;
+                     break;
+                  }
+                  else if (chosen == nullptr) {
+                     chosen = &buffer;
+                  }
+               }
+            }
+
+            if (chosen == nullptr) {
+               m_buffers.push_back(Buffer());
+               chosen = &m_buffers.back();
+            }
+
+            if (bytes > chosen->capacity) {
+               const size_t newCapacity = bytes > 2 * chosen->capacity ? bytes : 2 * chosen->capacity;
+
+               if (chosen->array != nullptr) {
+                  chosen->array.free();
+               }
+
+               chosen->array = chai::ManagedArray<char>(newCapacity, m_space == chai::NONE ? chai::CPU : m_space);
+               chosen->capacity = newCapacity;
+            }
+
+            chosen->inUse = true;
+            return chosen->array;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Gives back a buffer returned by acquire
+         ///////////////////////////////////////////////////////////////////////////
+         void release(chai::ManagedArray<char> array) {
+            for (Buffer& buffer : m_buffers) {
+               if (buffer.array == array) {
+                  buffer.inUse = false;
+                  return;
+               }
+            }
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Frees the buffers. Used by care::release_scan_workspaces.
+         ///////////////////////////////////////////////////////////////////////////
+         void free() {
+            for (Buffer& buffer : m_buffers) {
+               if (buffer.array != nullptr) {
+                  buffer.array.free();
+               }
+            }
+
+            m_buffers.clear();
+         }
+
+      private:
+         struct Buffer {
+            chai::ManagedArray<char> array = nullptr; //!< The storage
+            size_t capacity = 0; //!< The number of bytes of storage
+            bool inUse = false; //!< Whether a caller holds the buffer
+         };
+
+         chai::ExecutionSpace m_space = chai::CPU; //!< Where the buffers are allocated
+         std::vector<Buffer> m_buffers; //!< The buffers, free or held
+   };
+
+   ///////////////////////////////////////////////////////////////////////////
+   /// @brief Frees the scan and scratch workspaces of every thread. Call this
+   ///        at teardown, before care::report_leaks and before the memory
+   ///        pools are destroyed, while no scans are running. Scans after
+   ///        this allocate new workspaces.
+   ///////////////////////////////////////////////////////////////////////////
+   inline void release_scan_workspaces() {
+      detail::WorkspaceRegistry::getInstance().releaseAll();
+   }
+} // namespace care
+
+#endif // !defined(_CARE_SCAN_WORKSPACE_H_)
+
@@ -0,0 +1,285 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_SEARCH_INDEX_H_
+#define _CARE_SEARCH_INDEX_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other CARE headers
+#include "care/care.h"
+#include "care/util.h"
+
+namespace care {
+
+///////////////////////////////////////////////////////////////////////////
+/// @class SearchIndex
+/// @brief A search structure prebuilt over a sorted array, for maps that
+///    are searched many times, such as global to local ID lookups.
+/// The values are stored in Eytzinger (breadth first) order: the children
+///    of slot k are slots 2k and 2k+1, so every search walks down the
+///    same short prefix of the array and the top levels stay in cache.
+///    The descent is branch free and, on the host, prefetches the cache
+///    line holding the grandchildren four levels down.
+/// Results are indices into the original map, so find is a drop in
+///    replacement for care_utils::BinarySearch. Like host_device_ptr, a
+///    SearchIndex is captured by value in loops, where find and lowerBound
+///    search it on the host or the device. Outside of loops, hostFind and
+///    hostLowerBound search it through the host copy.
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+class SearchIndex {
+   public:
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Default constructor. Searches of an empty index find nothing.
+      ///////////////////////////////////////////////////////////////////////////
+      SearchIndex() = default;
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Builds the index in parallel. map is not referenced afterwards.
+      /// @param[in] map     - The sorted array to search
+      /// @param[in] start   - The index of the first entry to search
+      /// @param[in] mapSize - The number of entries to search, as for
+      ///                      care_utils::BinarySearch
+      ///////////////////////////////////////////////////////////////////////////
+      SearchIndex(host_device_ptr<const T> map, const int start, const int mapSize)
+         : m_start(start),
+           m_size(mapSize),
+           m_tree(mapSize + 1, "SearchIndex tree")
+      {
+         host_device_ptr<T> tree = m_tree;
+
+         LOOP_STREAM(k, 1, mapSize + 1) {
+            tree[k] = map[start + eytzingerRank(k, mapSize)];
+         } LOOP_STREAM_END
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Returns the in order position of slot k (1 based) in an
+      ///    Eytzinger tree of n nodes. The last level of the tree is filled
+      ///    from the left, so the rank in the perfect tree of the same height
+      ///    is corrected by the number of absent leaves that precede it.
+      /// @param[in] k - The slot, in [1, n]
+      /// @param[in] n - The number of nodes
+      /// @return the 0 based sorted position stored in slot k
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE static int eytzingerRank(const int k, const int n) {
+         const int lastLevel = floorLog2(n);
+         const int depth = floorLog2(k);
+         const int perfectRank = (2 * (k - (1 << depth)) + 1) * (1 << (lastLevel - depth)) - 1;
+         const int numLeaves = n - (1 << lastLevel) + 1;
+         const int leavesBefore = (perfectRank + 1) / 2 < (1 << lastLevel) ? (perfectRank + 1) / 2 : (1 << lastLevel);
+         const int absentBefore = leavesBefore - numLeaves;
+
+         return absentBefore > 0 ? perfectRank - absentBefore : perfectRank;
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Searches for num with the semantics of care_utils::BinarySearch
+      /// @param[in] num               - The value to search for
+      /// @param[in] returnUpperBound  - Whether to return the index of the
+      ///                                first entry greater than num instead
+      ///                                of an entry equal to num
+      /// @return the index in the original map, or -1 if not found
+      /// @note Must be called in a loop that captures the index
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE int find(const T num, const bool returnUpperBound = false) const {
+         return m_size == 0 ? -1 : find(&m_tree[0], num, returnUpperBound);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Finds the first entry that is not less than num
+      /// @param[in] num - The value to search for
+      /// @return the index in the original map, or start + mapSize if every
+      ///    entry is less than num
+      /// @note Must be called in a loop that captures the index
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE int lowerBound(const T num) const {
+         return m_size == 0 ? m_start : lowerBound(&m_tree[0], num);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Same as find, but called on the host outside of loops. Brings
+      ///    the index to the host if it was built on the device.
+      ///////////////////////////////////////////////////////////////////////////
+      int hostFind(const T num, const bool returnUpperBound = false) const {
+         return m_size == 0 ? -1 : find(hostTree(), num, returnUpperBound);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Same as hostFind for each of n values. The index is brought to
+      ///    the host once rather than once per value.
+      /// @param[in]  nums             - The values to search for, on the host
+      /// @param[in]  n                - The number of values
+      /// @param[out] results          - The index of each value, on the host
+      /// @param[in]  returnUpperBound - As for hostFind
+      ///////////////////////////////////////////////////////////////////////////
+      void hostFind(const T* nums, const int n, int* results, const bool returnUpperBound = false) const {
+         const T* tree = m_size == 0 ? nullptr : hostTree();
+
+         for (int i = 0; i < n; ++i) {
+            results[i] = m_size == 0 ? -1 : find(tree, nums[i], returnUpperBound);
+         }
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Same as lowerBound, but called on the host outside of loops.
+      ///    Brings the index to the host if it was built on the device.
+      ///////////////////////////////////////////////////////////////////////////
+      int hostLowerBound(const T num) const {
+         return m_size == 0 ? m_start : lowerBound(hostTree(), num);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief The number of entries indexed
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE int size() const {
+         return m_size;
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Frees the underlying storage
+      ///////////////////////////////////////////////////////////////////////////
+      void free() {
+         m_tree.free();
+         m_tree = nullptr;
+         m_size = 0;
+      }
+
+   private:
+      int m_start = 0; //!< The index of the first entry in the original map
+      int m_size = 0; //!< The number of entries
+      host_device_ptr<T> m_tree = nullptr; //!< The entries in Eytzinger order, 1 based
+
+      CARE_HOST_DEVICE static int floorLog2(int x) {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+         return 31 - __clz(x);
+#elif defined(__GNUC__) || defined(__clang__)
+         return 31 - __builtin_clz((unsigned int) x);
+#else
+         int result = 0;
+
+         while (x >>= 1) {
+            ++result;
+         }
+
+         return result;
+#endif
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief The index in the original map of the entry in slot k. The
+      ///    layout is fixed by the size, so no permutation is stored.
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE int originalIndex(const int k) const {
+         return m_start + eytzingerRank(k, m_size);
+      }
+
+      const T* hostTree() const {
+         return host_ptr<const T>(host_device_ptr<const T>(m_tree)).data();
+      }
+
+      CARE_HOST_DEVICE int find(const T* tree, const T num, const bool returnUpperBound) const {
+         if (returnUpperBound) {
+            const int k = descend<true>(tree, num);
+            return k == 0 ? -1 : originalIndex(k);
+         }
+         else {
+            const int k = descend<false>(tree, num);
+            return k != 0 && tree[k] == num ? originalIndex(k) : -1;
+         }
+      }
+
+      CARE_HOST_DEVICE int lowerBound(const T* tree, const T num) const {
+         const int k = descend<false>(tree, num);
+         return k == 0 ? m_start + m_size : originalIndex(k);
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Walks to a leaf, going right past every entry less than num
+      ///    (or not greater than num for an upper bound), then backs up past
+      ///    the trailing right turns.
+      /// @param[in] tree - The entries in Eytzinger order, in the space the
+      ///                   search runs in. Must not be empty.
+      /// @param[in] num  - The value to search for
+      /// @return the slot of the bound, or 0 if there is none
+      ///////////////////////////////////////////////////////////////////////////
+      template <bool upper>
+      CARE_HOST_DEVICE int descend(const T* tree, const T num) const {
+         const int n = m_size;
+         int k = 1;
+
+         while (k <= n) {
+#if !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_prefetch(tree + 16 * k);
+#endif
+            k = 2 * k + (int) (upper ? !(num < tree[k]) : tree[k] < num);
+         }
+
+         return k >> (care::countTrailingZeros(~(unsigned long long) k) + 1);
+      }
+};
+
+///////////////////////////////////////////////////////////////////////////
+/// @brief Resolves many searches against the same SearchIndex in parallel
+/// @param[in]  index            - The prebuilt index
+/// @param[in]  queries          - The values to search for
+/// @param[in]  n                - The number of queries
+/// @param[out] results          - The index of each query in the original
+///                                map, or -1, as for care_utils::BinarySearch
+/// @param[in]  returnUpperBound - Whether to search for the first entry
+///                                greater than each query instead
+/// @return void
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void BatchBinarySearch(RAJA::seq_exec,
+                              const SearchIndex<T> & index,
+                              host_device_ptr<const T> queries, const int n,
+                              host_device_ptr<int> results,
+                              const bool returnUpperBound = false) {
+   host_ptr<const T> hostQueries = queries;
+   host_ptr<int> hostResults = results;
+
+   index.hostFind(hostQueries.data(), n, hostResults.data(), returnUpperBound);
+}
+
+#ifdef RAJA_PARALLEL_ACTIVE
+
+///////////////////////////////////////////////////////////////////////////
+/// @brief Parallel version of BatchBinarySearch
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void BatchBinarySearch(RAJAExec,
+                              const SearchIndex<T> & index,
+                              host_device_ptr<const T> queries, const int n,
+                              host_device_ptr<int> results,
+                              const bool returnUpperBound = false) {
+   SearchIndex<T> searchIndex = index;
+
+   LOOP_STREAM(i, 0, n) {
+      results[i] = searchIndex.find(queries[i], returnUpperBound);
+   } LOOP_STREAM_END
+}
+
+#endif // RAJA_PARALLEL_ACTIVE
+
+///////////////////////////////////////////////////////////////////////////
+/// @brief BatchBinarySearch with the default execution policy
+///////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void BatchBinarySearch(const SearchIndex<T> & index,
+                              host_device_ptr<const T> queries, const int n,
+                              host_device_ptr<int> results,
+                              const bool returnUpperBound = false) {
+   BatchBinarySearch<T>(RAJAExec{}, index, queries, n, results, returnUpperBound);
+}
+
+} // namespace care
+
+#endif // !defined(_CARE_SEARCH_INDEX_H_)
+
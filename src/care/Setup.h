@@ -11,7 +11,9 @@
 // CARE headers
 #include "care/config.h"
 #include "care/CHAICallback.h"
+#include "care/LoopTrace.h"
 #include "care/RAJAPlugin.h"
+#include "care/ScanWorkspace.h"
 
 // Other library headers
 #include "chai/ExecutionSpaces.hpp"
@@ -123,6 +125,28 @@ namespace care {
    inline void setSynchronization(bool before, bool after) {
       RAJAPlugin::setSynchronization(before, after);
    }
+
+   // Loop profiling controls.
+   inline void enable_loop_profiling(bool reportAtExit = true) {
+      RAJAPlugin::enableLoopProfiling(reportAtExit);
+   }
+
+   inline void disable_loop_profiling() {
+      RAJAPlugin::disableLoopProfiling();
+   }
+
+   inline void write_loop_profile(FILE * file = stdout) {
+      RAJAPlugin::writeLoopProfile(file);
+   }
+
+   // Writes a Chrome trace of the loops, sorts and scans to the given file.
+   inline bool start_loop_trace(const std::string & fileName) {
+      return LoopTrace::start(fileName);
+   }
+
+   inline void stop_loop_trace() {
+      LoopTrace::stop();
+   }
    
    // does a GPU device synchronize if there has been a kernel launch through care
    // since the last time this was called.
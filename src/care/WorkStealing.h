@@ -0,0 +1,236 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_WORK_STEALING_H_
+#define _CARE_WORK_STEALING_H_
+
+// CARE config header
+#include "care/config.h"
+
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+#include <omp.h>
+#endif
+
+// Std library headers
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace care {
+   namespace detail {
+      // GCC warns on any use of the interference size in a header, since it
+      // varies with -mtune, so it falls back to the common line size too.
+#if defined(__cpp_lib_hardware_interference_size) && !(defined(__GNUC__) && !defined(__clang__))
+      constexpr std::size_t workStealingAlignment = std::hardware_destructive_interference_size;
+#else
+      constexpr std::size_t workStealingAlignment = 64;
+#endif
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief The indices a thread of a work stealing loop has yet to run. The
+      ///        owner takes chunks from the front and thieves split off the back.
+      ///        Aligned to a cache line so neighbouring ranges do not share one.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      struct alignas(workStealingAlignment) WorkStealingRange {
+         std::mutex lock;
+         int begin = 0;
+         int end = 0;
+      };
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief The ranges of every thread of a work stealing loop. The storage is
+      ///        aligned by hand since new does not honour extended alignment
+      ///        before C++17.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      class WorkStealingRanges {
+         public:
+            explicit WorkStealingRanges(const int count) :
+               m_count(count),
+               m_storage(new unsigned char[(count + 1) * sizeof(WorkStealingRange)])
+            {
+               void* aligned = m_storage.get();
+               std::size_t space = (count + 1) * sizeof(WorkStealingRange);
+               m_ranges = static_cast<WorkStealingRange*>(std::align(alignof(WorkStealingRange),
+                                                                     count * sizeof(WorkStealingRange),
+                                                                     aligned, space));
+
+               for (int i = 0; i < m_count; ++i) {
+                  new (m_ranges + i) WorkStealingRange();
+               }
+            }
+
+            ~WorkStealingRanges() {
+               for (int i = 0; i < m_count; ++i) {
+                  m_ranges[i].~WorkStealingRange();
+               }
+            }
+
+            WorkStealingRanges(const WorkStealingRanges&) = delete;
+            WorkStealingRanges& operator=(const WorkStealingRanges&) = delete;
+
+            WorkStealingRange* get() const { return m_ranges; }
+
+            WorkStealingRange& operator[](const int i) const { return m_ranges[i]; }
+
+         private:
+            int m_count;
+            std::unique_ptr<unsigned char[]> m_storage;
+            WorkStealingRange* m_ranges = nullptr;
+      };
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Takes the next chunk from the front of the calling thread's own
+      ///        range. Chunks are a quarter of what is left, but no fewer than
+      ///        minChunk indices, so they shrink as the range runs down and the
+      ///        back of the range stays available to thieves.
+      ///
+      /// @return whether a chunk was taken
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      inline bool takeWorkStealingChunk(WorkStealingRange& range, const int minChunk,
+                                        int& chunkBegin, int& chunkEnd) {
+         std::lock_guard<std::mutex> guard(range.lock);
+         const int remaining = range.end - range.begin;
+
+         if (remaining <= 0) {
+            return false;
+         }
+
+         int chunk = remaining / 4;
+         chunk = chunk < minChunk ? minChunk : chunk;
+         chunk = chunk > remaining ? remaining : chunk;
+
+         chunkBegin = range.begin;
+         chunkEnd = range.begin + chunk;
+         range.begin = chunkEnd;
+         return true;
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Steals the back half of another thread's range into the calling
+      ///        thread's own, which must be empty. Victims are tried in turn,
+      ///        starting after the thief.
+      ///
+      /// @return whether anything was stolen. Indices are only ever removed, so
+      ///         once nothing can be stolen the loop is done.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      inline bool stealWork(WorkStealingRange* ranges, const int numRanges, const int thief) {
+         for (int offset = 1; offset < numRanges; ++offset) {
+            WorkStealingRange& victim = ranges[(thief + offset) % numRanges];
+            int stolenBegin = 0;
+            int stolenEnd = 0;
+
+            {
+               std::lock_guard<std::mutex> guard(victim.lock);
+               const int remaining = victim.end - victim.begin;
+
+               if (remaining > 0) {
+                  stolenEnd = victim.end;
+                  stolenBegin = victim.end - (remaining - remaining / 2);
+                  victim.end = stolenBegin;
+               }
+            }
+
+            if (stolenEnd > stolenBegin) {
+               std::lock_guard<std::mutex> guard(ranges[thief].lock);
+               ranges[thief].begin = stolenBegin;
+               ranges[thief].end = stolenEnd;
+               return true;
+            }
+         }
+
+         return false;
+      }
+   } // namespace detail
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Calls body(i) for each i in [start, end), load balanced by work
+   ///        stealing, for loops whose iterations vary widely in cost.
+   ///
+   /// The range is first split evenly between the OpenMP threads. Each thread
+   /// runs its own range in chunks that shrink as the range runs down, and a
+   /// thread that runs out steals the back half of another's remaining range.
+   /// Without OpenMP, or with one thread, the loop runs sequentially.
+   ///
+   /// Each thread runs its own copy of the body, as RAJA's OpenMP reducers
+   /// require, so the caller must have set the CHAI execution space before
+   /// calling this.
+   ///
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void work_stealing_forall(const int start, const int end, const LB& body) {
+      const int length = end - start;
+
+      if (length <= 0) {
+         return;
+      }
+
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+      const int numThreads = omp_get_max_threads();
+#else
+      const int numThreads = 1;
+#endif
+
+      if (numThreads < 2 || length < 2) {
+         for (int i = start; i < end; ++i) {
+            body(i);
+         }
+
+         return;
+      }
+
+      detail::WorkStealingRanges ranges(numThreads);
+
+      for (int thread = 0; thread < numThreads; ++thread) {
+         ranges[thread].begin = start + (int) ((long long) length * thread / numThreads);
+         ranges[thread].end = start + (int) ((long long) length * (thread + 1) / numThreads);
+      }
+
+      const int minChunk = length / (256 * numThreads) > 0 ? length / (256 * numThreads) : 1;
+      detail::WorkStealingRange* const rangesPtr = ranges.get();
+
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+#pragma omp parallel num_threads(numThreads)
+#endif
+      {
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE)
+         const int self = omp_get_thread_num();
+#else
+         const int self = 0;
+#endif
+         const LB threadBody = body;
+         int chunkBegin = 0;
+         int chunkEnd = 0;
+
+         // The team may be smaller than asked for. The ranges of the missing
+         // threads are then stolen like any other.
+         do {
+            while (detail::takeWorkStealingChunk(rangesPtr[self], minChunk, chunkBegin, chunkEnd)) {
+               for (int i = chunkBegin; i < chunkEnd; ++i) {
+                  threadBody(i);
+               }
+            }
+         } while (detail::stealWork(rangesPtr, numThreads, self));
+      }
+   }
+} // namespace care
+
+#endif // !defined(_CARE_WORK_STEALING_H_)
+
@@ -12,7 +12,10 @@
 #include "care/config.h"
 
 // Other CARE headers
+#include "care/bitset.h"
 #include "care/care.h"
+#include "care/LoopTrace.h"
+#include "care/simd.h"
 
 // Other library headers
 #ifdef __CUDACC__
@@ -25,6 +28,11 @@
 #include "hipcub/hipcub.hpp"
 #endif
 
+// Std library headers
+#include <cfloat>
+#include <cstring>
+#include <type_traits>
+
 #define CARE_MAX(a,b) a > b ? a : b
 #define CARE_MIN(a,b) a < b ? a : b
 
@@ -71,6 +79,9 @@ int ArrayMinMax(care::host_device_ptr<const T> arr, care::host_device_ptr<int co
 template <typename T, typename ReducerType=T, typename Exec=RAJAExec>
 int ArrayMinMax(care::host_device_ptr<T> arr, care::host_device_ptr<int> mask, int n, double *outMin, double *outMax);
 
+template <typename T, typename ReducerType=T, typename Exec=RAJAExec>
+int ArrayMinMax(care::host_device_ptr<const T> arr, care::bitset const & mask, int n, double *outMin, double *outMax);
+
 template <typename T>
 CARE_HOST_DEVICE int ArrayMinMax(care::local_ptr<const T> arr, care::local_ptr<int const> mask, int n, double *outMin, double *outMax);
 
@@ -83,6 +94,9 @@ T ArrayMinLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc);
 template <typename T, typename Exec=RAJAExec>
 T ArrayMaxLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc);
 
+template <typename T, typename Predicate, typename Exec=RAJAExec>
+int FindFirst(care::host_device_ptr<const T> arr, int start, int end, Predicate pred) ;
+
 template <typename T>
 int ArrayFind(care::host_device_ptr<const T> arr, const int len, const T val, const int start = 0) ;
 
@@ -149,6 +163,71 @@ T ArrayMaskedSumSubset(care::host_device_ptr<const T> arr, care::host_device_ptr
 template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
 T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, T initVal);
 
+template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
+T ArrayMaskedSumSubset(care::host_device_ptr<const T> arr, care::bitset const & mask, care::host_device_ptr<int const> subset, int n, T initVal);
+
+template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
+T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::bitset const & mask, int n, T initVal);
+
+/* statistics that can be requested from ArrayStats, combined with bitwise or */
+enum ArrayStatistic {
+   ARRAY_STAT_MIN = 1 << 0,
+   ARRAY_STAT_MAX = 1 << 1,
+   ARRAY_STAT_MINLOC = 1 << 2,
+   ARRAY_STAT_MAXLOC = 1 << 3,
+   ARRAY_STAT_SUM = 1 << 4,
+   ARRAY_STAT_SUM_OF_SQUARES = 1 << 5,
+   ARRAY_STAT_COUNT = 1 << 6,
+   ARRAY_STAT_ALL = (1 << 7) - 1
+};
+
+/* results of ArrayStats. Fields for statistics that were not requested are left at their initial values */
+template <typename T, typename ReduceType=T>
+struct ArrayStatistics {
+   T min = std::numeric_limits<T>::max();
+   T max = std::numeric_limits<T>::lowest();
+   int minLoc = -1;
+   int maxLoc = -1;
+   ReduceType sum = ReduceType(0);
+   ReduceType sumOfSquares = ReduceType(0);
+   int count = 0;
+   int numIncluded = 0;
+};
+
+template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
+ArrayStatistics<T, ReduceType> ArrayStats(care::host_device_ptr<const T> arr, int n, int statistics, T countVal = T(0));
+
+template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
+ArrayStatistics<T, ReduceType> ArrayStats(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, int statistics, T countVal = T(0));
+
+/* segmented (CSR-style) operations: segment s covers [offsets[s], offsets[s+1]) */
+template <typename T, typename ReduceType=T, typename Exec=RAJAExec>
+void SegmentedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, care::host_device_ptr<ReduceType> result);
+
+template <typename T, typename Exec=RAJAExec>
+void SegmentedMin(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, T initVal, care::host_device_ptr<T> result);
+
+template <typename T, typename Exec=RAJAExec>
+void SegmentedMax(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, T initVal, care::host_device_ptr<T> result);
+
+template <typename T, typename Exec=RAJAExec>
+void SegmentedArgMin(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, care::host_device_ptr<int> result);
+
+template <typename T, typename Exec=RAJAExec, typename Fn=RAJA::operators::plus<T>>
+void segmented_exclusive_scan(care::host_device_ptr<const T> inData, care::host_device_ptr<T> outData,
+                              care::host_device_ptr<int const> offsets, int numSegments,
+                              Fn binop = Fn{}, T val = T(0));
+
+/* selection without sorting */
+template <typename T, typename Exec=RAJAExec>
+T NthElement(care::host_device_ptr<const T> arr, int n, int k);
+
+template <typename T, typename Exec=RAJAExec>
+void TopK(care::host_device_ptr<const T> arr, int n, int k, care::host_device_ptr<T> & values, care::host_device_ptr<int> & indices);
+
+template <typename T, typename Exec=RAJAExec>
+void TopK(care::host_device_ptr<const T> arr, int n, int k, care::host_device_ptr<T> & values);
+
 template <typename T, typename Exec=RAJAExec>
 int FindIndexGT(care::host_device_ptr<const T> arr, int n, T limit);
 
@@ -239,6 +318,21 @@ CARE_HOST_DEVICE int BinarySearch(const mapType *map, const int start,
                              const int mapSize, const mapType num,
                              bool returnUpperBound = false) ;
 
+template <typename T>
+CARE_HOST_DEVICE int GallopSearch(const T *map, const int start,
+                                  const int mapSize, const T num) ;
+
+template <typename T>
+CARE_HOST_DEVICE int MergePathSearch(const T *arr1, const int start1, const int length1,
+                                     const T *arr2, const int start2, const int length2,
+                                     const int diagonal) ;
+
+template <typename T>
+CARE_HOST_DEVICE int MergePathIntersect(const T *arr1, const int start1, const int length1,
+                                        const T *arr2, const int start2, const int length2,
+                                        const int diagonal, const int nextDiagonal,
+                                        int *matches1, int *matches2, const int offset) ;
+
 
 template <typename ArrayType, typename Exec>
 inline void IntersectArrays(Exec,
@@ -256,6 +350,10 @@ inline void IntersectArrays(Exec,
  *             at which intersection occurs, and the corresponding set
  *             of indices in the second array.
  *             This is the parallel overload of this method.
+ *             Similarly sized arrays are intersected with a merge path partition:
+ *             each iteration merges an equal slice of both arrays. If one array is
+ *             much larger, each iteration instead gallops through the larger array
+ *             for a contiguous run of the smaller one.
  * Note      : matches are given as offsets from start1 and start2. So, if a match occurs at arr1[2] with
  *             start1=0, then matches1 will contain 2. However, if start1 was 1, then matches will contain 2-start1=1.
  ************************************************************************/
@@ -267,9 +365,11 @@ inline void IntersectArrays(RAJAExec,
                             care::host_device_ptr<int> &matches1, care::host_device_ptr<int> &matches2,
                             int *numMatches) {
    *numMatches = 0 ;
-   int smaller = (size1 < size2) ? size1 : size2 ;
+   const int length1 = size1 - start1 ;
+   const int length2 = size2 - start2 ;
+   int smaller = (length1 < length2) ? length1 : length2 ;
 
-   if (smaller <= 0 || start1 >= size1 || start2 >= size2) {
+   if (smaller <= 0) {
       matches1 = nullptr ;
       matches2 = nullptr ;
       return ;
@@ -294,52 +394,116 @@ inline void IntersectArrays(RAJAExec,
       checkSorted<ArrayType>(arr2, size2, funcname, "arr2") ;
    }
 
-   care::host_device_ptr<int> smallerMatches, largerMatches;
-   int larger, smallStart, largeStart;
-   care::host_device_ptr<const ArrayType> smallerArray, largerArray;
+   /* number of elements (or merge steps) handled sequentially by each iteration */
+   const int itemsPerPartition = 64 ;
+
+   /* above this size ratio, galloping through the larger array beats merging */
+   const int gallopRatio = 32 ;
+
+   const int larger = (length1 < length2) ? length2 : length1 ;
+
+   if (larger / smaller >= gallopRatio) {
+      care::host_device_ptr<int> smallerMatches, largerMatches;
+      int smallStart, largeStart;
+      care::host_device_ptr<const ArrayType> smallerArray, largerArray;
+
+      if (smaller == length1) {
+         smallerArray = arr1;
+         largerArray = arr2;
+         smallStart = start1;
+         largeStart = start2;
+         smallerMatches = matches1;
+         largerMatches = matches2;
+      }
+      else {
+         smallerArray = arr2;
+         largerArray = arr1;
+         smallStart = start2;
+         largeStart = start1;
+         smallerMatches = matches2;
+         largerMatches = matches1;
+      }
+
+      care::host_device_ptr<int> searches(smaller + 1,"IntersectArrays searches");
+      care::host_device_ptr<int> matched(smaller + 1, "IntersectArrays matched");
+
+      /* each partition walks a contiguous run of the smaller array, galloping
+       * forward through the larger array from the previous match position */
+      const int numPartitions = (smaller + itemsPerPartition - 1) / itemsPerPartition ;
+      const int largeEnd = largeStart + larger ;
+
+      LOOP_STREAM(p, 0, numPartitions) {
+         const int first = p * itemsPerPartition ;
+         const int last = first + itemsPerPartition < smaller ? first + itemsPerPartition : smaller ;
+         int position = largeStart ;
+
+         for (int i = first ; i < last ; ++i) {
+            const ArrayType value = smallerArray[i + smallStart] ;
+            position = GallopSearch<ArrayType>(largerArray, position, largeEnd - position, value) ;
+            const bool found = position < largeEnd && largerArray[position] == value ;
+            searches[i] = found ? position : -1 ;
+            matched[i] = found ;
+         }
+
+         if (p == numPartitions - 1) {
+            searches[smaller] = -1 ;
+            matched[smaller] = 0 ;
+         }
+      } LOOP_STREAM_END
+
+      exclusive_scan<int, RAJAExec>(matched, nullptr, smaller + 1, RAJA::operators::plus<int>{}, 0, true);
 
-   if (smaller == size1) {
-      smallerArray = arr1;
-      largerArray = arr2;
-      larger = size2;
-      smallStart = start1;
-      largeStart = start2;
-      smallerMatches = matches1;
-      largerMatches = matches2;
+      LOOP_STREAM(i, 0, smaller) {
+         if (searches[i] > -1) {
+            // matches reported relative to smallStart and largeStart
+            smallerMatches[matched[i]] = i;
+            largerMatches[matched[i]] = searches[i] - largeStart;
+         }
+      } LOOP_STREAM_END
+
+      *numMatches = matched.pick(smaller);
+
+      searches.free(); 
+      matched.free();
    }
    else {
-      smallerArray = arr2;
-      largerArray = arr1;
-      larger = size1;
-      smallStart = start2;
-      largeStart = start1;
-      smallerMatches = matches2;
-      largerMatches = matches1;
-   }
-
-   /* this avoid thrust and the inherent memory allocation overhead associated with it */
-   care::host_device_ptr<int> searches(smaller + 1,"IntersectArrays searches");
-   care::host_device_ptr<int> matched(smaller + 1, "IntersectArrays matched");
-
-   LOOP_STREAM(i, 0, smaller + 1) {
-      searches[i] = i != smaller ? BinarySearch<ArrayType>(largerArray, largeStart, larger, smallerArray[i + smallStart]) : -1;
-      matched[i] = i != smaller && searches[i] > -1;
-   } LOOP_STREAM_END
+      /* merge path: split the merged sequence into equal diagonal slices, find
+       * where each slice starts in both arrays, then merge each slice linearly.
+       * The first pass counts matches, the second writes them. */
+      const int total = length1 + length2 ;
+      const int numPartitions = (total + itemsPerPartition - 1) / itemsPerPartition ;
 
-   exclusive_scan<int, RAJAExec>(matched, nullptr, smaller + 1, RAJA::operators::plus<int>{}, 0, true);
+      care::host_device_ptr<int> counts(numPartitions + 1, "IntersectArrays counts");
 
-   LOOP_STREAM(i, 0, smaller) {
-      if (searches[i] > -1) {
-         // matches reported relative to smallStart and largeStart
-         smallerMatches[matched[i]] = i;
-         largerMatches[matched[i]] = searches[i] - largeStart;
-      }
-   } LOOP_STREAM_END
+      LOOP_STREAM(p, 0, numPartitions + 1) {
+         if (p == numPartitions) {
+            counts[p] = 0 ;
+         }
+         else {
+            const int diagonal = p * itemsPerPartition ;
+            const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+            counts[p] = MergePathIntersect<ArrayType>(arr1, start1, length1,
+                                                      arr2, start2, length2,
+                                                      diagonal, nextDiagonal,
+                                                      nullptr, nullptr, 0) ;
+         }
+      } LOOP_STREAM_END
+
+      exclusive_scan<int, RAJAExec>(counts, nullptr, numPartitions + 1, RAJA::operators::plus<int>{}, 0, true);
 
-   *numMatches = matched.pick(smaller);
+      LOOP_STREAM(p, 0, numPartitions) {
+         const int diagonal = p * itemsPerPartition ;
+         const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+         MergePathIntersect<ArrayType>(arr1, start1, length1,
+                                       arr2, start2, length2,
+                                       diagonal, nextDiagonal,
+                                       matches1, matches2, counts[p]) ;
+      } LOOP_STREAM_END
+
+      *numMatches = counts.pick(numPartitions);
 
-   searches.free(); 
-   matched.free();
+      counts.free();
+   }
 
    /* change the size of the array */
    /* (reallocing to a size of zero should be the same as freeing
@@ -435,7 +599,7 @@ inline void IntersectArrays(RAJA::seq_exec,
    A2 = arr2;
    A2 += start2;
 
-   while (i < size1 && j < size2) {
+   while (i < size1 - start1 && j < size2 - start2) {
       if ((A1)[i] < A2[j]) {
          ++i;
       }
@@ -610,777 +774,2672 @@ CARE_HOST_DEVICE inline int BinarySearch(const T *map, const int start,
    }
 }
 
-#ifdef RAJA_PARALLEL_ACTIVE
 /************************************************************************
- * Function  : uniqArray
- * Author(s) : Peter Robinson
- * Purpose   : GPU version of uniqArray, implements uniq using an exclusive
- *             scan.
-  ************************************************************************/
+ * Function  : GallopSearch
+ * Purpose   : Exponential search of a sorted array, or a sorted subarray,
+ *             for the first entry that is not less than num. Probes
+ *             start, start+1, start+2, start+4, ... and then does a binary
+ *             search of the last interval, so the cost is logarithmic in
+ *             the distance from start rather than in mapSize. This makes it
+ *             well suited to walking forward through a large array while
+ *             searching for an increasing sequence of values.
+ *
+ *             As with BinarySearch, mapSize is the length of the region
+ *             being searched. Returns start+mapSize if every entry in the
+ *             region is less than num.
+ ************************************************************************/
 template <typename T>
-inline void uniqArray(RAJAExec, care::host_device_ptr<T>  Array, size_t len, care::host_device_ptr<T> & outArray, int & outLen, bool noCopy=false) {
-   care::host_device_ptr<int> uniq(len+1,"uniqArray uniq");
-   ArrayFill<int, RAJAExec>(uniq, len+1, 0);
-   LOOP_STREAM(i, 0, len) {
-      uniq[i] = (int) ((i == len-1) || (Array[i] < Array[i+1] || Array[i+1] < Array[i])) ;
-   } LOOP_STREAM_END
+CARE_HOST_DEVICE inline int GallopSearch(const T *map, const int start,
+                                         const int mapSize, const T num)
+{
+   const int end = start + mapSize ;
+   int lo = start ;
+   int hi = start ;
+   int bound = 1 ;
 
-   exclusive_scan<int, RAJAExec>(uniq, nullptr, len+1, RAJA::operators::plus<int>{}, 0, true);
-   int numUniq;
-   uniq.pick(len, numUniq);
-   care::host_device_ptr<T> & tmp = outArray;
-   tmp.alloc(numUniq);
-   LOOP_STREAM(i, 0, len) {
-      if ((i == len-1) || (Array[i] < Array[i+1] || Array[i+1] < Array[i])) {
-         tmp[uniq[i]] = Array[i];
+   while (hi < end && map[hi] < num) {
+      lo = hi + 1 ;
+      hi = start + bound ;
+      bound <<= 1 ;
+   }
+
+   if (hi > end) {
+      hi = end ;
+   }
+
+   while (lo < hi) {
+      const int mid = lo + ((hi - lo) >> 1) ;
+
+      if (map[mid] < num) {
+         lo = mid + 1 ;
       }
-   } LOOP_STREAM_END
-   uniq.free();
-   outLen = numUniq;
-   return;
+      else {
+         hi = mid ;
+      }
+   }
+
+   return lo ;
 }
 
 /************************************************************************
- * Function  : uniqArray
- * Author(s) : Peter Robinson
- * Purpose   : GPU version of uniqArray, implements uniq using an exclusive
- *             scan.
-  ************************************************************************/
+ * Function  : MergePathSearch
+ * Purpose   : Given two sorted subarrays arr1[start1, start1+length1) and
+ *             arr2[start2, start2+length2), returns how many elements of
+ *             the first subarray precede the given diagonal of their merged
+ *             sequence. The number from the second subarray is
+ *             diagonal minus the return value. Ties are merged with the
+ *             element of the first array first.
+ ************************************************************************/
 template <typename T>
-inline int uniqArray(RAJAExec exec, care::host_device_ptr<T> & Array, size_t len, bool noCopy=false) {
-   care::host_device_ptr<T> tmp;
-   int newLen;
-   uniqArray(exec, Array, len, tmp, newLen);
-   if (noCopy) {
-      Array.free();
-      Array = tmp;
-   }
-   else {
-      ArrayCopy<T>(Array, tmp, newLen);
-      tmp.free();
+CARE_HOST_DEVICE inline int MergePathSearch(const T *arr1, const int start1, const int length1,
+                                            const T *arr2, const int start2, const int length2,
+                                            const int diagonal)
+{
+   int lo = diagonal > length2 ? diagonal - length2 : 0 ;
+   int hi = diagonal < length1 ? diagonal : length1 ;
+
+   while (lo < hi) {
+      const int mid = lo + ((hi - lo) >> 1) ;
+
+      if (arr1[start1 + mid] <= arr2[start2 + diagonal - mid - 1]) {
+         lo = mid + 1 ;
+      }
+      else {
+         hi = mid ;
+      }
    }
-   return newLen;
-}
 
-#endif //RAJA_PARALLEL_ACTIVE
+   return lo ;
+}
 
 /************************************************************************
- * Function  : uniqArray
- * Author(s) : Peter Robinson
- * Purpose   : CPU version of uniqArray.
-  ************************************************************************/
+ * Function  : MergePathIntersect
+ * Purpose   : Intersects the slice [diagonal, nextDiagonal) of the merge
+ *             path of two sorted, unique subarrays (see MergePathSearch).
+ *             A match belongs to the slice in which its element from the
+ *             first array is merged, so every match is found by exactly
+ *             one slice. If matches1 and matches2 are not null, the match
+ *             positions (relative to start1 and start2) are written to them
+ *             starting at offset.
+ *             Returns the number of matches in the slice.
+ ************************************************************************/
 template <typename T>
-inline void uniqArray(RAJA::seq_exec, care::host_device_ptr<T> Array, size_t len, care::host_device_ptr<T> & outArray, int & newLen) {
-   CHAIDataGetter<T, RAJA::seq_exec> getter {};
-   T * rawData = getter.getRawArrayData(Array);
-   newLen = 0 ;
-   care::host_ptr<T> arrout = nullptr ;
-   outArray = nullptr;
+CARE_HOST_DEVICE inline int MergePathIntersect(const T *arr1, const int start1, const int length1,
+                                               const T *arr2, const int start2, const int length2,
+                                               const int diagonal, const int nextDiagonal,
+                                               int *matches1, int *matches2, const int offset)
+{
+   int i = MergePathSearch(arr1, start1, length1, arr2, start2, length2, diagonal) ;
+   int j = diagonal - i ;
+   int count = 0 ;
 
-   if (len != 0) {
-      size_t i=0  ;
+   while (i + j < nextDiagonal && i < length1 && j < length2) {
+      const T value1 = arr1[start1 + i] ;
+      const T value2 = arr2[start2 + j] ;
 
-      /* alloc some space, we realloc later */
-      outArray = care::host_device_ptr<T>(len,"uniq_outArray");
-      arrout = outArray;
+      if (value1 < value2) {
+         ++i ;
+      }
+      else if (value2 < value1) {
+         ++j ;
+      }
+      else {
+         if (matches1 != nullptr) {
+            matches1[offset + count] = i ;
+            matches2[offset + count] = j ;
+         }
 
-      while (i < len) {
-         /* copy the unique value into the array */
-         arrout[newLen] = rawData[i] ;
+         ++count ;
+         ++i ;
+         ++j ;
+      }
+   }
 
-         /* skip over all the redundant elements */
-         while ((i<len) && (rawData[i] == arrout[newLen])) {
-            i++ ;
+   return count ;
+}
+
+/************************************************************************
+ * Function  : MergePathSetOperation<T,KeepFirstOnly,KeepSecondOnly,KeepBoth>
+ * Purpose   : Walks the slice [diagonal, nextDiagonal) of the merge path of
+ *             two sorted, unique subarrays (see MergePathSearch) and
+ *             classifies each value as present only in the first subarray,
+ *             only in the second, or in both. The template flags choose which
+ *             of these are kept, which gives union, difference and symmetric
+ *             difference. If values is not null, the kept values are written
+ *             to it starting at offset. If indices is not null, the positions
+ *             (relative to start1) of kept values that came from the first
+ *             subarray are written to it starting at offset.
+ *             Returns the number of kept values in the slice.
+ * Note      : A value present in both subarrays belongs to the slice in which
+ *             its element from the first subarray is merged. If the matching
+ *             element of the second subarray falls at the start of the next
+ *             slice, that slice skips it.
+ ************************************************************************/
+template <typename T, bool KeepFirstOnly, bool KeepSecondOnly, bool KeepBoth>
+CARE_HOST_DEVICE inline int MergePathSetOperation(const T *arr1, const int start1, const int length1,
+                                                  const T *arr2, const int start2, const int length2,
+                                                  const int diagonal, const int nextDiagonal,
+                                                  T *values, int *indices, const int offset)
+{
+   int i = MergePathSearch(arr1, start1, length1, arr2, start2, length2, diagonal) ;
+   int j = diagonal - i ;
+   int count = 0 ;
+
+   if (i > 0 && j < length2 && arr2[start2 + j] == arr1[start1 + i - 1]) {
+      ++j ;
+   }
+
+   while (i + j < nextDiagonal && (i < length1 || j < length2)) {
+      if (j >= length2 || (i < length1 && arr1[start1 + i] < arr2[start2 + j])) {
+         if (KeepFirstOnly) {
+            if (values != nullptr) {
+               values[offset + count] = arr1[start1 + i] ;
+            }
+
+            if (indices != nullptr) {
+               indices[offset + count] = i ;
+            }
+
+            ++count ;
          }
 
-         ++newLen;
+         ++i ;
+      }
+      else if (i >= length1 || arr2[start2 + j] < arr1[start1 + i]) {
+         if (KeepSecondOnly) {
+            if (values != nullptr) {
+               values[offset + count] = arr2[start2 + j] ;
+            }
+
+            ++count ;
+         }
+
+         ++j ;
+      }
+      else {
+         if (KeepBoth) {
+            if (values != nullptr) {
+               values[offset + count] = arr1[start1 + i] ;
+            }
+
+            if (indices != nullptr) {
+               indices[offset + count] = i ;
+            }
+
+            ++count ;
+         }
+
+         ++i ;
+         ++j ;
       }
-      outArray.realloc(newLen);
    }
-   return;
+
+   return count ;
 }
 
 /************************************************************************
- * Function  : uniqArray
- * Author(s) : Peter Robinson
- * Purpose   : CPU version of uniqArray, with in-place semantics. Set noCopy to true
- *             if you don't care about data left at the end of the array after the uniq.
-  ************************************************************************/
+ * Function  : MergePathMerge
+ * Purpose   : Merges the slice [diagonal, nextDiagonal) of the merge path of
+ *             two sorted subarrays (see MergePathSearch) into merged. Since
+ *             every element is kept, the output position of each element is
+ *             its diagonal on the merge path, so slices can be written
+ *             independently. Ties are taken from the first subarray first.
+ *             If positions1 and positions2 are not null, the output position
+ *             of each element is written to them (indexed relative to start1
+ *             and start2).
+ ************************************************************************/
 template <typename T>
-inline int uniqArray(RAJA::seq_exec exec, care::host_device_ptr<T> & Array, size_t len, bool noCopy=false) {
-   int newLength = 0;
-   if (len > 0) {
-      care::host_device_ptr<T> tmp;
-      uniqArray(exec, Array, len, tmp, newLength);
-      if (noCopy) {
-         Array.free();
-         Array = tmp;
+CARE_HOST_DEVICE inline void MergePathMerge(const T *arr1, const int start1, const int length1,
+                                            const T *arr2, const int start2, const int length2,
+                                            const int diagonal, const int nextDiagonal,
+                                            T *merged, int *positions1, int *positions2)
+{
+   int i = MergePathSearch(arr1, start1, length1, arr2, start2, length2, diagonal) ;
+   int j = diagonal - i ;
+
+   for (int k = diagonal ; k < nextDiagonal ; ++k) {
+      if (j >= length2 || (i < length1 && arr1[start1 + i] <= arr2[start2 + j])) {
+         merged[k] = arr1[start1 + i] ;
+
+         if (positions1 != nullptr) {
+            positions1[i] = k ;
+         }
+
+         ++i ;
       }
       else {
-         ArrayCopy<T>(RAJA::seq_exec {}, Array, tmp, newLength);
-         tmp.free();
+         merged[k] = arr2[start2 + j] ;
+
+         if (positions2 != nullptr) {
+            positions2[j] = k ;
+         }
+
+         ++j ;
       }
    }
-   return newLength;
 }
 
-#ifdef RAJA_GPU_ACTIVE
-template <typename T, typename Exec>
-inline void sortArray(Exec, care::host_device_ptr<T> &Array, size_t len, int start, bool noCopy)
-{
-   printf("%s:%s","sortArray(Exec, care::host_device_ptr, len, start, noCopy)", "unspecialized version should not be called");
-}
+#ifdef RAJA_PARALLEL_ACTIVE
+/************************************************************************
+ * Function  : SetOperationArrays<A,KeepFirstOnly,KeepSecondOnly,KeepBoth,RAJAExec>
+ * Purpose   : Parallel driver for the sorted set operations. Splits the merge
+ *             path of arr1[start1, size1) and arr2[start2, size2) into equal
+ *             slices, counts the kept values of each slice, scans the counts
+ *             and then writes each slice at its offset. values and/or indices
+ *             are allocated to the number of kept values if they are
+ *             requested, and are set to nullptr if nothing was kept.
+ ************************************************************************/
+template <typename ArrayType, bool KeepFirstOnly, bool KeepSecondOnly, bool KeepBoth>
+inline void SetOperationArrays(RAJAExec,
+                               care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                               care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                               bool computeValues, care::host_device_ptr<ArrayType> &values,
+                               bool computeIndices, care::host_device_ptr<int> &indices,
+                               int *resultSize) {
+   *resultSize = 0 ;
+   const int length1 = size1 > start1 ? size1 - start1 : 0 ;
+   const int length2 = size2 > start2 ? size2 - start2 : 0 ;
+   const int total = length1 + length2 ;
 
-template <typename T, typename Exec>
-inline void sortArray(Exec, care::host_device_ptr<T> &Array, size_t len)
-{
-   printf("%s:%s","sortArray(Exec, care::host_device_ptr, len)", "unspecialized version should not be called");
-}
+   if (computeValues) {
+      values = nullptr ;
+   }
 
-template <typename T>
-inline void radixSortArray(care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy);
+   if (computeIndices) {
+      indices = nullptr ;
+   }
 
-/************************************************************************
- * Function  : sortArray
- * Author(s) : Peter Robinson
- * Purpose   : GPU version of sortArray. Defaults to thrust::sort, but
- *             specialized to cub::DeviceRadix sort for data types that
- *             cub supports.
-  ************************************************************************/
-template <typename T>
-inline void sortArray(RAJAExec, care::host_device_ptr<T> &Array, size_t len, int start, bool noCopy) ;
+   if (total == 0) {
+      return ;
+   }
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<int> & Array, size_t len, int start, bool noCopy) {
-   radixSortArray(Array, len, start, noCopy);
-}
+   /* number of merge steps handled sequentially by each iteration */
+   const int itemsPerPartition = 64 ;
+   const int numPartitions = (total + itemsPerPartition - 1) / itemsPerPartition ;
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<float> & Array, size_t len, int start, bool noCopy) {
-   radixSortArray(Array, len, start, noCopy);
-}
+   care::host_device_ptr<int> counts(numPartitions + 1, "SetOperationArrays counts");
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<double> & Array, size_t len, int start, bool noCopy) {
-   radixSortArray(Array, len, start, noCopy);
-}
+   LOOP_STREAM(p, 0, numPartitions + 1) {
+      if (p == numPartitions) {
+         counts[p] = 0 ;
+      }
+      else {
+         const int diagonal = p * itemsPerPartition ;
+         const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+         counts[p] = MergePathSetOperation<ArrayType, KeepFirstOnly, KeepSecondOnly, KeepBoth>(
+                        arr1, start1, length1, arr2, start2, length2,
+                        diagonal, nextDiagonal, nullptr, nullptr, 0) ;
+      }
+   } LOOP_STREAM_END
 
-#if CARE_HAVE_LLNL_GLOBALID
+   exclusive_scan<int, RAJAExec>(counts, nullptr, numPartitions + 1, RAJA::operators::plus<int>{}, 0, true);
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<globalID> & Array, size_t len, int start, bool noCopy) {
-   radixSortArray(Array, len, start, noCopy);
-}
+   *resultSize = counts.pick(numPartitions);
 
-#endif // CARE_HAVE_LLNL_GLOBALID
+   if (*resultSize > 0) {
+      care::host_device_ptr<ArrayType> outValues = nullptr ;
+      care::host_device_ptr<int> outIndices = nullptr ;
 
-// This must be explicitly specialized for NVCC to link to the correct version.
-template <typename T>
-inline void sortArray(RAJAExec, care::host_device_ptr<T> &Array, size_t len);
+      if (computeValues) {
+         outValues = care::host_device_ptr<ArrayType>(*resultSize, "SetOperationArrays values");
+      }
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<int> & Array, size_t len) {
-   radixSortArray(Array, len, 0, false);
-}
+      if (computeIndices) {
+         outIndices = care::host_device_ptr<int>(*resultSize, "SetOperationArrays indices");
+      }
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<float> & Array, size_t len) {
-   radixSortArray(Array, len, 0, false);
-}
+      LOOP_STREAM(p, 0, numPartitions) {
+         const int diagonal = p * itemsPerPartition ;
+         const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+         MergePathSetOperation<ArrayType, KeepFirstOnly, KeepSecondOnly, KeepBoth>(
+            arr1, start1, length1, arr2, start2, length2,
+            diagonal, nextDiagonal, outValues, outIndices, counts[p]) ;
+      } LOOP_STREAM_END
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<double> & Array, size_t len) {
-   radixSortArray(Array, len, 0, false);
-}
+      if (computeValues) {
+         values = outValues ;
+      }
 
-#if CARE_HAVE_LLNL_GLOBALID
+      if (computeIndices) {
+         indices = outIndices ;
+      }
+   }
 
-template <>
-inline void sortArray(RAJAExec, care::host_device_ptr<globalID> & Array, size_t len) {
-   radixSortArray(Array, len, 0, false);
+   counts.free();
 }
-
-#endif // CARE_HAVE_LLNL_GLOBALID
+#endif // RAJA_PARALLEL_ACTIVE
 
 /************************************************************************
- * Function  : radixSortArray
- * Author(s) : Peter Robinson
- * Purpose   : ManagedArray API to cub::DeviceRadixSort::SortKeys.
-  ************************************************************************/
-template <typename T>
-inline void radixSortArray(care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy) {
-   CHAIDataGetter<T, RAJAExec> getter {};
-   CHAIDataGetter<char, RAJAExec> charGetter {};
-   care::host_device_ptr<T> result(len,"radix_sort_result");
-   auto * rawData = getter.getRawArrayData(Array) + start;
-   auto * rawResult = getter.getRawArrayData(result);
-   // get the temp storage length
-   char * d_temp_storage = nullptr;
-   size_t temp_storage_bytes = 0;
-   if (len > 0) {
-#if defined(__CUDACC__)
-      cub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
-#elif defined(__HIPCC__)
-      hipcub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
-#endif   
+ * Function  : SetOperationArrays<A,KeepFirstOnly,KeepSecondOnly,KeepBoth,RAJA::seq_exec>
+ * Purpose   : Sequential driver for the sorted set operations. Walks the
+ *             whole merge path once into storage of the largest possible
+ *             size, then shrinks the outputs to the number of kept values.
+ ************************************************************************/
+template <typename ArrayType, bool KeepFirstOnly, bool KeepSecondOnly, bool KeepBoth>
+inline void SetOperationArrays(RAJA::seq_exec,
+                               care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                               care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                               bool computeValues, care::host_device_ptr<ArrayType> &values,
+                               bool computeIndices, care::host_device_ptr<int> &indices,
+                               int *resultSize) {
+   *resultSize = 0 ;
+   const int length1 = size1 > start1 ? size1 - start1 : 0 ;
+   const int length2 = size2 > start2 ? size2 - start2 : 0 ;
+   const int total = length1 + length2 ;
+
+   if (computeValues) {
+      values = nullptr ;
    }
-   // allocate the temp storage
 
-   care::host_device_ptr<char> tmpManaged(temp_storage_bytes, "radix_sort_tmpManaged");
-   d_temp_storage = charGetter.getRawArrayData(tmpManaged);
+   if (computeIndices) {
+      indices = nullptr ;
+   }
 
-   // do the sort
-   if (len > 0) {
-#if defined(__CUDACC__)
-      cub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
-#elif defined(__HIPCC__)
-      hipcub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
-#endif   
+   if (total == 0) {
+      return ;
    }
-   // cleanup
-   if (noCopy) {
-      if (len > 0) {
-         Array.free();
+
+   care::host_device_ptr<ArrayType> outValues = nullptr ;
+   care::host_device_ptr<int> outIndices = nullptr ;
+
+   if (computeValues) {
+      outValues = care::host_device_ptr<ArrayType>(total, "SetOperationArrays values");
+   }
+
+   if (computeIndices) {
+      outIndices = care::host_device_ptr<int>(total, "SetOperationArrays indices");
+   }
+
+   care::host_ptr<const ArrayType> host1 = length1 > 0 ? care::host_ptr<const ArrayType>(arr1) : care::host_ptr<const ArrayType>(nullptr) ;
+   care::host_ptr<const ArrayType> host2 = length2 > 0 ? care::host_ptr<const ArrayType>(arr2) : care::host_ptr<const ArrayType>(nullptr) ;
+   care::host_ptr<ArrayType> hostValues = computeValues ? care::host_ptr<ArrayType>(outValues) : care::host_ptr<ArrayType>(nullptr) ;
+   care::host_ptr<int> hostIndices = computeIndices ? care::host_ptr<int>(outIndices) : care::host_ptr<int>(nullptr) ;
+
+   *resultSize = MergePathSetOperation<ArrayType, KeepFirstOnly, KeepSecondOnly, KeepBoth>(
+                    host1, start1, length1, host2, start2, length2,
+                    0, total, hostValues, hostIndices, 0) ;
+
+   if (*resultSize == 0) {
+      if (outValues) {
+         outValues.free();
+      }
+
+      if (outIndices) {
+         outIndices.free();
       }
-      Array = result;
    }
    else {
-      ArrayCopy<T>(Array, result, len, start, 0);
-      if (len > 0) {
-         result.free();
+      if (computeValues) {
+         outValues.realloc(*resultSize);
+         values = outValues ;
+      }
+
+      if (computeIndices) {
+         outIndices.realloc(*resultSize);
+         indices = outIndices ;
       }
-   }
-   if (len > 0) {
-      tmpManaged.free();
    }
 }
-#endif // RAJA_GPU_ACTIVE
 
 /************************************************************************
- * Function  : sortArray
- * Author(s) : Peter Robinson
- * Purpose   : CPU version of sortArray. Calls std::sort
-  ************************************************************************/
-template <typename T>
-inline void sortArray(RAJA::seq_exec, care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy) {
-   CHAIDataGetter<T, RAJA::seq_exec> getter {};
-   T * rawData = getter.getRawArrayData(Array)+start;
-   std::sort(rawData, rawData+len);
-   noCopy = noCopy ;
+ * Function  : UnionArrays<A,Exec>
+ * Purpose   : Given two arrays of unique elements of type A sorted in ascending
+ *             order, returns the sorted, unique values present in either array.
+ *             Only arr1[start1, size1) and arr2[start2, size2) are considered.
+ *             result is allocated by this routine (nullptr if empty).
+ ************************************************************************/
+template <typename ArrayType, typename Exec>
+inline void UnionArrays(Exec exec,
+                        care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                        care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                        care::host_device_ptr<ArrayType> &result, int *resultSize) {
+   care::host_device_ptr<int> noIndices = nullptr ;
+   SetOperationArrays<ArrayType, true, true, true>(exec,
+                                                   arr1, size1, start1,
+                                                   arr2, size2, start2,
+                                                   true, result, false, noIndices,
+                                                   resultSize);
 }
 
-template <typename T>
-inline void sortArray(RAJA::seq_exec, care::host_device_ptr<T> &Array, size_t len)
-{
-   CHAIDataGetter<T, RAJA::seq_exec> getter {};
-   T * rawData = getter.getRawArrayData(Array);
-   std::sort(rawData, rawData+len);
+/************************************************************************
+ * Function  : DifferenceArrays<A,Exec>
+ * Purpose   : Given two arrays of unique elements of type A sorted in ascending
+ *             order, returns the elements of arr1 that are not in arr2. result
+ *             holds their values, and indices holds their positions in arr1,
+ *             given as offsets from start1 as in IntersectArrays.
+ *             Only arr1[start1, size1) and arr2[start2, size2) are considered.
+ *             result and indices are allocated by this routine (nullptr if empty).
+ ************************************************************************/
+template <typename ArrayType, typename Exec>
+inline void DifferenceArrays(Exec exec,
+                             care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                             care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                             care::host_device_ptr<ArrayType> &result,
+                             care::host_device_ptr<int> &indices, int *resultSize) {
+   SetOperationArrays<ArrayType, true, false, false>(exec,
+                                                     arr1, size1, start1,
+                                                     arr2, size2, start2,
+                                                     true, result, true, indices,
+                                                     resultSize);
 }
 
 /************************************************************************
-* Function  : sort_uniq(<T>_ptr)
-* Author(s) : Peter Robinson
-* Purpose   : Sorts and uniques an array.
-**************************************************************************/
-template <typename T, typename Exec>
-inline void sort_uniq(Exec e, care::host_device_ptr<T> * array, int * len, bool noCopy = false) {
-   if ((*len) == 0) {
-      if ((*array) != nullptr) {
-         array->free();
-         *array = nullptr;
-      }
-      return  ;
-   }
-   /* first sort the array */
-   sortArray<T>(e, *array, *len, 0, noCopy);
-   /* then unique it */
-   *len = uniqArray<T>(e, *array, *len, noCopy);
+ * Function  : SymmetricDifferenceArrays<A,Exec>
+ * Purpose   : Given two arrays of unique elements of type A sorted in ascending
+ *             order, returns the sorted values present in exactly one of them.
+ *             Only arr1[start1, size1) and arr2[start2, size2) are considered.
+ *             result is allocated by this routine (nullptr if empty).
+ ************************************************************************/
+template <typename ArrayType, typename Exec>
+inline void SymmetricDifferenceArrays(Exec exec,
+                                      care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                                      care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                                      care::host_device_ptr<ArrayType> &result, int *resultSize) {
+   care::host_device_ptr<int> noIndices = nullptr ;
+   SetOperationArrays<ArrayType, true, true, false>(exec,
+                                                    arr1, size1, start1,
+                                                    arr2, size2, start2,
+                                                    true, result, false, noIndices,
+                                                    resultSize);
 }
 
-/************************************************************************
-* Function  : CompressArray<T>
-* Author(s) : Peter Robinson
-* Purpose   : Removes items at indices defined in removed from arr.
-*           : Thread safe version of CompressArray.
-*           : Note that thread safe version only requires removed to be sorted.
-*           : Note also that it's a error if any index in removed is
-*           : not found (beyond the end of arr).
-**************************************************************************/
 #ifdef RAJA_PARALLEL_ACTIVE
-template <typename T>
-inline void CompressArray(RAJAExec exec, care::host_device_ptr<T> & arr, const int arrLen,
-                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
-   //GPU VERSION
-   care::host_device_ptr<T> tmp(arrLen-removedLen, "CompressArray_tmp");
-   int numKept = 0;
-   SCAN_LOOP(i, 0, arrLen, pos, numKept,
-             -1 == BinarySearch<int>(removed, 0, removedLen, i)) {
-      tmp[pos] = arr[i];
-   } SCAN_LOOP_END(arrLen, pos, numKept)
-
-#ifdef CARE_DEBUG
-   int numRemoved = arrLen - numKept;
-   if (removedLen != numRemoved) {
-      printf("Warning in CompressArray<T>: did not remove expected number of members!\n");
+/************************************************************************
+ * Function  : MergeArrays<A,RAJAExec>
+ * Purpose   : Given two arrays of type A sorted in ascending order (duplicates
+ *             allowed), returns their sorted merge. Ties are taken from arr1
+ *             first. If positions1 and positions2 are requested, they hold the
+ *             position in result of every element of arr1[start1, size1) and
+ *             arr2[start2, size2), which can be used to merge associated data.
+ *             This is the parallel overload of this method: the merge path is
+ *             split into equal slices that are merged independently.
+ *             result and the positions are allocated by this routine.
+ ************************************************************************/
+template <typename ArrayType>
+inline void MergeArrays(RAJAExec,
+                        care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                        care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                        care::host_device_ptr<ArrayType> &result,
+                        bool computePositions,
+                        care::host_device_ptr<int> &positions1, care::host_device_ptr<int> &positions2,
+                        int *resultSize) {
+   const int length1 = size1 > start1 ? size1 - start1 : 0 ;
+   const int length2 = size2 > start2 ? size2 - start2 : 0 ;
+   const int total = length1 + length2 ;
+
+   *resultSize = total ;
+   result = nullptr ;
+
+   if (computePositions) {
+      positions1 = nullptr ;
+      positions2 = nullptr ;
+   }
+
+   if (total == 0) {
+      return ;
    }
-#endif
-   if (noCopy) {
-      arr.free();
-      arr = tmp;
+
+   care::host_device_ptr<ArrayType> merged(total, "MergeArrays result");
+   care::host_device_ptr<int> mergedPositions1 = nullptr ;
+   care::host_device_ptr<int> mergedPositions2 = nullptr ;
+
+   if (computePositions) {
+      if (length1 > 0) {
+         mergedPositions1 = care::host_device_ptr<int>(length1, "MergeArrays positions1");
+      }
+
+      if (length2 > 0) {
+         mergedPositions2 = care::host_device_ptr<int>(length2, "MergeArrays positions2");
+      }
    }
-   else {
-      ArrayCopy<T>(exec, arr, tmp, numKept);
-      tmp.free();
+
+   /* number of merge steps handled sequentially by each iteration */
+   const int itemsPerPartition = 64 ;
+   const int numPartitions = (total + itemsPerPartition - 1) / itemsPerPartition ;
+
+   LOOP_STREAM(p, 0, numPartitions) {
+      const int diagonal = p * itemsPerPartition ;
+      const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+      MergePathMerge<ArrayType>(arr1, start1, length1, arr2, start2, length2,
+                                diagonal, nextDiagonal,
+                                merged, mergedPositions1, mergedPositions2) ;
+   } LOOP_STREAM_END
+
+   result = merged ;
+
+   if (computePositions) {
+      positions1 = mergedPositions1 ;
+      positions2 = mergedPositions2 ;
    }
 }
-
 #endif // RAJA_PARALLEL_ACTIVE
 
 /************************************************************************
-* Function  : CompressArray<T>
-* Author(s) : Peter Robinson
-* Purpose   : Removes items at indices defined in removed from arr.
-*             Sequential Version of CompressArray
-*             Requires both arr and removed to be sorted.
-*             Note that it's a error if any index in removed is
-*             not found (beyond the end of arr).
-**************************************************************************/
-template <typename T>
-inline void CompressArray(RAJA::seq_exec, care::host_device_ptr<T> & arr, const int arrLen,
-                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
-   // CPU VERSION
-
-   int readLoc;
-   int writeLoc = 0, numRemoved = 0;
-   care::host_ptr<int const> removedHost = removed ;
-   care::host_ptr<T> arrHost = arr ;
-#ifdef CARE_DEBUG
-   if (removedHost[removedLen-1] > arrLen-1) {
-      printf("Warning in CompressArray<T> seq_exec: asking to remove entries not in array!\n");
+ * Function  : MergeArrays<A,RAJA::seq_exec>
+ * Purpose   : Given two arrays of type A sorted in ascending order (duplicates
+ *             allowed), returns their sorted merge. Ties are taken from arr1
+ *             first. If positions1 and positions2 are requested, they hold the
+ *             position in result of every element of arr1[start1, size1) and
+ *             arr2[start2, size2), which can be used to merge associated data.
+ *             This is the sequential overload of this method.
+ *             result and the positions are allocated by this routine.
+ ************************************************************************/
+template <typename ArrayType>
+inline void MergeArrays(RAJA::seq_exec,
+                        care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                        care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                        care::host_device_ptr<ArrayType> &result,
+                        bool computePositions,
+                        care::host_device_ptr<int> &positions1, care::host_device_ptr<int> &positions2,
+                        int *resultSize) {
+   const int length1 = size1 > start1 ? size1 - start1 : 0 ;
+   const int length2 = size2 > start2 ? size2 - start2 : 0 ;
+   const int total = length1 + length2 ;
+
+   *resultSize = total ;
+   result = nullptr ;
+
+   if (computePositions) {
+      positions1 = nullptr ;
+      positions2 = nullptr ;
+   }
+
+   if (total == 0) {
+      return ;
    }
-#endif
-   for (readLoc = 0; readLoc < arrLen; ++readLoc) {
-      if ((numRemoved == removedLen) || (readLoc < removedHost[numRemoved])) {
-         arrHost[writeLoc++] = arrHost[readLoc];
-      }
-      else if (readLoc == removedHost[numRemoved]) {
-         ++numRemoved;
+
+   result = care::host_device_ptr<ArrayType>(total, "MergeArrays result");
+
+   if (computePositions) {
+      if (length1 > 0) {
+         positions1 = care::host_device_ptr<int>(length1, "MergeArrays positions1");
       }
-#ifdef CARE_DEBUG
-      else {
-         printf("Warning in CompressArray<int> seq_exec: list of removed members not sorted!\n");
+
+      if (length2 > 0) {
+         positions2 = care::host_device_ptr<int>(length2, "MergeArrays positions2");
       }
-#endif
-   }
-#ifdef CARE_DEBUG
-   if ((removedLen != numRemoved) || (writeLoc != arrLen - removedLen)) {
-      printf("CompressArray<T> seq_exec: did not remove expected number of members!\n");
    }
-#endif
-   noCopy = noCopy;
+
+   care::host_ptr<const ArrayType> host1 = length1 > 0 ? care::host_ptr<const ArrayType>(arr1) : care::host_ptr<const ArrayType>(nullptr) ;
+   care::host_ptr<const ArrayType> host2 = length2 > 0 ? care::host_ptr<const ArrayType>(arr2) : care::host_ptr<const ArrayType>(nullptr) ;
+   care::host_ptr<int> hostPositions1 = positions1 ? care::host_ptr<int>(positions1) : care::host_ptr<int>(nullptr) ;
+   care::host_ptr<int> hostPositions2 = positions2 ? care::host_ptr<int>(positions2) : care::host_ptr<int>(nullptr) ;
+
+   MergePathMerge<ArrayType>(host1, start1, length1, host2, start2, length2,
+                             0, total, care::host_ptr<ArrayType>(result),
+                             computePositions ? (int *) hostPositions1 : nullptr,
+                             computePositions ? (int *) hostPositions2 : nullptr) ;
 }
 
-template <typename T>
-inline void CompressArray(care::host_device_ptr<T> & arr, const int arrLen,
-                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
-   return CompressArray(RAJAExec(), arr, arrLen, removed, removedLen, noCopy);
+/************************************************************************
+ * Function  : MergeArrays<A,Exec>
+ * Purpose   : Overload of MergeArrays that does not compute the positions.
+ ************************************************************************/
+template <typename ArrayType, typename Exec>
+inline void MergeArrays(Exec exec,
+                        care::host_device_ptr<const ArrayType> arr1, int size1, int start1,
+                        care::host_device_ptr<const ArrayType> arr2, int size2, int start2,
+                        care::host_device_ptr<ArrayType> &result, int *resultSize) {
+   care::host_device_ptr<int> noPositions1 = nullptr ;
+   care::host_device_ptr<int> noPositions2 = nullptr ;
+   MergeArrays<ArrayType>(exec,
+                          arr1, size1, start1,
+                          arr2, size2, start2,
+                          result, false, noPositions1, noPositions2,
+                          resultSize);
 }
 
+#ifdef RAJA_PARALLEL_ACTIVE
+/************************************************************************
+* Function  : AcquireScratch<T>
+* Purpose   : Returns scratch for at least length values of type T, from
+*           : the calling thread's care::ScratchWorkspace, so repeated
+*           : calls do not allocate. Must be given back with ReleaseScratch.
+**************************************************************************/
 template <typename T>
-inline void ExpandArrayInPlace(RAJA::seq_exec, care::host_device_ptr<T> array, care::host_device_ptr<int const> indexSet, int length)
-{
-   if (length > 0) {
-      care::host_ptr<int const> host_indexSet = indexSet ;
-      care::host_ptr<T> host_array =array;
-      for (int i = length-1; i >= 0; --i) {
-         int idx = host_indexSet[i] ;
-         host_array[idx] = host_array[i] ;
-      }
-   }
+inline care::host_device_ptr<T> AcquireScratch(const size_t length) {
+   chai::ManagedArray<char> bytes =
+      care::ScratchWorkspace::get(CHAIDataGetter<char, RAJAExec>::ChaiPolicy).acquire(length * sizeof(T));
+   return reinterpret_cast<care::host_device_ptr<T> &>(bytes);
 }
 
-#ifdef RAJA_PARALLEL_ACTIVE
+/************************************************************************
+* Function  : ReleaseScratch<T>
+* Purpose   : Gives back scratch returned by AcquireScratch.
+**************************************************************************/
 template <typename T>
-inline void ExpandArrayInPlace(RAJAExec, care::host_device_ptr<T> array, care::host_device_ptr<int const> indexSet, int length)
-{
-   if (length > 0) {
-      care::host_device_ptr<T> array_copy(length, "ExpandArrayInPlace array_copy");
-      ArrayCopy<double>(array_copy, array, length);
-      LOOP_STREAM(i, 0, length) {
-         int nL = indexSet[i] ;
-         array[nL] = array_copy[i] ;
-      } LOOP_STREAM_END
-      array_copy.free();
-   }
+inline void ReleaseScratch(care::host_device_ptr<T> scratch) {
+   care::ScratchWorkspace::get(CHAIDataGetter<char, RAJAExec>::ChaiPolicy).release(
+      reinterpret_cast<chai::ManagedArray<char> &>(scratch));
 }
 
+/************************************************************************
+ * Function  : uniqFlags
+ * Author(s) : Peter Robinson
+ * Purpose   : First half of the parallel uniqArray. Evaluates the uniq
+ *             predicate once per element, packing the results of each run
+ *             of 64 elements into one word of flags, and leaves the exclusive
+ *             scan of the per-word counts in counts (numWords + 1 entries).
+ *             Returns the number of unique values.
+ *             On the device each thread evaluates one element, so that
+ *             neighbouring threads read neighbouring elements, and the
+ *             bits are combined into their words with atomics. On the host
+ *             each thread evaluates the 64 contiguous elements of a word.
+  ************************************************************************/
+template <typename T>
+inline int uniqFlags(care::host_device_ptr<const T> Array, int len,
+                     care::host_device_ptr<unsigned long long> flags,
+                     care::host_device_ptr<int> counts) {
+   const int numWords = (len + 63) / 64 ;
+
+#if defined(__GPUCC__)
+   LOOP_STREAM(w, 0, numWords) {
+      flags[w] = 0ull ;
+   } LOOP_STREAM_END
+
+   LOOP_STREAM(i, 0, len) {
+      if ((i == len-1) || (Array[i] < Array[i+1] || Array[i+1] < Array[i])) {
+         ATOMIC_OR(flags[i >> 6], 1ull << (i & 63)) ;
+      }
+   } LOOP_STREAM_END
+
+   LOOP_STREAM(w, 0, numWords + 1) {
+      counts[w] = w == numWords ? 0 : care::popCount(flags[w]) ;
+   } LOOP_STREAM_END
+#else
+   LOOP_STREAM(w, 0, numWords + 1) {
+      if (w == numWords) {
+         counts[w] = 0 ;
+      }
+      else {
+         const int first = w * 64 ;
+         const int last = first + 64 < len ? first + 64 : len ;
+         unsigned long long word = 0 ;
+
+         for (int i = first ; i < last ; ++i) {
+            if ((i == len-1) || (Array[i] < Array[i+1] || Array[i+1] < Array[i])) {
+               word |= 1ull << (i - first) ;
+            }
+         }
+
+         flags[w] = word ;
+         counts[w] = care::popCount(word) ;
+      }
+   } LOOP_STREAM_END
 #endif
 
+   exclusive_scan<int, RAJAExec>(counts, nullptr, numWords + 1, RAJA::operators::plus<int>{}, 0, true);
+
+   return counts.pick(numWords) ;
+}
 
 /************************************************************************
- * Function  : ArrayFill
- * Author(s) : Peter Robinson
- * Purpose   : Fills a ManagedArray with the value given.
- * ************************************************************************/
-template <typename T, typename Exec>
-inline void ArrayFill(care::host_device_ptr<T> arr, int n, T val) {
-   LOOP_STREAM(i, 0, n) {
-      arr[i] = val;
+ * Function  : ScatterFlagged
+ * Purpose   : Copies the values of Array whose bits are set in flags (one
+ *             64 bit word per 64 elements) to outArray, starting each word at
+ *             its exclusive scanned count. Shared by uniqArray and
+ *             CompressArray so predicates are evaluated only once.
+ *             On the device each thread copies one element, placed by the
+ *             bits set below it in its word, so accesses are coalesced.
+  ************************************************************************/
+template <typename T>
+inline void ScatterFlagged(care::host_device_ptr<const T> Array, int len,
+                        care::host_device_ptr<unsigned long long const> flags,
+                        care::host_device_ptr<int const> counts,
+                        care::host_device_ptr<T> outArray) {
+#if defined(__GPUCC__)
+   LOOP_STREAM(i, 0, len) {
+      const unsigned long long word = flags[i >> 6] ;
+      const int bit = i & 63 ;
+
+      if ((word >> bit) & 1ull) {
+         outArray[counts[i >> 6] + care::popCount(word & ((1ull << bit) - 1ull))] = Array[i] ;
+      }
+   } LOOP_STREAM_END
+#else
+   const int numWords = (len + 63) / 64 ;
+
+   LOOP_STREAM(w, 0, numWords) {
+      const int first = w * 64 ;
+      const unsigned long long word = flags[w] ;
+      int position = counts[w] ;
+
+      for (int bit = 0 ; bit < 64 ; ++bit) {
+         if ((word >> bit) & 1ull) {
+            outArray[position++] = Array[first + bit] ;
+         }
+      }
    } LOOP_STREAM_END
+#endif
 }
 
+/************************************************************************
+ * Function  : uniqArray
+ * Author(s) : Peter Robinson
+ * Purpose   : GPU version of uniqArray. The predicate is evaluated once per
+ *             element into 64 bit flag words, the per-word counts are scanned
+ *             (one entry per 64 elements instead of per element), and the
+ *             flagged values are scattered.
+  ************************************************************************/
 template <typename T>
-void ArrayFill(care::host_ptr<T> arr, int n, T val)  {
-   for (int i = 0; i < n; ++i) {
-      arr[i] = val;
-   }
+inline void uniqArray(RAJAExec, care::host_device_ptr<T>  Array, size_t len, care::host_device_ptr<T> & outArray, int & outLen, bool noCopy=false) {
+   const int length = (int) len ;
+   const int numWords = (length + 63) / 64 ;
+   care::host_device_ptr<unsigned long long> flags(numWords > 0 ? numWords : 1, "uniqArray flags");
+   care::host_device_ptr<int> counts(numWords + 1, "uniqArray counts");
+
+   int numUniq = uniqFlags<T>(Array, length, flags, counts);
+   outArray.alloc(numUniq);
+   ScatterFlagged<T>(Array, length, flags, counts, outArray);
+
+   flags.free();
+   counts.free();
+   outLen = numUniq;
+   return;
 }
 
 /************************************************************************
- * Function  : ArrayMin
+ * Function  : uniqArray
  * Author(s) : Peter Robinson
- * Purpose   : Returns the minimum value in a ManagedArray
- * ************************************************************************/
-template <typename T, typename Exec>
-inline T ArrayMin(care::host_device_ptr<const T> arr, int n, T initVal, int startIndex)  {
-   RAJAReduceMin<T> min { initVal };
-   LOOP_REDUCE(k, startIndex, n) {
-      min.min(arr[k]);
+ * Purpose   : GPU version of uniqArray, with in-place semantics. Set noCopy
+ *             to true if you don't care about data left at the end of the
+ *             array after the uniq. When nothing is removed no copy is made.
+ *             Otherwise the values are not compacted in place, since threads
+ *             compacting in place could overwrite values other threads have
+ *             not read yet. With noCopy they are scattered to a new array of
+ *             the new length; otherwise they are staged through scratch that
+ *             is reused by later calls and copied back.
+  ************************************************************************/
+template <typename T>
+inline int uniqArray(RAJAExec, care::host_device_ptr<T> & Array, size_t len, bool noCopy=false) {
+   const int length = (int) len ;
+   const int numWords = (length + 63) / 64 ;
+   care::host_device_ptr<unsigned long long> flags(numWords > 0 ? numWords : 1, "uniqArray flags");
+   care::host_device_ptr<int> counts(numWords + 1, "uniqArray counts");
+
+   int newLen = uniqFlags<T>(Array, length, flags, counts);
+
+   if (newLen == length) {
+      if (noCopy) {
+         Array.realloc(newLen);
+      }
+   }
+   else if (noCopy) {
+      care::host_device_ptr<T> tmp(newLen, "uniqArray tmp");
+      ScatterFlagged<T>(Array, length, flags, counts, tmp);
+      Array.free();
+      Array = tmp;
+   }
+   else {
+      care::host_device_ptr<T> tmp = AcquireScratch<T>(newLen);
+      ScatterFlagged<T>(Array, length, flags, counts, tmp);
+      ArrayCopy<T>(Array, tmp, newLen);
+      ReleaseScratch<T>(tmp);
+   }
+
+   flags.free();
+   counts.free();
+   return newLen;
+}
+
+#endif //RAJA_PARALLEL_ACTIVE
+
+/************************************************************************
+ * Function  : uniqArray
+ * Author(s) : Peter Robinson
+ * Purpose   : CPU version of uniqArray.
+  ************************************************************************/
+template <typename T>
+inline void uniqArray(RAJA::seq_exec, care::host_device_ptr<T> Array, size_t len, care::host_device_ptr<T> & outArray, int & newLen) {
+   CHAIDataGetter<T, RAJA::seq_exec> getter {};
+   T * rawData = getter.getRawArrayData(Array);
+   newLen = 0 ;
+   care::host_ptr<T> arrout = nullptr ;
+   outArray = nullptr;
+
+   if (len != 0) {
+      size_t i=0  ;
+
+      /* alloc some space, we realloc later */
+      outArray = care::host_device_ptr<T>(len,"uniq_outArray");
+      arrout = outArray;
+
+      while (i < len) {
+         /* copy the unique value into the array */
+         arrout[newLen] = rawData[i] ;
+
+         /* skip over all the redundant elements */
+         while ((i<len) && (rawData[i] == arrout[newLen])) {
+            i++ ;
+         }
+
+         ++newLen;
+      }
+      outArray.realloc(newLen);
+   }
+   return;
+}
+
+/************************************************************************
+ * Function  : uniqArray
+ * Author(s) : Peter Robinson
+ * Purpose   : CPU version of uniqArray, with in-place semantics. Set noCopy to true
+ *             if you don't care about data left at the end of the array after the uniq.
+ *             Without noCopy the values are compacted in place, which is safe
+ *             sequentially since each value moves to a lower or equal index.
+  ************************************************************************/
+template <typename T>
+inline int uniqArray(RAJA::seq_exec exec, care::host_device_ptr<T> & Array, size_t len, bool noCopy=false) {
+   int newLength = 0;
+   if (len > 0) {
+      if (noCopy) {
+         care::host_device_ptr<T> tmp;
+         uniqArray(exec, Array, len, tmp, newLength);
+         Array.free();
+         Array = tmp;
+      }
+      else {
+         CHAIDataGetter<T, RAJA::seq_exec> getter {};
+         T * rawData = getter.getRawArrayData(Array);
+
+         for (size_t i = 1; i < len; ++i) {
+            if (rawData[i] != rawData[newLength]) {
+               rawData[++newLength] = rawData[i];
+            }
+         }
+
+         ++newLength;
+      }
+   }
+   return newLength;
+}
+
+#ifdef RAJA_GPU_ACTIVE
+template <typename T, typename Exec>
+inline void sortArray(Exec, care::host_device_ptr<T> &Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller = CARE_CALLER)
+{
+   printf("%s:%s","sortArray(Exec, care::host_device_ptr, len, start, noCopy)", "unspecialized version should not be called");
+}
+
+template <typename T, typename Exec>
+inline void sortArray(Exec, care::host_device_ptr<T> &Array, size_t len,
+                      const care::SourceLocation & caller = CARE_CALLER)
+{
+   printf("%s:%s","sortArray(Exec, care::host_device_ptr, len)", "unspecialized version should not be called");
+}
+
+template <typename T>
+inline void radixSortArray(care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy,
+                           const care::SourceLocation & caller = CARE_CALLER);
+
+/************************************************************************
+ * Function  : sortArray
+ * Author(s) : Peter Robinson
+ * Purpose   : GPU version of sortArray. Defaults to thrust::sort, but
+ *             specialized to cub::DeviceRadix sort for data types that
+ *             cub supports.
+  ************************************************************************/
+template <typename T>
+inline void sortArray(RAJAExec, care::host_device_ptr<T> &Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller = CARE_CALLER) ;
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<int> & Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, start, noCopy, caller);
+}
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<float> & Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, start, noCopy, caller);
+}
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<double> & Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, start, noCopy, caller);
+}
+
+#if CARE_HAVE_LLNL_GLOBALID
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<globalID> & Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, start, noCopy, caller);
+}
+
+#endif // CARE_HAVE_LLNL_GLOBALID
+
+// This must be explicitly specialized for NVCC to link to the correct version.
+template <typename T>
+inline void sortArray(RAJAExec, care::host_device_ptr<T> &Array, size_t len,
+                      const care::SourceLocation & caller = CARE_CALLER);
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<int> & Array, size_t len,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, 0, false, caller);
+}
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<float> & Array, size_t len,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, 0, false, caller);
+}
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<double> & Array, size_t len,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, 0, false, caller);
+}
+
+#if CARE_HAVE_LLNL_GLOBALID
+
+template <>
+inline void sortArray(RAJAExec, care::host_device_ptr<globalID> & Array, size_t len,
+                      const care::SourceLocation & caller) {
+   radixSortArray(Array, len, 0, false, caller);
+}
+
+#endif // CARE_HAVE_LLNL_GLOBALID
+
+/************************************************************************
+ * Function  : radixSortArray
+ * Author(s) : Peter Robinson
+ * Purpose   : ManagedArray API to cub::DeviceRadixSort::SortKeys.
+  ************************************************************************/
+template <typename T>
+inline void radixSortArray(care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy,
+                           const care::SourceLocation & caller) {
+   care::LoopTraceScope trace("sort", caller, chai::GPU, len);
+   CHAIDataGetter<T, RAJAExec> getter {};
+   CHAIDataGetter<char, RAJAExec> charGetter {};
+   care::host_device_ptr<T> result(len,"radix_sort_result");
+   auto * rawData = getter.getRawArrayData(Array) + start;
+   auto * rawResult = getter.getRawArrayData(result);
+   // get the temp storage length
+   char * d_temp_storage = nullptr;
+   size_t temp_storage_bytes = 0;
+   if (len > 0) {
+#if defined(__CUDACC__)
+      cub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
+#elif defined(__HIPCC__)
+      hipcub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
+#endif   
+   }
+   // allocate the temp storage
+
+   care::host_device_ptr<char> tmpManaged(temp_storage_bytes, "radix_sort_tmpManaged");
+   d_temp_storage = charGetter.getRawArrayData(tmpManaged);
+
+   // do the sort
+   if (len > 0) {
+#if defined(__CUDACC__)
+      cub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
+#elif defined(__HIPCC__)
+      hipcub::DeviceRadixSort::SortKeys((void *)d_temp_storage, temp_storage_bytes, rawData, rawResult, len);
+#endif   
+   }
+   // cleanup
+   if (noCopy) {
+      if (len > 0) {
+         Array.free();
+      }
+      Array = result;
+   }
+   else {
+      ArrayCopy<T>(Array, result, len, start, 0);
+      if (len > 0) {
+         result.free();
+      }
+   }
+   if (len > 0) {
+      tmpManaged.free();
+   }
+}
+#endif // RAJA_GPU_ACTIVE
+
+/************************************************************************
+ * Function  : sortArray
+ * Author(s) : Peter Robinson
+ * Purpose   : CPU version of sortArray. Calls std::sort
+  ************************************************************************/
+template <typename T>
+inline void sortArray(RAJA::seq_exec, care::host_device_ptr<T> & Array, size_t len, int start, bool noCopy,
+                      const care::SourceLocation & caller = CARE_CALLER) {
+   care::LoopTraceScope trace("sort", caller, chai::CPU, len);
+   CHAIDataGetter<T, RAJA::seq_exec> getter {};
+   T * rawData = getter.getRawArrayData(Array)+start;
+   std::sort(rawData, rawData+len);
+   noCopy = noCopy ;
+}
+
+template <typename T>
+inline void sortArray(RAJA::seq_exec, care::host_device_ptr<T> &Array, size_t len,
+                      const care::SourceLocation & caller = CARE_CALLER)
+{
+   care::LoopTraceScope trace("sort", caller, chai::CPU, len);
+   CHAIDataGetter<T, RAJA::seq_exec> getter {};
+   T * rawData = getter.getRawArrayData(Array);
+   std::sort(rawData, rawData+len);
+}
+
+/************************************************************************
+* Function  : sort_uniq(<T>_ptr)
+* Author(s) : Peter Robinson
+* Purpose   : Sorts and uniques an array.
+**************************************************************************/
+template <typename T, typename Exec>
+inline void sort_uniq(Exec e, care::host_device_ptr<T> * array, int * len, bool noCopy = false,
+                      const care::SourceLocation & caller = CARE_CALLER) {
+   if ((*len) == 0) {
+      if ((*array) != nullptr) {
+         array->free();
+         *array = nullptr;
+      }
+      return  ;
+   }
+   /* first sort the array */
+   sortArray<T>(e, *array, *len, 0, noCopy, caller);
+   /* then unique it */
+   *len = uniqArray<T>(e, *array, *len, noCopy);
+}
+
+#ifdef RAJA_PARALLEL_ACTIVE
+/************************************************************************
+* Function  : CompressFlags
+* Author(s) : Peter Robinson
+* Purpose   : Builds the flags (one 64 bit word per 64 elements, set bits
+*           : are kept) and the exclusive scanned per-word counts describing
+*           : the removal of the sorted indices in removed from an array of
+*           : length arrLen. Each word merges against the removal list from
+*           : a single search, so there is no per-element search. Returns
+*           : the number of elements kept.
+**************************************************************************/
+inline int CompressFlags(const int arrLen, care::host_device_ptr<int const> removed, const int removedLen,
+                         care::host_device_ptr<unsigned long long> flags,
+                         care::host_device_ptr<int> counts) {
+   const int numWords = (arrLen + 63) / 64 ;
+
+   LOOP_STREAM(w, 0, numWords + 1) {
+      if (w == numWords) {
+         counts[w] = 0 ;
+      }
+      else {
+         const int first = w * 64 ;
+         const int last = first + 64 < arrLen ? first + 64 : arrLen ;
+         unsigned long long word = last - first == 64 ? ~0ull : (1ull << (last - first)) - 1ull ;
+
+         for (int r = GallopSearch<int>(removed, 0, removedLen, first) ; r < removedLen && removed[r] < last ; ++r) {
+            word &= ~(1ull << (removed[r] - first)) ;
+         }
+
+         flags[w] = word ;
+         counts[w] = care::popCount(word) ;
+      }
+   } LOOP_STREAM_END
+
+   exclusive_scan<int, RAJAExec>(counts, nullptr, numWords + 1, RAJA::operators::plus<int>{}, 0, true);
+
+   return counts.pick(numWords) ;
+}
+
+/************************************************************************
+* Function  : CompressFlagged<T>
+* Purpose   : Keeps the elements of arr flagged by CompressFlags.
+*           : With noCopy, arr is replaced by an array of exactly numKept
+*           : elements; otherwise the kept values are gathered into
+*           : scratch, which must hold numKept values of type T, and
+*           : copied back into arr.
+**************************************************************************/
+template <typename T>
+inline void CompressFlagged(RAJAExec exec, care::host_device_ptr<T> & arr, const int arrLen,
+                            care::host_device_ptr<unsigned long long const> flags,
+                            care::host_device_ptr<int const> counts,
+                            const int numKept, bool noCopy,
+                            care::host_device_ptr<char> scratch) {
+   if (noCopy) {
+      care::host_device_ptr<T> tmp(numKept, "CompressArray_tmp");
+      ScatterFlagged<T>(arr, arrLen, flags, counts, tmp);
+      arr.free();
+      arr = tmp;
+   }
+   else {
+      care::host_device_ptr<T> tmp = reinterpret_cast<care::host_device_ptr<T> &>(scratch);
+      ScatterFlagged<T>(arr, arrLen, flags, counts, tmp);
+      ArrayCopy<T>(exec, arr, tmp, numKept);
+   }
+}
+
+/************************************************************************
+* Function  : CompressArrays
+* Purpose   : Removes the items at the indices in removed from every one of
+*           : the given arrays, which all have length arrLen. The flags and
+*           : scan are computed once and shared, so each additional array
+*           : only costs one streaming copy. Without noCopy, every array
+*           : is gathered through the same scratch, sized for the largest
+*           : element type and reused by later calls.
+*           : Only requires removed to be sorted.
+**************************************************************************/
+template <typename... Ts>
+inline void CompressArrays(RAJAExec exec, const int arrLen,
+                           care::host_device_ptr<int const> removed, const int removedLen,
+                           bool noCopy, care::host_device_ptr<Ts> & ... arrays) {
+   const int numWords = (arrLen + 63) / 64 ;
+   care::host_device_ptr<unsigned long long> flags(numWords > 0 ? numWords : 1, "CompressArray flags");
+   care::host_device_ptr<int> counts(numWords + 1, "CompressArray counts");
+
+   const int numKept = CompressFlags(arrLen, removed, removedLen, flags, counts);
+
+#ifdef CARE_DEBUG
+   int numRemoved = arrLen - numKept;
+   if (removedLen != numRemoved) {
+      printf("Warning in CompressArray<T>: did not remove expected number of members!\n");
+   }
+#endif
+
+   care::host_device_ptr<char> scratch = nullptr;
+
+   if (!noCopy) {
+      size_t maxSize = 0;
+      int sizes[] = {0, (maxSize = sizeof(Ts) > maxSize ? sizeof(Ts) : maxSize, 0)...};
+      (void) sizes;
+
+      scratch = AcquireScratch<char>((size_t) numKept * maxSize);
+   }
+
+   int expand[] = {0, (CompressFlagged<Ts>(exec, arrays, arrLen, flags, counts, numKept, noCopy, scratch), 0)...};
+   (void) expand;
+
+   if (!noCopy) {
+      ReleaseScratch<char>(scratch);
+   }
+
+   flags.free();
+   counts.free();
+}
+
+/************************************************************************
+* Function  : CompressArray<T>
+* Author(s) : Peter Robinson
+* Purpose   : Removes items at indices defined in removed from arr.
+*           : Thread safe version of CompressArray.
+*           : Note that thread safe version only requires removed to be sorted.
+*           : Note also that it's a error if any index in removed is
+*           : not found (beyond the end of arr).
+**************************************************************************/
+template <typename T>
+inline void CompressArray(RAJAExec exec, care::host_device_ptr<T> & arr, const int arrLen,
+                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
+   //GPU VERSION
+   CompressArrays<T>(exec, arrLen, removed, removedLen, noCopy, arr);
+}
+
+#endif // RAJA_PARALLEL_ACTIVE
+
+/************************************************************************
+* Function  : CompressArray<T>
+* Author(s) : Peter Robinson
+* Purpose   : Removes items at indices defined in removed from arr.
+*             Sequential Version of CompressArray
+*             Requires both arr and removed to be sorted.
+*             Note that it's a error if any index in removed is
+*             not found (beyond the end of arr).
+**************************************************************************/
+template <typename T>
+inline void CompressArray(RAJA::seq_exec, care::host_device_ptr<T> & arr, const int arrLen,
+                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
+   // CPU VERSION
+
+   int readLoc;
+   int writeLoc = 0, numRemoved = 0;
+   care::host_ptr<int const> removedHost = removed ;
+   care::host_ptr<T> arrHost = arr ;
+#ifdef CARE_DEBUG
+   if (removedHost[removedLen-1] > arrLen-1) {
+      printf("Warning in CompressArray<T> seq_exec: asking to remove entries not in array!\n");
+   }
+#endif
+   for (readLoc = 0; readLoc < arrLen; ++readLoc) {
+      if ((numRemoved == removedLen) || (readLoc < removedHost[numRemoved])) {
+         arrHost[writeLoc++] = arrHost[readLoc];
+      }
+      else if (readLoc == removedHost[numRemoved]) {
+         ++numRemoved;
+      }
+#ifdef CARE_DEBUG
+      else {
+         printf("Warning in CompressArray<int> seq_exec: list of removed members not sorted!\n");
+      }
+#endif
+   }
+#ifdef CARE_DEBUG
+   if ((removedLen != numRemoved) || (writeLoc != arrLen - removedLen)) {
+      printf("CompressArray<T> seq_exec: did not remove expected number of members!\n");
+   }
+#endif
+   noCopy = noCopy;
+}
+
+/************************************************************************
+* Function  : CompressArrays
+* Purpose   : Removes the items at the indices in removed from every one of
+*             the given arrays, which all have length arrLen.
+*             Sequential Version of CompressArrays
+**************************************************************************/
+template <typename... Ts>
+inline void CompressArrays(RAJA::seq_exec exec, const int arrLen,
+                           care::host_device_ptr<int const> removed, const int removedLen,
+                           bool noCopy, care::host_device_ptr<Ts> & ... arrays) {
+   int expand[] = {0, (CompressArray<Ts>(exec, arrays, arrLen, removed, removedLen, noCopy), 0)...};
+   (void) expand;
+}
+
+template <typename T>
+inline void CompressArray(care::host_device_ptr<T> & arr, const int arrLen,
+                          care::host_device_ptr<int const> removed, const int removedLen, bool noCopy=false) {
+   return CompressArray(RAJAExec(), arr, arrLen, removed, removedLen, noCopy);
+}
+
+template <typename... Ts>
+inline void CompressArrays(const int arrLen, care::host_device_ptr<int const> removed, const int removedLen,
+                           bool noCopy, care::host_device_ptr<Ts> & ... arrays) {
+   return CompressArrays(RAJAExec(), arrLen, removed, removedLen, noCopy, arrays...);
+}
+
+/************************************************************************
+ * Function  : ExpandArrayInPlace
+ * Purpose   : Moves array[i] to array[indexSet[i]] for i in [0, length).
+ *             indexSet must be sorted with indexSet[i] >= i. Entries of
+ *             array not in indexSet are left untouched.
+ *             Sequential Version of ExpandArrayInPlace
+ ************************************************************************/
+template <typename T>
+inline void ExpandArrayInPlace(RAJA::seq_exec, care::host_device_ptr<T> array, care::host_device_ptr<int const> indexSet, int length)
+{
+   if (length > 0) {
+      care::host_ptr<int const> host_indexSet = indexSet ;
+      care::host_ptr<T> host_array =array;
+      for (int i = length-1; i >= 0; --i) {
+         int idx = host_indexSet[i] ;
+         host_array[idx] = host_array[i] ;
+      }
+   }
+}
+
+/************************************************************************
+ * Function  : ExpandArrays
+ * Purpose   : ExpandArrayInPlace for every one of the given arrays, which
+ *             all share indexSet.
+ *             Sequential Version of ExpandArrays
+ ************************************************************************/
+template <typename... Ts>
+inline void ExpandArrays(RAJA::seq_exec exec, care::host_device_ptr<int const> indexSet, int length,
+                         care::host_device_ptr<Ts> ... arrays)
+{
+   int expand[] = {0, (ExpandArrayInPlace<Ts>(exec, arrays, indexSet, length), 0)...};
+   (void) expand;
+}
+
+#ifdef RAJA_PARALLEL_ACTIVE
+/************************************************************************
+ * Function  : ExpandArraysThroughScratch
+ * Purpose   : Parallel expand of every one of the given arrays through
+ *             the matching scratch array, which must hold at least length
+ *             values. The leading values are staged in scratch so the
+ *             scatter cannot overwrite a value another thread has yet to
+ *             read. Every array is staged in one pass and scattered in
+ *             another, so the number of loops does not grow with the
+ *             number of arrays. The scratch arrays are given back with
+ *             ReleaseScratch.
+ ************************************************************************/
+template <typename... Ts>
+inline void ExpandArraysThroughScratch(care::host_device_ptr<int const> indexSet, int length,
+                                       care::host_device_ptr<Ts> ... scratch,
+                                       care::host_device_ptr<Ts> ... arrays)
+{
+   LOOP_STREAM(i, 0, length) {
+      int stage[] = {0, (scratch[i] = arrays[i], 0)...};
+      (void) stage;
+   } LOOP_STREAM_END
+
+   LOOP_STREAM(i, 0, length) {
+      const int idx = indexSet[i] ;
+      int scatter[] = {0, (arrays[idx] = scratch[i], 0)...};
+      (void) scatter;
+   } LOOP_STREAM_END
+
+   int releaseScratch[] = {0, (ReleaseScratch<Ts>(scratch), 0)...};
+   (void) releaseScratch;
+}
+
+/************************************************************************
+ * Function  : ExpandArrays
+ * Purpose   : ExpandArrayInPlace for every one of the given arrays, which
+ *             all share indexSet and may have different types. Each array
+ *             is staged in scratch of its own from the calling thread's
+ *             care::ScratchWorkspace, which is reused by later calls.
+ ************************************************************************/
+template <typename... Ts>
+inline void ExpandArrays(RAJAExec, care::host_device_ptr<int const> indexSet, int length,
+                         care::host_device_ptr<Ts> ... arrays)
+{
+   if (length > 0) {
+      ExpandArraysThroughScratch<Ts...>(indexSet, length,
+                                        AcquireScratch<Ts>(length)...,
+                                        arrays...);
+   }
+}
+
+template <typename T>
+inline void ExpandArrayInPlace(RAJAExec exec, care::host_device_ptr<T> array, care::host_device_ptr<int const> indexSet, int length)
+{
+   ExpandArrays<T>(exec, indexSet, length, array);
+}
+
+#endif
+
+
+#if defined(CARE_SIMD_HOST_EXEC)
+/************************************************************************
+ * Class     : HostSimdLoop
+ * Purpose   : Calls the RAJAPlugin loop hooks around a host SIMD kernel,
+ *             so it is profiled and traced like the loop it replaces.
+ ************************************************************************/
+class HostSimdLoop {
+   public:
+      HostSimdLoop(const char * fileName, const int lineNumber, const int length) :
+         m_file_name(fileName),
+         m_line_number(lineNumber)
+      {
+         care::RAJAPlugin::pre_forall_hook(chai::CPU, fileName, lineNumber, length);
+      }
+
+      ~HostSimdLoop() {
+         care::RAJAPlugin::post_forall_hook(chai::CPU, m_file_name, m_line_number);
+      }
+
+      HostSimdLoop(const HostSimdLoop &) = delete;
+      HostSimdLoop & operator=(const HostSimdLoop &) = delete;
+
+   private:
+      const char * m_file_name;
+      int m_line_number;
+};
+#endif
+
+/************************************************************************
+ * Function  : ArrayFill
+ * Author(s) : Peter Robinson
+ * Purpose   : Fills a ManagedArray with the value given.
+ * ************************************************************************/
+template <typename T, typename Exec>
+inline void ArrayFill(care::host_device_ptr<T> arr, int n, T val) {
+#if defined(CARE_SIMD_HOST_EXEC)
+   if (n > 0) {
+      const HostSimdLoop loop(__FILE__, __LINE__, n);
+      care::host_ptr<T> data = arr;
+      care::simd::fill(Exec{}, data.data(), n, val);
+   }
+#else
+   LOOP_STREAM(i, 0, n) {
+      arr[i] = val;
+   } LOOP_STREAM_END
+#endif
+}
+
+template <typename T>
+void ArrayFill(care::host_ptr<T> arr, int n, T val)  {
+   care::simd::fill(RAJA::seq_exec{}, (T *) arr, n, val);
+}
+
+/************************************************************************
+ * Function  : ArrayMin
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the minimum value in a ManagedArray
+ * ************************************************************************/
+template <typename T, typename Exec>
+inline T ArrayMin(care::host_device_ptr<const T> arr, int n, T initVal, int startIndex)  {
+#if defined(CARE_SIMD_HOST_EXEC)
+   if (n <= startIndex) {
+      return initVal;
+   }
+
+   const HostSimdLoop loop(__FILE__, __LINE__, n - startIndex);
+   care::host_ptr<const T> data = arr;
+   return care::simd::reduceMin(Exec{}, data.data() + startIndex, n - startIndex, initVal);
+#else
+   RAJAReduceMin<T> min { initVal };
+   LOOP_REDUCE(k, startIndex, n) {
+      min.min(arr[k]);
+   } LOOP_REDUCE_END
+   return (T)min;
+#endif
+}
+
+template <typename T, typename Exec>
+inline T ArrayMin(care::host_device_ptr<T> arr, int n, T initVal, int startIndex)  {
+   return ArrayMin<T, Exec>((care::host_device_ptr<const T>)arr, n, initVal, startIndex);
+}
+
+template <typename T>
+inline CARE_HOST_DEVICE T ArrayMin(care::local_ptr<const T> arr, int n, T initVal, int startIndex)  {
+#if CARE_ENABLE_SIMD && !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+   // called from within loops, so never starts another parallel region
+   return n > startIndex ? care::simd::reduceMin(RAJA::seq_exec{}, (const T *) arr + startIndex, n - startIndex, initVal) : initVal;
+#else
+   T min = initVal;
+   for (int k = startIndex; k < n; ++k) {
+      min = CARE_MIN(min, arr[k]);
+   }
+   return min;
+#endif
+}
+
+template <typename T>
+inline CARE_HOST_DEVICE T ArrayMin(care::local_ptr<T> arr, int n, T initVal, int startIndex)  {
+   return ArrayMin<T>((care::local_ptr<const T>)arr, n, initVal, startIndex);
+}
+
+/************************************************************************
+ * Function  : ArrayMinLoc
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the minimum value in a ManagedArray
+ * ************************************************************************/
+template <typename T, typename Exec>
+inline T ArrayMinLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc)  {
+   RAJAReduceMinLoc<T> min { initVal, -1 };
+   LOOP_REDUCE(k, 0, n) {
+      min.minloc(arr[k], k);
    } LOOP_REDUCE_END
+   loc = min.getLoc();
    return (T)min;
 }
 
+/************************************************************************
+ * Function  : ArrayMaxLoc
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the maximum value in a ManagedArray
+ * ************************************************************************/
+template <typename T, typename Exec>
+inline T ArrayMaxLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc)  {
+   RAJAReduceMaxLoc<T> max { initVal, -1 };
+   LOOP_REDUCE(k, 0, n) {
+      max.maxloc(arr[k], k);
+   } LOOP_REDUCE_END
+   loc = max.getLoc();
+   return (T)max;
+}
+
+/************************************************************************
+ * Function  : ArrayMax
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the maximum value in a ManagedArray
+ * ************************************************************************/
+template <typename T, typename Exec>
+inline T ArrayMax(care::host_device_ptr<const T> arr, int n, T initVal)  {
+#if defined(CARE_SIMD_HOST_EXEC)
+   if (n <= 0) {
+      return initVal;
+   }
+
+   const HostSimdLoop loop(__FILE__, __LINE__, n);
+   care::host_ptr<const T> data = arr;
+   return care::simd::reduceMax(Exec{}, data.data(), n, initVal);
+#else
+   RAJAReduceMax<T> max { initVal };
+   LOOP_REDUCE(k, 0, n) {
+      max.max(arr[k]);
+   } LOOP_REDUCE_END
+   return (T)max;
+#endif
+}
+
+template <typename T, typename Exec>
+inline T ArrayMax(care::host_device_ptr<T> arr, int n, T initVal)  {
+   return ArrayMax<T, Exec>((care::host_device_ptr<const T>)arr, n, initVal);;
+}
+
+/************************************************************************
+ * Function  : ArrayMax
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the maximum value in a ManagedArray
+ * ************************************************************************/
+template <typename T>
+CARE_HOST_DEVICE inline T ArrayMax(care::local_ptr<const T> arr, int n, T initVal)  {
+#if CARE_ENABLE_SIMD && !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+   // called from within loops, so never starts another parallel region
+   return n > 0 ? care::simd::reduceMax(RAJA::seq_exec{}, (const T *) arr, n, initVal) : initVal;
+#else
+   T max = initVal;
+   for (int k = 0; k < n; ++k) {
+      max = CARE_MAX(max, arr[k]);
+   }
+   return max;
+#endif
+}
+
+template <typename T>
+CARE_HOST_DEVICE inline T ArrayMax(care::local_ptr<T> arr, int n, T initVal)  {
+   return ArrayMax<T>((care::local_ptr<const T>)arr, n, initVal);
+}
+
+/* predicates for FindFirst */
+template <typename T>
+struct EqualToValue {
+   T val ;
+
+   CARE_HOST_DEVICE bool operator()(const T & x) const {
+      return x == val ;
+   }
+};
+
+template <typename T>
+struct GreaterThanValue {
+   T limit ;
+
+   CARE_HOST_DEVICE bool operator()(const T & x) const {
+      return x > limit ;
+   }
+};
+
+/************************************************************************
+ * Function  : FindFirst
+ * Purpose   : Returns the index of the first element of arr in
+ *             [start, end) for which pred is true, or -1 if there is none.
+ *             The range is searched in consecutive chunks, each with one
+ *             parallel min reduction, and no further chunks are launched
+ *             once one holds a match. Chunks start small, so early matches
+ *             are cheap, and double in size until one covers the rest of
+ *             the range, so a search that finds nothing launches a number
+ *             of loops logarithmic in the length of the range.
+ ************************************************************************/
+template <typename T, typename Predicate, typename Exec>
+int FindFirst(care::host_device_ptr<const T> arr, int start, int end, Predicate pred)
+{
+   int chunkSize = 1 << 14 ;
+
+   for (int lo = start ; lo < end ; ) {
+      const int hi = end - lo > chunkSize ? lo + chunkSize : end ;
+      RAJAReduceMin<int> first { hi } ;
+
+      LOOP_REDUCE(i, lo, hi) {
+         if (pred(arr[i])) {
+            first.min(i) ;
+         }
+      } LOOP_REDUCE_END
+
+      const int result = (int) first ;
+
+      if (result < hi) {
+         return result ;
+      }
+
+      lo = hi ;
+
+      // No cap, so a long search takes a logarithmic number of chunks
+      chunkSize = chunkSize > std::numeric_limits<int>::max() / 2 ? std::numeric_limits<int>::max() : 2 * chunkSize ;
+   }
+
+   return -1 ;
+}
+
+/************************************************************************
+ * Function  : ArrayFind
+ * Author(s) : Rob Neely, Alan Dayton
+ * Purpose   : Returns the index of the first element in the the array
+ *             that equals the value, or -1 if no match is found.
+ ************************************************************************/
+template <typename T>
+int ArrayFind(care::host_device_ptr<const T> arr, const int len, const T val, const int start)
+{
+   return FindFirst<T, EqualToValue<T>, RAJAExec>(arr, start, len, EqualToValue<T>{val}) ;
+}
+
+/************************************************************************
+ * Function  : ArrayMax
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the maximum value in a ManagedArray.
+ *             Wraps above care::host_device_ptr implementation with a care::host_ptr API.
+ * ************************************************************************/
+template <typename T>
+inline T ArrayMax(care::host_ptr<const T> arr, int n, T initVal)  {
+   return ArrayMax<T, RAJA::seq_exec>(care::host_device_ptr<const T>((const T *) arr, n, "ArrayMaxTmp"), n, initVal);
+}
+
+template <typename T>
+inline T ArrayMax(care::host_ptr<T> arr, int n, T initVal)  {
+   return ArrayMax<T>((care::host_ptr<const T>)arr, n, initVal);
+}
+
+/************************************************************************
+ * Function  : ArrayMinMax
+ * Author(s) : Peter Robinson
+ * Purpose   : Stores Minimum / Maximum values of arr (as a double) in outMin / outMax;
+ *             If mask was such that no values were compared, returns 0, outMin will be -DBL_MAX, outMax will be DBL_MAX
+ *             Otherwise, returns 1.
+ * ************************************************************************/
+template <typename T, typename ReducerType, typename RAJAExec>
+int ArrayMinMax(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax) {
+   bool result = false;
+   ReducerType minVal, maxVal;
+   if (arr) {
+      RAJAReduceMax<ReducerType> max { std::numeric_limits<ReducerType>::lowest() };
+      RAJAReduceMin<ReducerType> min { std::numeric_limits<ReducerType>::max() };
+      if (mask) {
+         LOOP_REDUCE(i, 0, n) {
+            if (mask[i]) {
+               min.min((ReducerType) arr[i]);
+               max.max((ReducerType) arr[i]);
+            }
+         } LOOP_REDUCE_END
+         minVal = (ReducerType) min;
+         maxVal = (ReducerType) max;
+         if (minVal!= std::numeric_limits<ReducerType>::max() ||
+             maxVal != std::numeric_limits<ReducerType>::lowest()) {
+            result = true;
+         }
+      }
+      else {
+         LOOP_REDUCE(i, 0, n) {
+            min.min((ReducerType)arr[i]);
+            max.max((ReducerType)arr[i]);
+         } LOOP_REDUCE_END
+         minVal = (ReducerType) min;
+         maxVal = (ReducerType) max;
+         result = true;
+      }
+   }
+   if (result) {
+      *outMin = (double) minVal;
+      *outMax = (double) maxVal;
+   }
+   else {
+      *outMin = -DBL_MAX;
+      *outMax = +DBL_MAX;
+   }
+
+   return (int) result;
+}
+
+template <typename T, typename ReducerType, typename RAJAExec>
+inline int ArrayMinMax(care::host_device_ptr<T> arr, care::host_device_ptr<int> mask, int n, double *outMin, double *outMax) {
+ return ArrayMinMax<T, ReducerType, RAJAExec>((care::host_device_ptr<const T>)arr, (care::host_device_ptr<int const>)mask, n, outMin, outMax);
+}
+
+/************************************************************************
+ * Function  : ArrayMinMax
+ * Purpose   : ArrayMinMax where mask is a bitset. Values whose bits are set
+ *             are compared. Works a 64 bit word at a time, so fully masked
+ *             regions cost one load per 64 values.
+ * ************************************************************************/
+template <typename T, typename ReducerType, typename RAJAExec>
+int ArrayMinMax(care::host_device_ptr<const T> arr, care::bitset const & mask, int n, double *outMin, double *outMax) {
+   if (!mask) {
+      return ArrayMinMax<T, ReducerType, RAJAExec>(arr, care::host_device_ptr<int const>(nullptr), n, outMin, outMax);
+   }
+
+   bool result = false;
+   ReducerType minVal, maxVal;
+   if (arr) {
+      RAJAReduceMax<ReducerType> max { std::numeric_limits<ReducerType>::lowest() };
+      RAJAReduceMin<ReducerType> min { std::numeric_limits<ReducerType>::max() };
+      RAJAReduceSum<int> numCompared { 0 };
+      care::bitset bits = mask;
+
+      LOOP_REDUCE(w, 0, care::bitset::wordsFor(n)) {
+         const int remaining = n - w * care::bitset::bitsPerWord;
+         unsigned long long word = bits.word(w);
+
+         if (remaining < care::bitset::bitsPerWord) {
+            word &= (1ull << remaining) - 1ull;
+         }
+
+         numCompared += care::popCount(word);
+
+         for (; word != 0; word &= word - 1) {
+            const int i = w * care::bitset::bitsPerWord + care::countTrailingZeros(word);
+            min.min((ReducerType) arr[i]);
+            max.max((ReducerType) arr[i]);
+         }
+      } LOOP_REDUCE_END
+
+      minVal = (ReducerType) min;
+      maxVal = (ReducerType) max;
+      result = (int) numCompared > 0;
+   }
+   if (result) {
+      *outMin = (double) minVal;
+      *outMax = (double) maxVal;
+   }
+   else {
+      *outMin = -DBL_MAX;
+      *outMax = +DBL_MAX;
+   }
+
+   return (int) result;
+}
+
+#if CARE_HAVE_LLNL_GLOBALID
+
+template <typename Exec=RAJAExec>
+int ArrayMinMax(care::host_device_ptr<const globalID> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax);
+
+template <typename Exec>
+inline int ArrayMinMax(care::host_device_ptr<const globalID> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax) {
+   return ArrayMinMax<globalID, GIDTYPE, Exec>(arr, mask, n, outMin, outMax);
+}
+
+#endif // CARE_HAVE_LLNL_GLOBALID
+
+/************************************************************************
+ * Function  : ArrayMinMax
+ * Author(s) : Peter Robinson
+ * Purpose   : Stores Minimum / Maximum values of arr (as a double) in outMin / outMax;
+ *             If mask was such that no values were compared, returns 0, outMin will be -DBL_MAX, outMax will be DBL_MAX
+ *             Otherwise, returns 1.
+ *             care::local_ptr API to support calls from within RAJA contexts.
+ * ************************************************************************/
+template <typename T>
+CARE_HOST_DEVICE inline int ArrayMinMax(care::local_ptr<const T> arr, care::local_ptr<int const> mask, int n, double *outMin, double *outMax) {
+   bool result = false;
+   // a previous implementation had min and max as a templated type and then used std::numeric_limits<T>::lowest() and 
+   // std::numeric_limits<ReducerType>::max() for initial values, but that is not valid on the device and results in 
+   // warnings and undefined behavior at runtime.
+   double min, max;
+   if (arr) {
+      max =  -DBL_MAX; 
+      min =  DBL_MAX;
+      if (mask) {
+         for (int i = 0; i < n; ++i) {
+            if (mask[i]) {
+               min = CARE_MIN(min, (double)arr[i]);
+               max = CARE_MAX(max, (double)arr[i]);
+            }
+         }
+         if (min != DBL_MAX ||
+             max != -DBL_MAX) {
+            result = true;
+         }
+      }
+      else {
+         for (int i = 0; i < n; ++i) {
+            min = CARE_MIN(min, (double)arr[i]);
+            max = CARE_MAX(max, (double)arr[i]);
+         }
+         result = true;
+      }
+   }
+   if (result) {
+      *outMin = (double) min;
+      *outMax = (double) max;
+   }
+   else {
+      *outMin = -DBL_MAX;
+      *outMax = +DBL_MAX;
+   }
+   return (int) result;
+}
+
+template <typename T>
+CARE_HOST_DEVICE inline int ArrayMinMax(care::local_ptr<T> arr, care::local_ptr<int> mask, int n, double *outMin, double *outMax)
+{
+   return ArrayMinMax<T>((care::local_ptr<const T>)arr, (care::local_ptr<int const>)mask, n, outMin, outMax);
+}
+
+/************************************************************************
+ * Function  : ArrayCount
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns count of occurence of val in arr.
+ * ************************************************************************/
 template <typename T, typename Exec>
-inline T ArrayMin(care::host_device_ptr<T> arr, int n, T initVal, int startIndex)  {
-   return ArrayMin<T, Exec>((care::host_device_ptr<const T>)arr, n, initVal, startIndex);
+inline int  ArrayCount(care::host_device_ptr<const T> arr, int length, T val)  {
+#if defined(CARE_SIMD_HOST_EXEC)
+   if (length <= 0) {
+      return 0;
+   }
+
+   const HostSimdLoop loop(__FILE__, __LINE__, length);
+   care::host_ptr<const T> data = arr;
+   return care::simd::count(Exec{}, data.data(), length, val);
+#else
+   RAJAReduceSum<int> count { 0 };
+   LOOP_REDUCE(k, 0, length) {
+      count += (int) (arr[k] == val);
+   } LOOP_REDUCE_END
+   return (int) count ;
+#endif
+}
+
+/************************************************************************
+ * Function  : ArraySum
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the sum of all values in a ManagedArray
+ * ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+inline T ArraySum(care::host_device_ptr<const T> arr, int n, T initVal)  {
+   ReduceType iVal = initVal;
+#if defined(CARE_SIMD_HOST_EXEC)
+   if (n <= 0) {
+      return (T) iVal;
+   }
+
+   const HostSimdLoop loop(__FILE__, __LINE__, n);
+   care::host_ptr<const T> data = arr;
+   return (T) care::simd::reduceSum(Exec{}, data.data(), n, iVal);
+#else
+   RAJAReduceSum<ReduceType> sum { iVal };
+   LOOP_REDUCE(k, 0, n) {
+      sum += arr[k];
+   } LOOP_REDUCE_END
+   return (T) (ReduceType) sum;
+#endif
+}
+
+/************************************************************************
+ * Function  : ArraySumSubset
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the sum of values in arr at indices in subset.
+ * Note      : length n refers to length of subset, not array
+ * ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+inline T ArraySumSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> subset, int n, T initVal) {
+   ReduceType iVal = initVal;
+   RAJAReduceSum<ReduceType> sum { iVal };
+   LOOP_REDUCE(k, 0, n) {
+      sum += arr[subset[k]];
+   } LOOP_REDUCE_END
+   return (T) (ReduceType) sum;
+}
+
+/************************************************************************
+ * Function  : ArrayMaskedSumSubset
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the sum of values in arr at indices in subset.
+ * ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+inline T ArrayMaskedSumSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, care::host_device_ptr<int const> subset, int n, T initVal) {
+   ReduceType iVal =initVal;
+   RAJAReduceSum<ReduceType> sum { iVal };
+   LOOP_REDUCE(k, 0, n) {
+      int ndx = subset[k];
+      if (mask[ndx] == 0) {
+         sum += arr[ndx];
+      }
+   } LOOP_REDUCE_END
+   return (T) (ReduceType) sum;
+}
+
+/************************************************************************
+ * Function  : ArrayMaskedSum
+ * Author(s) : Peter Robinson
+ * Purpose   : Returns the sum of values in arr at indices where mask is 0.
+ * ************************************************************************/
+template<typename T, typename ReduceType, typename Exec>
+T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, T initVal)
+{
+   ReduceType iVal = initVal;
+   RAJAReduceSum<ReduceType> sum { iVal };
+
+   LOOP_STREAM(i, 0, n) {
+      sum += arr[i] * T(mask[i] == 0);
+   } LOOP_STREAM_END
+
+   return (T) (ReduceType) sum ;
+}
+
+/************************************************************************
+ * Function  : ArrayMaskedSumSubset
+ * Purpose   : Returns the sum of values in arr at indices in subset whose
+ *             bits are clear in mask.
+ * ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+inline T ArrayMaskedSumSubset(care::host_device_ptr<const T> arr, care::bitset const & mask, care::host_device_ptr<int const> subset, int n, T initVal) {
+   ReduceType iVal =initVal;
+   RAJAReduceSum<ReduceType> sum { iVal };
+   care::bitset bits = mask;
+   LOOP_REDUCE(k, 0, n) {
+      int ndx = subset[k];
+      if (!bits.test(ndx)) {
+         sum += arr[ndx];
+      }
+   } LOOP_REDUCE_END
+   return (T) (ReduceType) sum;
+}
+
+/************************************************************************
+ * Function  : ArrayMaskedSum
+ * Purpose   : Returns the sum of values in arr at indices whose bits are
+ *             clear in mask. Works a 64 bit word at a time, so fully masked
+ *             regions are skipped.
+ * ************************************************************************/
+template<typename T, typename ReduceType, typename Exec>
+T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::bitset const & mask, int n, T initVal)
+{
+   ReduceType iVal = initVal;
+   RAJAReduceSum<ReduceType> sum { iVal };
+   care::bitset bits = mask;
+
+   LOOP_REDUCE(w, 0, care::bitset::wordsFor(n)) {
+      const int remaining = n - w * care::bitset::bitsPerWord;
+      unsigned long long word = ~bits.word(w);
+
+      if (remaining < care::bitset::bitsPerWord) {
+         word &= (1ull << remaining) - 1ull;
+      }
+
+      if (word == ~0ull) {
+         const int first = w * care::bitset::bitsPerWord;
+         ReduceType wordSum = 0;
+
+         for (int i = first; i < first + care::bitset::bitsPerWord; ++i) {
+            wordSum += arr[i];
+         }
+
+         sum += wordSum;
+      }
+      else {
+         for (; word != 0; word &= word - 1) {
+            sum += arr[w * care::bitset::bitsPerWord + care::countTrailingZeros(word)];
+         }
+      }
+   } LOOP_REDUCE_END
+
+   return (T) (ReduceType) sum ;
+}
+
+/************************************************************************
+ * Function  : CombineArrayStatistics
+ * Purpose   : Folds the statistics of part into total. On ties the smaller
+ *             location is kept, so the result does not depend on how the
+ *             array was split up.
+ * ************************************************************************/
+template <typename T, typename ReduceType>
+CARE_HOST_DEVICE inline void CombineArrayStatistics(ArrayStatistics<T, ReduceType> & total,
+                                                    ArrayStatistics<T, ReduceType> const & part)
+{
+   if (part.minLoc >= 0 &&
+       (total.minLoc < 0 || part.min < total.min ||
+        (!(total.min < part.min) && part.minLoc < total.minLoc))) {
+      total.min = part.min;
+      total.minLoc = part.minLoc;
+   }
+
+   if (part.maxLoc >= 0 &&
+       (total.maxLoc < 0 || total.max < part.max ||
+        (!(part.max < total.max) && part.maxLoc < total.maxLoc))) {
+      total.max = part.max;
+      total.maxLoc = part.maxLoc;
+   }
+
+   total.sum += part.sum;
+   total.sumOfSquares += part.sumOfSquares;
+   total.count += part.count;
+   total.numIncluded += part.numIncluded;
+}
+
+/************************************************************************
+ * Function  : ArrayStats
+ * Purpose   : Computes the statistics selected by the ArrayStatistic bits in
+ *             statistics (min, max, minloc, maxloc, sum, sum of squares, and
+ *             count of occurrences of countVal) over arr in a single pass.
+ *             If mask is non-null, only indices where mask is nonzero are
+ *             included (the same convention as ArrayMinMax). numIncluded is
+ *             always computed so callers can form means and variances.
+ *             Each chunk reduces a strided slice of arr, so neighbouring
+ *             iterations read neighbouring elements, into a partial
+ *             ArrayStatistics. The partials are combined in place in
+ *             rounds of up to 64, and the result is read back once.
+ *             Among equal minima or maxima the smallest location is kept.
+ * Note      : Requesting MINLOC implies MIN and MAXLOC implies MAX, since
+ *             the location is found along with the value.
+ * ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+ArrayStatistics<T, ReduceType> ArrayStats(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, int statistics, T countVal)
+{
+   ArrayStatistics<T, ReduceType> result;
+
+   if (!arr || n <= 0) {
+      return result;
+   }
+
+   const bool doMin = statistics & (ARRAY_STAT_MIN | ARRAY_STAT_MINLOC);
+   const bool doMax = statistics & (ARRAY_STAT_MAX | ARRAY_STAT_MAXLOC);
+   const bool doSum = statistics & ARRAY_STAT_SUM;
+   const bool doSumOfSquares = statistics & ARRAY_STAT_SUM_OF_SQUARES;
+   const bool doCount = statistics & ARRAY_STAT_COUNT;
+   const bool masked = (bool) mask;
+
+#if defined(__GPUCC__)
+   // Enough chunks to fill the device
+   const int maxChunks = 64 * 1024 ;
+#else
+   const int maxChunks = 1024 ;
+#endif
+   const int numChunks = n < maxChunks ? n : maxChunks ;
+   const ArrayStatistics<T, ReduceType> initial = result;
+   care::host_device_ptr<ArrayStatistics<T, ReduceType> > partials(numChunks, "ArrayStats partials");
+
+   LOOP_STREAM(c, 0, numChunks) {
+      ArrayStatistics<T, ReduceType> partial = initial;
+
+      for (long long index = c ; index < n ; index += numChunks) {
+         const int i = (int) index;
+
+         if (!masked || mask[i]) {
+            const T val = arr[i];
+            ++partial.numIncluded;
+
+            if (doMin && (partial.minLoc < 0 || val < partial.min)) {
+               partial.min = val;
+               partial.minLoc = i;
+            }
+
+            if (doMax && (partial.maxLoc < 0 || partial.max < val)) {
+               partial.max = val;
+               partial.maxLoc = i;
+            }
+
+            if (doSum) {
+               partial.sum += (ReduceType) val;
+            }
+
+            if (doSumOfSquares) {
+               partial.sumOfSquares += (ReduceType) val * (ReduceType) val;
+            }
+
+            if (doCount) {
+               partial.count += (int) (val == countVal);
+            }
+         }
+      }
+
+      partials[c] = partial;
+   } LOOP_STREAM_END
+
+   // Each round folds groups of up to 64 partials, spaced stride apart, into
+   // the first of the group
+   for (int stride = 1 ; stride < numChunks ; stride *= 64) {
+      const int groupSize = 64 * stride ;
+      const int numGroups = (numChunks + groupSize - 1) / groupSize ;
+
+      LOOP_STREAM(g, 0, numGroups) {
+         const int first = g * groupSize ;
+         ArrayStatistics<T, ReduceType> total = partials[first];
+
+         for (int k = 1 ; k < 64 && first + k * stride < numChunks ; ++k) {
+            CombineArrayStatistics(total, partials[first + k * stride]);
+         }
+
+         partials[first] = total;
+      } LOOP_STREAM_END
+   }
+
+   result = partials.pick(0);
+   partials.free();
+
+   return result;
+}
+
+template <typename T, typename ReduceType, typename Exec>
+inline ArrayStatistics<T, ReduceType> ArrayStats(care::host_device_ptr<const T> arr, int n, int statistics, T countVal)
+{
+   return ArrayStats<T, ReduceType, Exec>(arr, care::host_device_ptr<int const>(nullptr), n, statistics, countVal);
 }
 
+/************************************************************************
+ * Struct    : SegmentedValue
+ * Purpose   : A value tagged with whether it begins a new segment (head)
+ *             and whether it holds any data yet (valid). Scanning these with
+ *             SegmentedOperator turns any associative binop into its
+ *             segmented form, so the stock scan kernels can be used for
+ *             segmented scans and for combining per-partition carries.
+ ************************************************************************/
+template <typename T>
+struct SegmentedValue {
+   int head;
+   int valid;
+   T value;
+};
+
+template <typename T, typename Fn>
+struct SegmentedOperator {
+   Fn binop;
+
+   CARE_HOST_DEVICE static SegmentedValue<T> identity() {
+      return SegmentedValue<T>{0, 0, T()};
+   }
+
+   CARE_HOST_DEVICE SegmentedValue<T> operator()(const SegmentedValue<T>& lhs, const SegmentedValue<T>& rhs) const {
+      if (rhs.head || !lhs.valid) {
+         return SegmentedValue<T>{lhs.head | rhs.head, rhs.valid, rhs.value};
+      }
+      else if (!rhs.valid) {
+         return lhs;
+      }
+      else {
+         return SegmentedValue<T>{lhs.head, 1, binop(lhs.value, rhs.value)};
+      }
+   }
+};
+
+/* value / index pair reduced by SegmentedArgMin. loc is -1 until a value is seen. */
+template <typename T>
+struct ValueLoc {
+   T value;
+   int loc;
+};
+
 template <typename T>
-inline CARE_HOST_DEVICE T ArrayMin(care::local_ptr<const T> arr, int n, T initVal, int startIndex)  {
-   T min = initVal;
-   for (int k = startIndex; k < n; ++k) {
-      min = CARE_MIN(min, arr[k]);
+struct ArgMinOperator {
+   CARE_HOST_DEVICE ValueLoc<T> operator()(const ValueLoc<T>& lhs, const ValueLoc<T>& rhs) const {
+      // ties keep lhs, which always holds the lower index
+      return (rhs.loc >= 0 && (lhs.loc < 0 || rhs.value < lhs.value)) ? rhs : lhs;
    }
-   return min;
-}
+};
+
+template <typename T, typename R>
+struct SegmentedCast {
+   CARE_HOST_DEVICE R operator()(const T& value, int) const {
+      return (R) value;
+   }
+};
 
 template <typename T>
-inline CARE_HOST_DEVICE T ArrayMin(care::local_ptr<T> arr, int n, T initVal, int startIndex)  {
-   return ArrayMin<T>((care::local_ptr<const T>)arr, n, initVal, startIndex);
+struct SegmentedValueLoc {
+   CARE_HOST_DEVICE ValueLoc<T> operator()(const T& value, int i) const {
+      return ValueLoc<T>{value, i};
+   }
+};
+
+/************************************************************************
+ * Function  : SegmentedMergePathSearch
+ * Purpose   : Merge path search over the implicit merge of segment ends
+ *             (offsets[1..numSegments], relative to offsets[0]) with the
+ *             element indices [0, length). Segment ends are merged ahead of
+ *             elements with the same value, so empty segments are consumed
+ *             before the next element. Returns the number of segment ends
+ *             that precede the diagonal; the number of elements is
+ *             diagonal minus the return value.
+ ************************************************************************/
+CARE_HOST_DEVICE inline int SegmentedMergePathSearch(const int *offsets, const int numSegments,
+                                                     const int length, const int diagonal)
+{
+   const int first = offsets[0] ;
+   int lo = diagonal > length ? diagonal - length : 0 ;
+   int hi = diagonal < numSegments ? diagonal : numSegments ;
+
+   while (lo < hi) {
+      const int mid = lo + ((hi - lo) >> 1) ;
+
+      if (offsets[mid + 1] - first <= diagonal - mid - 1) {
+         lo = mid + 1 ;
+      }
+      else {
+         hi = mid ;
+      }
+   }
+
+   return lo ;
 }
 
 /************************************************************************
- * Function  : ArrayMinLoc
- * Author(s) : Peter Robinson
- * Purpose   : Returns the minimum value in a ManagedArray
- * ************************************************************************/
-template <typename T, typename Exec>
-inline T ArrayMinLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc)  {
-   RAJAReduceMinLoc<T> min { initVal, -1 };
-   LOOP_REDUCE(k, 0, n) {
-      min.minloc(arr[k], k);
-   } LOOP_REDUCE_END
-   loc = min.getLoc();
-   return (T)min;
+ * Function  : SegmentedReduce
+ * Purpose   : Reduces each segment [offsets[s], offsets[s+1]) of arr into
+ *             result[s] with binop, where each element is first mapped
+ *             through transform(value, index). Empty segments get identity.
+ *             The merged sequence of segment ends and elements is split into
+ *             equal slices (merge path), so every thread does the same
+ *             amount of work no matter how uneven the segment lengths are.
+ *             Segments that cross slice boundaries are completed with a
+ *             segmented scan over the per-slice carries.
+ ************************************************************************/
+template <typename T, typename R, typename Transform, typename Fn, typename Exec=RAJAExec>
+void SegmentedReduce(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments,
+                     care::host_device_ptr<R> result, R identity, Transform transform, Fn binop)
+{
+   if (numSegments <= 0) {
+      return ;
+   }
+
+   const int itemsPerPartition = 64 ;
+   const int first = offsets.pick(0) ;
+   const int length = offsets.pick(numSegments) - first ;
+   const int total = numSegments + length ;
+   const int numPartitions = (total + itemsPerPartition - 1) / itemsPerPartition ;
+
+   care::host_device_ptr<int> boundaries(numPartitions + 1, "SegmentedReduce boundaries") ;
+   care::host_device_ptr<SegmentedValue<R>> carries(numPartitions, "SegmentedReduce carries") ;
+
+   LOOP_STREAM(p, 0, numPartitions + 1) {
+      const int diagonal = p * itemsPerPartition < total ? p * itemsPerPartition : total ;
+      boundaries[p] = SegmentedMergePathSearch(offsets, numSegments, length, diagonal) ;
+   } LOOP_STREAM_END
+
+   LOOP_STREAM(p, 0, numPartitions) {
+      const int diagonal = p * itemsPerPartition ;
+      const int nextDiagonal = diagonal + itemsPerPartition < total ? diagonal + itemsPerPartition : total ;
+      const int segStart = boundaries[p] ;
+      const int segEnd = boundaries[p + 1] ;
+      const int elemEnd = nextDiagonal - segEnd ;
+
+      int seg = segStart ;
+      int elem = diagonal - segStart ;
+      R partial = identity ;
+
+      for (int d = diagonal ; d < nextDiagonal ; ++d) {
+         if (seg < segEnd && (elem >= elemEnd || offsets[seg + 1] - first <= elem)) {
+            // the first segment may have started in an earlier slice; it is fixed up below
+            result[seg] = partial ;
+            partial = identity ;
+            ++seg ;
+         }
+         else {
+            partial = binop(partial, transform(arr[first + elem], first + elem)) ;
+            ++elem ;
+         }
+      }
+
+      if (segEnd < numSegments) {
+         carries[p] = SegmentedValue<R>{segStart != segEnd, 1, partial} ;
+      }
+      else {
+         carries[p] = SegmentedValue<R>{1, 0, partial} ;
+      }
+   } LOOP_STREAM_END
+
+   if (numPartitions > 1) {
+      inclusive_scan<SegmentedValue<R>, Exec, SegmentedOperator<R, Fn>>(carries, nullptr, numPartitions,
+                                                                         SegmentedOperator<R, Fn>{binop}, true) ;
+
+      LOOP_STREAM(p, 1, numPartitions) {
+         const int seg = boundaries[p] ;
+
+         // the segment in progress at the start of this slice ends within it
+         if (seg < boundaries[p + 1]) {
+            result[seg] = binop(carries[p - 1].value, result[seg]) ;
+         }
+      } LOOP_STREAM_END
+   }
+
+   boundaries.free() ;
+   carries.free() ;
 }
 
 /************************************************************************
- * Function  : ArrayMaxLoc
- * Author(s) : Peter Robinson
- * Purpose   : Returns the maximum value in a ManagedArray
- * ************************************************************************/
-template <typename T, typename Exec>
-inline T ArrayMaxLoc(care::host_device_ptr<const T> arr, int n, T initVal, int & loc)  {
-   RAJAReduceMaxLoc<T> max { initVal, -1 };
-   LOOP_REDUCE(k, 0, n) {
-      max.maxloc(arr[k], k);
-   } LOOP_REDUCE_END
-   loc = max.getLoc();
-   return (T)max;
+ * Function  : SegmentedSum
+ * Purpose   : result[s] is the sum of arr over [offsets[s], offsets[s+1]),
+ *             or 0 for an empty segment. offsets has numSegments+1 entries.
+ ************************************************************************/
+template <typename T, typename ReduceType, typename Exec>
+void SegmentedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, care::host_device_ptr<ReduceType> result)
+{
+   SegmentedReduce<T, ReduceType, SegmentedCast<T, ReduceType>, RAJA::operators::plus<ReduceType>, Exec>(
+      arr, offsets, numSegments, result, ReduceType(0),
+      SegmentedCast<T, ReduceType>{}, RAJA::operators::plus<ReduceType>{}) ;
 }
 
 /************************************************************************
- * Function  : ArrayMax
- * Author(s) : Peter Robinson
- * Purpose   : Returns the maximum value in a ManagedArray
- * ************************************************************************/
+ * Function  : SegmentedMin
+ * Purpose   : result[s] is the minimum of initVal and arr over
+ *             [offsets[s], offsets[s+1]).
+ ************************************************************************/
 template <typename T, typename Exec>
-inline T ArrayMax(care::host_device_ptr<const T> arr, int n, T initVal)  {
-   RAJAReduceMax<T> max { initVal };
-   LOOP_REDUCE(k, 0, n) {
-      max.max(arr[k]);
-   } LOOP_REDUCE_END
-   return (T)max;
+void SegmentedMin(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, T initVal, care::host_device_ptr<T> result)
+{
+   SegmentedReduce<T, T, SegmentedCast<T, T>, RAJA::operators::minimum<T>, Exec>(
+      arr, offsets, numSegments, result, initVal,
+      SegmentedCast<T, T>{}, RAJA::operators::minimum<T>{}) ;
 }
 
+/************************************************************************
+ * Function  : SegmentedMax
+ * Purpose   : result[s] is the maximum of initVal and arr over
+ *             [offsets[s], offsets[s+1]).
+ ************************************************************************/
 template <typename T, typename Exec>
-inline T ArrayMax(care::host_device_ptr<T> arr, int n, T initVal)  {
-   return ArrayMax<T, Exec>((care::host_device_ptr<const T>)arr, n, initVal);;
+void SegmentedMax(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, T initVal, care::host_device_ptr<T> result)
+{
+   SegmentedReduce<T, T, SegmentedCast<T, T>, RAJA::operators::maximum<T>, Exec>(
+      arr, offsets, numSegments, result, initVal,
+      SegmentedCast<T, T>{}, RAJA::operators::maximum<T>{}) ;
 }
 
 /************************************************************************
- * Function  : ArrayMax
- * Author(s) : Peter Robinson
- * Purpose   : Returns the maximum value in a ManagedArray
- * ************************************************************************/
-template <typename T>
-CARE_HOST_DEVICE inline T ArrayMax(care::local_ptr<const T> arr, int n, T initVal)  {
-   T max = initVal;
-   for (int k = 0; k < n; ++k) {
-      max = CARE_MAX(max, arr[k]);
+ * Function  : SegmentedArgMin
+ * Purpose   : result[s] is the index into arr of the minimum value in
+ *             [offsets[s], offsets[s+1]), the lowest such index on ties,
+ *             or -1 for an empty segment.
+ ************************************************************************/
+template <typename T, typename Exec>
+void SegmentedArgMin(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> offsets, int numSegments, care::host_device_ptr<int> result)
+{
+   if (numSegments <= 0) {
+      return ;
    }
-   return max;
-}
 
-template <typename T>
-CARE_HOST_DEVICE inline T ArrayMax(care::local_ptr<T> arr, int n, T initVal)  {
-   return ArrayMax<T>((care::local_ptr<const T>)arr, n, initVal);
+   care::host_device_ptr<ValueLoc<T>> mins(numSegments, "SegmentedArgMin mins") ;
+
+   SegmentedReduce<T, ValueLoc<T>, SegmentedValueLoc<T>, ArgMinOperator<T>, Exec>(
+      arr, offsets, numSegments, mins, ValueLoc<T>{T(), -1},
+      SegmentedValueLoc<T>{}, ArgMinOperator<T>{}) ;
+
+   LOOP_STREAM(s, 0, numSegments) {
+      result[s] = mins[s].loc ;
+   } LOOP_STREAM_END
+
+   mins.free() ;
 }
 
 /************************************************************************
- * Function  : ArrayFind
- * Author(s) : Rob Neely, Alan Dayton
- * Purpose   : Returns the index of the first element in the the array
- *             that equals the value, or -1 if no match is found.
+ * Function  : segmented_exclusive_scan
+ * Purpose   : Exclusive scan of inData with binop that restarts from val at
+ *             the start of every segment [offsets[s], offsets[s+1]). Results
+ *             are written to the same positions of outData, which may alias
+ *             inData. Implemented as a single inclusive scan of
+ *             SegmentedValues, so the load balance does not depend on the
+ *             segment lengths.
  ************************************************************************/
-template <typename T>
-int ArrayFind(care::host_device_ptr<const T> arr, const int len, const T val, const int start)
+template <typename T, typename Exec, typename Fn>
+void segmented_exclusive_scan(care::host_device_ptr<const T> inData, care::host_device_ptr<T> outData,
+                              care::host_device_ptr<int const> offsets, int numSegments,
+                              Fn binop, T val)
 {
-   RAJAReduceMin<int> min { len };
+   if (numSegments <= 0) {
+      return ;
+   }
+
+   const int first = offsets.pick(0) ;
+   const int length = offsets.pick(numSegments) - first ;
+
+   if (length <= 0) {
+      return ;
+   }
+
+   care::host_device_ptr<SegmentedValue<T>> values(length, "segmented_exclusive_scan values") ;
+
+   /* shifting the input by one turns the inclusive scan into an exclusive one */
+   LOOP_STREAM(i, 0, length) {
+      values[i] = SegmentedValue<T>{0, 1, i > 0 ? inData[first + i - 1] : val} ;
+   } LOOP_STREAM_END
 
-   LOOP_REDUCE(i, start, len) {
-      if (arr[i] == val) {
-         min.min(i);
+   LOOP_STREAM(s, 0, numSegments) {
+      const int start = offsets[s] - first ;
+
+      if (start < offsets[s + 1] - first) {
+         values[start] = SegmentedValue<T>{1, 1, val} ;
       }
-   } LOOP_REDUCE_END
+   } LOOP_STREAM_END
 
-   int result = (int) min;
+   inclusive_scan<SegmentedValue<T>, Exec, SegmentedOperator<T, Fn>>(values, nullptr, length,
+                                                                      SegmentedOperator<T, Fn>{binop}, true) ;
 
-   if (result == len) {
-      return -1 ;
-   }
-   else {
-      return result;
-   }
+   LOOP_STREAM(i, 0, length) {
+      outData[first + i] = values[i].value ;
+   } LOOP_STREAM_END
+
+   values.free() ;
 }
 
 /************************************************************************
- * Function  : ArrayMax
- * Author(s) : Peter Robinson
- * Purpose   : Returns the maximum value in a ManagedArray.
- *             Wraps above care::host_device_ptr implementation with a care::host_ptr API.
- * ************************************************************************/
-template <typename T>
-inline T ArrayMax(care::host_ptr<const T> arr, int n, T initVal)  {
-   return ArrayMax<T, RAJA::seq_exec>(care::host_device_ptr<const T>((const T *) arr, n, "ArrayMaxTmp"), n, initVal);
-}
+ * Struct    : RadixKey
+ * Purpose   : Maps arithmetic values to unsigned integers with the same
+ *             ordering, so they can be selected a byte at a time. Signed
+ *             integers have their sign bit flipped. Floating point values
+ *             have every bit flipped if negative and only the sign bit
+ *             flipped otherwise, which orders -0.0 just below 0.0 and NaNs
+ *             with a clear sign bit above infinity.
+ ************************************************************************/
+template <typename T, typename Enable = void>
+struct RadixKey ;
 
 template <typename T>
-inline T ArrayMax(care::host_ptr<T> arr, int n, T initVal)  {
-   return ArrayMax<T>((care::host_ptr<const T>)arr, n, initVal);
-}
+struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+   using type = typename std::conditional<sizeof(T) <= sizeof(unsigned int), unsigned int, unsigned long long>::type ;
+   static constexpr type signBit = std::is_signed<T>::value ? (type) 1 << (8 * sizeof(type) - 1) : (type) 0 ;
 
-/************************************************************************
- * Function  : ArrayMinMax
- * Author(s) : Peter Robinson
- * Purpose   : Stores Minimum / Maximum values of arr (as a double) in outMin / outMax;
- *             If mask was such that no values were compared, returns 0, outMin will be -DBL_MAX, outMax will be DBL_MAX
- *             Otherwise, returns 1.
- * ************************************************************************/
-template <typename T, typename ReducerType, typename RAJAExec>
-int ArrayMinMax(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax) {
-   bool result = false;
-   ReducerType minVal, maxVal;
-   if (arr) {
-      RAJAReduceMax<ReducerType> max { std::numeric_limits<ReducerType>::lowest() };
-      RAJAReduceMin<ReducerType> min { std::numeric_limits<ReducerType>::max() };
-      if (mask) {
-         LOOP_REDUCE(i, 0, n) {
-            if (mask[i]) {
-               min.min((ReducerType) arr[i]);
-               max.max((ReducerType) arr[i]);
-            }
-         } LOOP_REDUCE_END
-         minVal = (ReducerType) min;
-         maxVal = (ReducerType) max;
-         if (minVal!= std::numeric_limits<ReducerType>::max() ||
-             maxVal != std::numeric_limits<ReducerType>::lowest()) {
-            result = true;
-         }
-      }
-      else {
-         LOOP_REDUCE(i, 0, n) {
-            min.min((ReducerType)arr[i]);
-            max.max((ReducerType)arr[i]);
-         } LOOP_REDUCE_END
-         minVal = (ReducerType) min;
-         maxVal = (ReducerType) max;
-         result = true;
-      }
+   CARE_HOST_DEVICE static type toKey(const T value) {
+      return (type) value ^ signBit ;
    }
-   if (result) {
-      *outMin = (double) minVal;
-      *outMax = (double) maxVal;
+
+   CARE_HOST_DEVICE static T fromKey(const type key) {
+      return (T) (key ^ signBit) ;
    }
-   else {
-      *outMin = -DBL_MAX;
-      *outMax = +DBL_MAX;
+};
+
+template <typename T>
+struct RadixKey<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+   static_assert(sizeof(T) == sizeof(unsigned int) || sizeof(T) == sizeof(unsigned long long),
+                 "RadixKey supports 32 and 64 bit floating point types") ;
+
+   using type = typename std::conditional<sizeof(T) == sizeof(unsigned int), unsigned int, unsigned long long>::type ;
+   static constexpr type signBit = (type) 1 << (8 * sizeof(type) - 1) ;
+
+   CARE_HOST_DEVICE static type toKey(const T value) {
+      type bits ;
+      memcpy(&bits, &value, sizeof(T)) ;
+      return bits & signBit ? ~bits : bits | signBit ;
    }
 
-   return (int) result;
-}
+   CARE_HOST_DEVICE static T fromKey(const type key) {
+      const type bits = key & signBit ? key ^ signBit : ~key ;
+      T value ;
+      memcpy(&value, &bits, sizeof(T)) ;
+      return value ;
+   }
+};
 
-template <typename T, typename ReducerType, typename RAJAExec>
-inline int ArrayMinMax(care::host_device_ptr<T> arr, care::host_device_ptr<int> mask, int n, double *outMin, double *outMax) {
- return ArrayMinMax<T, ReducerType, RAJAExec>((care::host_device_ptr<const T>)arr, (care::host_device_ptr<int const>)mask, n, outMin, outMax);
-}
+/* the selected key, with the number of keys below it and equal to it */
+template <typename T>
+struct RadixSelection {
+   typename RadixKey<T>::type key ;
+   int numLess ;
+   int numEqual ;
+};
 
-#if CARE_HAVE_LLNL_GLOBALID
+/************************************************************************
+ * Function  : RadixSelect
+ * Purpose   : Finds the key of rank k (0 based, ascending) of arr without
+ *             sorting. Each pass histograms the next byte of the keys that
+ *             share the bytes chosen so far and picks the bucket holding
+ *             rank k, so at most sizeof(T) passes are needed. Once the
+ *             surviving keys are a small fraction of those read, they are
+ *             compacted so later passes only read the survivors.
+ *             On the device the histogram is built with atomics; on the
+ *             host each chunk of the input builds its own histogram, which
+ *             avoids contention when most keys share a byte.
+ ************************************************************************/
+template <typename T, typename Exec>
+RadixSelection<T> RadixSelect(care::host_device_ptr<const T> arr, int n, int k)
+{
+   using Key = typename RadixKey<T>::type ;
+
+   const int numBuckets = 256 ;
+   Key prefix = 0 ;
+   Key prefixMask = 0 ;
+   int numLess = 0 ;
+   int numCandidates = n ;
+   care::host_device_ptr<Key> candidates = nullptr ;
+   care::host_device_ptr<int> hist(numBuckets, "RadixSelect hist") ;
+
+   for (int shift = 8 * (int) sizeof(Key) - 8 ; shift >= 0 ; shift -= 8) {
+      const bool compacted = candidates != nullptr ;
+      care::host_device_ptr<const Key> keys = candidates ;
+
+      LOOP_STREAM(b, 0, numBuckets) {
+         hist[b] = 0 ;
+      } LOOP_STREAM_END
 
-template <typename Exec=RAJAExec>
-int ArrayMinMax(care::host_device_ptr<const globalID> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax);
+#if defined(__GPUCC__) && defined(GPU_ACTIVE)
+      LOOP_STREAM(i, 0, numCandidates) {
+         const Key key = compacted ? keys[i] : RadixKey<T>::toKey(arr[i]) ;
 
-template <typename Exec>
-inline int ArrayMinMax(care::host_device_ptr<const globalID> arr, care::host_device_ptr<int const> mask, int n, double *outMin, double *outMax) {
-   return ArrayMinMax<globalID, GIDTYPE, Exec>(arr, mask, n, outMin, outMax);
-}
+         if ((key & prefixMask) == prefix) {
+            ATOMIC_ADD(hist[(int) ((key >> shift) & 0xFF)], 1) ;
+         }
+      } LOOP_STREAM_END
+#else
+      const int chunkSize = 4096 ;
+      const int numChunks = (numCandidates + chunkSize - 1) / chunkSize ;
+      care::host_device_ptr<int> chunkHist(numChunks * numBuckets, "RadixSelect chunkHist") ;
 
-#endif // CARE_HAVE_LLNL_GLOBALID
+      LOOP_STREAM(c, 0, numChunks) {
+         int * local = &chunkHist[c * numBuckets] ;
+         const int end = (c + 1) * chunkSize < numCandidates ? (c + 1) * chunkSize : numCandidates ;
 
-/************************************************************************
- * Function  : ArrayMinMax
- * Author(s) : Peter Robinson
- * Purpose   : Stores Minimum / Maximum values of arr (as a double) in outMin / outMax;
- *             If mask was such that no values were compared, returns 0, outMin will be -DBL_MAX, outMax will be DBL_MAX
- *             Otherwise, returns 1.
- *             care::local_ptr API to support calls from within RAJA contexts.
- * ************************************************************************/
-template <typename T>
-CARE_HOST_DEVICE inline int ArrayMinMax(care::local_ptr<const T> arr, care::local_ptr<int const> mask, int n, double *outMin, double *outMax) {
-   bool result = false;
-   // a previous implementation had min and max as a templated type and then used std::numeric_limits<T>::lowest() and 
-   // std::numeric_limits<ReducerType>::max() for initial values, but that is not valid on the device and results in 
-   // warnings and undefined behavior at runtime.
-   double min, max;
-   if (arr) {
-      max =  -DBL_MAX; 
-      min =  DBL_MAX;
-      if (mask) {
-         for (int i = 0; i < n; ++i) {
-            if (mask[i]) {
-               min = CARE_MIN(min, (double)arr[i]);
-               max = CARE_MAX(max, (double)arr[i]);
+         for (int b = 0 ; b < numBuckets ; ++b) {
+            local[b] = 0 ;
+         }
+
+         for (int i = c * chunkSize ; i < end ; ++i) {
+            const Key key = compacted ? keys[i] : RadixKey<T>::toKey(arr[i]) ;
+
+            if ((key & prefixMask) == prefix) {
+               ++local[(int) ((key >> shift) & 0xFF)] ;
             }
          }
-         if (min != DBL_MAX ||
-             max != -DBL_MAX) {
-            result = true;
+      } LOOP_STREAM_END
+
+      LOOP_STREAM(b, 0, numBuckets) {
+         int count = 0 ;
+
+         for (int c = 0 ; c < numChunks ; ++c) {
+            count += chunkHist[c * numBuckets + b] ;
          }
+
+         hist[b] = count ;
+      } LOOP_STREAM_END
+
+      chunkHist.free() ;
+#endif
+
+      /* find the bucket holding rank k on the host, only 256 values */
+      care::host_ptr<const int> hostHist = hist ;
+      int bucket = 0 ;
+
+      while (bucket < numBuckets - 1 && k >= hostHist[bucket]) {
+         k -= hostHist[bucket] ;
+         numLess += hostHist[bucket] ;
+         ++bucket ;
       }
-      else {
-         for (int i = 0; i < n; ++i) {
-            min = CARE_MIN(min, (double)arr[i]);
-            max = CARE_MAX(max, (double)arr[i]);
+
+      const int numSurvivors = hostHist[bucket] ;
+      prefix |= (Key) bucket << shift ;
+      prefixMask |= (Key) 0xFF << shift ;
+
+      if (shift == 0) {
+         numCandidates = numSurvivors ;
+      }
+      else if (numSurvivors <= numCandidates / 8) {
+         care::host_device_ptr<Key> survivors(numSurvivors > 0 ? numSurvivors : 1, "RadixSelect survivors") ;
+         int numKept = 0 ;
+
+         SCAN_LOOP(i, 0, numCandidates, pos, numKept,
+                   ((compacted ? keys[i] : RadixKey<T>::toKey(arr[i])) & prefixMask) == prefix) {
+            survivors[pos] = compacted ? keys[i] : RadixKey<T>::toKey(arr[i]) ;
+         } SCAN_LOOP_END(numCandidates, pos, numKept)
+
+         if (compacted) {
+            candidates.free() ;
          }
-         result = true;
+
+         candidates = survivors ;
+         numCandidates = numKept ;
       }
    }
-   if (result) {
-      *outMin = (double) min;
-      *outMax = (double) max;
-   }
-   else {
-      *outMin = -DBL_MAX;
-      *outMax = +DBL_MAX;
+
+   if (candidates) {
+      candidates.free() ;
    }
-   return (int) result;
-}
 
-template <typename T>
-CARE_HOST_DEVICE inline int ArrayMinMax(care::local_ptr<T> arr, care::local_ptr<int> mask, int n, double *outMin, double *outMax)
-{
-   return ArrayMinMax<T>((care::local_ptr<const T>)arr, (care::local_ptr<int const>)mask, n, outMin, outMax);
-}
+   hist.free() ;
 
-/************************************************************************
- * Function  : ArrayCount
- * Author(s) : Peter Robinson
- * Purpose   : Returns count of occurence of val in arr.
- * ************************************************************************/
-template <typename T, typename Exec>
-inline int  ArrayCount(care::host_device_ptr<const T> arr, int length, T val)  {
-   RAJAReduceSum<int> count { 0 };
-   LOOP_REDUCE(k, 0, length) {
-      count += (int) arr[k] == val;
-   } LOOP_REDUCE_END
-   return (int) count ;
+   return RadixSelection<T>{prefix, numLess, numCandidates} ;
 }
 
 /************************************************************************
- * Function  : ArraySum
- * Author(s) : Peter Robinson
- * Purpose   : Returns the sum of all values in a ManagedArray
- * ************************************************************************/
-template <typename T, typename ReduceType, typename Exec>
-inline T ArraySum(care::host_device_ptr<const T> arr, int n, T initVal)  {
-   ReduceType iVal = initVal;
-   RAJAReduceSum<ReduceType> sum { iVal };
-   LOOP_REDUCE(k, 0, n) {
-      sum += arr[k];
-   } LOOP_REDUCE_END
-   return (T) (ReduceType) sum;
-}
+ * Function  : NthElement
+ * Purpose   : Returns the value that would be at index k (0 <= k < n) if
+ *             arr were sorted in ascending order, without sorting or
+ *             copying arr. Floating point values are ordered as by
+ *             RadixKey, which agrees with operator< for everything but NaN.
+ *             k outside [0, n) is clamped with a warning, and an empty
+ *             arr gives T(0).
+ ************************************************************************/
+template <typename T, typename Exec>
+T NthElement(care::host_device_ptr<const T> arr, int n, int k)
+{
+   if (n <= 0) {
+      printf("Warning in NthElement<T>: array is empty!\n") ;
+      return T(0) ;
+   }
 
-/************************************************************************
- * Function  : ArraySumSubset
- * Author(s) : Peter Robinson
- * Purpose   : Returns the sum of values in arr at indices in subset.
- * Note      : length n refers to length of subset, not array
- * ************************************************************************/
-template <typename T, typename ReduceType, typename Exec>
-inline T ArraySumSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> subset, int n, T initVal) {
-   ReduceType iVal = initVal;
-   RAJAReduceSum<ReduceType> sum { iVal };
-   LOOP_REDUCE(k, 0, n) {
-      sum += arr[subset[k]];
-   } LOOP_REDUCE_END
-   return (T) (ReduceType) sum;
-}
+   if (k < 0 || k >= n) {
+      printf("Warning in NthElement<T>: k = %d is not in [0, %d)!\n", k, n) ;
+      k = k < 0 ? 0 : n - 1 ;
+   }
 
-/************************************************************************
- * Function  : ArrayMaskedSumSubset
- * Author(s) : Peter Robinson
- * Purpose   : Returns the sum of values in arr at indices in subset.
- * ************************************************************************/
-template <typename T, typename ReduceType, typename Exec>
-inline T ArrayMaskedSumSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, care::host_device_ptr<int const> subset, int n, T initVal) {
-   ReduceType iVal =initVal;
-   RAJAReduceSum<ReduceType> sum { iVal };
-   LOOP_REDUCE(k, 0, n) {
-      int ndx = subset[k];
-      if (mask[ndx] == 0) {
-         sum += arr[ndx];
-      }
-   } LOOP_REDUCE_END
-   return (T) (ReduceType) sum;
+   return RadixKey<T>::fromKey(RadixSelect<T, Exec>(arr, n, k).key) ;
 }
 
 /************************************************************************
- * Function  : ArrayMaskedSum
- * Author(s) : Peter Robinson
- * Purpose   : Returns the sum of values in arr at indices where mask is 0.
- * ************************************************************************/
-template<typename T, typename ReduceType, typename Exec>
-T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> mask, int n, T initVal)
+ * Function  : TopK
+ * Purpose   : Allocates values and indices with length k and fills them
+ *             with the k largest values of arr and their indices, in the
+ *             order they appear in arr. Among values equal to the smallest
+ *             one kept, those with the lowest indices are kept.
+ *             k is clamped to [0, n].
+ ************************************************************************/
+template <typename T, typename Exec>
+void TopK(care::host_device_ptr<const T> arr, int n, int k, care::host_device_ptr<T> & values, care::host_device_ptr<int> & indices)
 {
-   ReduceType iVal = initVal;
-   RAJAReduceSum<ReduceType> sum { iVal };
+   using Key = typename RadixKey<T>::type ;
 
-   LOOP_STREAM(i, 0, n) {
-      sum += arr[i] * T(mask[i] == 0);
-   } LOOP_STREAM_END
+   k = k < 0 ? 0 : (k > n ? n : k) ;
+   values = care::host_device_ptr<T>(k > 0 ? k : 1, "TopK values") ;
+   indices = care::host_device_ptr<int>(k > 0 ? k : 1, "TopK indices") ;
 
-   return (T) (ReduceType) sum ;
+   if (k == 0) {
+      return ;
+   }
+
+   const RadixSelection<T> selection = RadixSelect<T, Exec>(arr, n, n - k) ;
+   const Key threshold = selection.key ;
+   const int numGreater = n - selection.numLess - selection.numEqual ;
+   const int numEqualKept = k - numGreater ;
+
+   /* the last index equal to the threshold that is kept */
+   int cutoff = n ;
+
+   if (numEqualKept < selection.numEqual) {
+      care::host_device_ptr<int> equalIndices(selection.numEqual, "TopK equalIndices") ;
+      int numEqual = 0 ;
+
+      SCAN_LOOP(i, 0, n, pos, numEqual, RadixKey<T>::toKey(arr[i]) == threshold) {
+         equalIndices[pos] = i ;
+      } SCAN_LOOP_END(n, pos, numEqual)
+
+      cutoff = equalIndices.pick(numEqualKept - 1) ;
+      equalIndices.free() ;
+   }
+
+   int numKept = 0 ;
+
+   SCAN_LOOP(i, 0, n, pos, numKept,
+             RadixKey<T>::toKey(arr[i]) > threshold || (RadixKey<T>::toKey(arr[i]) == threshold && i <= cutoff)) {
+      values[pos] = arr[i] ;
+      indices[pos] = i ;
+   } SCAN_LOOP_END(n, pos, numKept)
+}
+
+template <typename T, typename Exec>
+void TopK(care::host_device_ptr<const T> arr, int n, int k, care::host_device_ptr<T> & values)
+{
+   care::host_device_ptr<int> indices ;
+   TopK<T, Exec>(arr, n, k, values, indices) ;
+   indices.free() ;
 }
 
 /************************************************************************
@@ -1391,19 +3450,8 @@ T ArrayMaskedSum(care::host_device_ptr<const T> arr, care::host_device_ptr<int c
  * ************************************************************************/
 template <typename T, typename Exec>
 inline int FindIndexGT(care::host_device_ptr<const T> arr, int n, T limit) {
-   RAJAReduceMin<int> minIndexAboveLimit {n};
-   LOOP_REDUCE(i, 0, n) {
-     if ( arr[i] > limit) {
-          minIndexAboveLimit.min(i);
-      }
-   } LOOP_REDUCE_END
-
-   int result = (int)minIndexAboveLimit;
-   if (result >= n) {
-      return -1; // care typically returns -1 for invalid value
-   } else {
-      return result;
-   }
+   // care typically returns -1 for invalid value
+   return FindFirst<T, GreaterThanValue<T>, Exec>(arr, 0, n, GreaterThanValue<T>{limit});
 
    /* above is supposed to be equivalent to below sequential code.
    int i ;
@@ -1533,6 +3581,242 @@ inline T PickAndPerformSum(care::host_device_ptr<const T> arr, care::host_device
    }
 }
 
+//******************************************************************************
+// PickAndPerformSum where mask is a bitset. Values whose bits are set are
+// excluded, as with nonzero entries of an int mask.
+// @param arr Array of length > n
+// @param mask Bitset of same length as arr
+// @param subset Array of length n.
+//
+template<typename T, typename ReduceType=T, typename Exec=RAJAExec>
+inline T PickAndPerformSum(care::host_device_ptr<const T> arr, care::bitset const & mask, care::host_device_ptr<int const> subset, int n)
+{
+   if (mask) {
+      if (subset) {
+         return ArrayMaskedSumSubset<T, ReduceType, Exec>(arr, mask, subset, n, T(0));
+      }
+      else {
+         return ArrayMaskedSum<T, ReduceType, Exec>(arr, mask, n, T(0));
+      }
+   }
+   else {
+      return SumArrayOrArraySubset<T, Exec>(arr, subset, n);
+   }
+}
+
+
+/* argument policies for FindIndexExtremum */
+template <typename T>
+struct ArgMin {
+   using Reducer = RAJAReduceMinLoc<T> ;
+
+   static T identity() {
+      return std::numeric_limits<T>::max() ;
+   }
+
+   CARE_HOST_DEVICE static void update(Reducer const & r, const T & val, int loc) {
+      r.minloc(val, loc) ;
+   }
+};
+
+template <typename T>
+struct ArgMax {
+   using Reducer = RAJAReduceMaxLoc<T> ;
+
+   static T identity() {
+      return std::numeric_limits<T>::lowest() ;
+   }
+
+   CARE_HOST_DEVICE static void update(Reducer const & r, const T & val, int loc) {
+      r.maxloc(val, loc) ;
+   }
+};
+
+struct AllIndices {
+   CARE_HOST_DEVICE int operator()(int i) const {
+      return i ;
+   }
+};
+
+struct SubsetIndices {
+   care::host_device_ptr<int const> subset ;
+
+   CARE_HOST_DEVICE int operator()(int i) const {
+      return subset[i] ;
+   }
+};
+
+struct NoThreshold {
+   CARE_HOST_DEVICE bool operator()(int) const {
+      return true ;
+   }
+};
+
+struct AboveThreshold {
+   care::host_device_ptr<double const> thresholds ;
+   double cutoff ;
+
+   CARE_HOST_DEVICE bool operator()(int i) const {
+      return thresholds[i] > cutoff ;
+   }
+};
+
+/* mask policies, checked on the host for the winning index only */
+struct NoIgnoreMask {
+   bool isMaskedOff(int) const {
+      return false ;
+   }
+};
+
+struct IgnoreMask {
+   care::host_device_ptr<int const> mask ;
+
+   bool isMaskedOff(int index) const {
+      return mask.pick(index) == 1 ;
+   }
+};
+
+//******************************************************************************
+// Single pass argmin/argmax engine behind the FindIndexMin* and FindIndexMax*
+// families. Position i in [0, n) is considered if filter(i) holds, and
+// contributes arr[index(i)] at location index(i). A mask only costs a pick of
+// the winning index after the reduction.
+// @param arr      : Data array of length >= max(index(0:n))
+// @param n        : Number of positions to consider
+// @param index    : AllIndices or SubsetIndices, maps a position to an index of arr
+// @param filter   : NoThreshold or AboveThreshold, which positions to consider
+// @param mask     : NoIgnoreMask or IgnoreMask, indexed like arr
+// @param position : (out) if not nullptr, the position of the extremum. Only
+//                   AllIndices may ask for it, since it is the returned index;
+//                   FindSubsetIndexExtremum gives the position in a subset.
+// @returns        : The index of arr holding the extremum, or -1 if there is
+//                   none or it is masked off
+template<typename T, typename Op, typename IndexMap, typename Filter, typename Mask, typename Exec=RAJAExec>
+int FindIndexExtremum(care::host_device_ptr<const T> arr, int n,
+                      IndexMap index, Filter filter, Mask mask,
+                      int * position)
+{
+   using Reducer = typename Op::Reducer ;
+
+   Reducer extremum { Op::identity(), -1 };
+
+   LOOP_REDUCE(i, 0, n) {
+      if (filter(i)) {
+         const int curr = index(i) ;
+         Op::update(extremum, arr[curr], curr) ;
+      }
+   } LOOP_REDUCE_END
+
+   const int loc = extremum.getLoc() ;
+
+   if (position) {
+      *position = loc ;
+   }
+
+   return loc >= 0 && mask.isMaskedOff(loc) ? -1 : loc ;
+}
+
+//******************************************************************************
+// FindIndexExtremum over a subset that also returns the position of the
+// extremum in the subset, which takes a second reduction over the positions.
+// Only the subset and threshold searches that ask for the position use it.
+// @param position : (out) if not nullptr, the position in subset of the extremum
+template<typename T, typename Op, typename Filter, typename Mask, typename Exec=RAJAExec>
+int FindSubsetIndexExtremum(care::host_device_ptr<const T> arr, int n,
+                            SubsetIndices index, Filter filter, Mask mask,
+                            int * position)
+{
+   using Reducer = typename Op::Reducer ;
+
+   if (position == nullptr) {
+      return FindIndexExtremum<T, Op, SubsetIndices, Filter, Mask, Exec>(arr, n, index, filter, mask, nullptr) ;
+   }
+
+   Reducer extremum { Op::identity(), -1 };
+   Reducer positionExtremum { Op::identity(), -1 };
+
+   LOOP_REDUCE(i, 0, n) {
+      if (filter(i)) {
+         const int curr = index(i) ;
+         const T val = arr[curr] ;
+
+         Op::update(extremum, val, curr) ;
+         Op::update(positionExtremum, val, i) ;
+      }
+   } LOOP_REDUCE_END
+
+   const int loc = extremum.getLoc() ;
+
+   *position = positionExtremum.getLoc() ;
+
+   return loc >= 0 && mask.isMaskedOff(loc) ? -1 : loc ;
+}
+
+//******************************************************************************
+// Dispatches FindIndexExtremum on whether an ignore mask is given.
+template<typename T, typename Op, typename IndexMap, typename Filter, typename Exec=RAJAExec>
+int MaskedFindIndexExtremum(care::host_device_ptr<const T> arr,
+                            care::host_device_ptr<int const> mask, int n,
+                            IndexMap index, Filter filter,
+                            int * position)
+{
+   if (mask && n > 0) {
+      return FindIndexExtremum<T, Op, IndexMap, Filter, IgnoreMask, Exec>(arr, n, index, filter, IgnoreMask{mask}, position);
+   }
+   else {
+      return FindIndexExtremum<T, Op, IndexMap, Filter, NoIgnoreMask, Exec>(arr, n, index, filter, NoIgnoreMask{}, position);
+   }
+}
+
+//******************************************************************************
+// Dispatches FindSubsetIndexExtremum on whether an ignore mask is given.
+template<typename T, typename Op, typename Filter, typename Exec=RAJAExec>
+int MaskedFindSubsetIndexExtremum(care::host_device_ptr<const T> arr,
+                                  care::host_device_ptr<int const> mask, int n,
+                                  SubsetIndices index, Filter filter,
+                                  int * position)
+{
+   if (mask && n > 0) {
+      return FindSubsetIndexExtremum<T, Op, Filter, IgnoreMask, Exec>(arr, n, index, filter, IgnoreMask{mask}, position);
+   }
+   else {
+      return FindSubsetIndexExtremum<T, Op, Filter, NoIgnoreMask, Exec>(arr, n, index, filter, NoIgnoreMask{}, position);
+   }
+}
+
+//******************************************************************************
+// Shared implementation of PickAndPerformFindMinIndex and
+// PickAndPerformFindMaxIndex. Selects the policies once on the host, so every
+// combination of subset, thresholds and mask is a single reduction.
+template<typename T, typename Op, typename Exec=RAJAExec>
+int PickAndPerformFindIndexExtremum(care::host_device_ptr<const T> arr,
+                                    care::host_device_ptr<int const> mask,
+                                    care::host_device_ptr<int const> subset, int n,
+                                    care::host_device_ptr<double const> thresholds,
+                                    double cutoff,
+                                    int *thresholdIndex)
+{
+   if (subset) {
+      if (thresholds) {
+         return MaskedFindSubsetIndexExtremum<T, Op, AboveThreshold, Exec>(
+            arr, mask, n, SubsetIndices{subset}, AboveThreshold{thresholds, cutoff}, thresholdIndex);
+      }
+      else {
+         return MaskedFindIndexExtremum<T, Op, SubsetIndices, NoThreshold, Exec>(
+            arr, mask, n, SubsetIndices{subset}, NoThreshold{}, nullptr);
+      }
+   }
+   else {
+      if (thresholds) {
+         return MaskedFindIndexExtremum<T, Op, AllIndices, AboveThreshold, Exec>(
+            arr, mask, n, AllIndices{}, AboveThreshold{thresholds, cutoff}, thresholdIndex);
+      }
+      else {
+         return MaskedFindIndexExtremum<T, Op, AllIndices, NoThreshold, Exec>(
+            arr, mask, n, AllIndices{}, NoThreshold{}, nullptr);
+      }
+   }
+}
 
 //******************************************************************************
 // Return the index of the minimum value of an array.
@@ -1548,22 +3832,14 @@ int FindIndexMinAboveThresholds(care::host_device_ptr<const T> arr, int n,
                                 double cutoff,
                                 int * thresholdIndex)
 {
-   int ndx = -1;
    if (thresholds) {
-      RAJAReduceMinLoc<T> min { std::numeric_limits<T>::max(), ndx };
-      LOOP_REDUCE(i, 0, n) {
-         if (thresholds[i] > cutoff) {
-            min.minloc(arr[i], i);
-         }
-      } LOOP_REDUCE_END
-      ndx = min.getLoc();
-      *thresholdIndex = ndx;
+      return FindIndexExtremum<T, ArgMin<T>, AllIndices, AboveThreshold, NoIgnoreMask, Exec>(
+         arr, n, AllIndices{}, AboveThreshold{thresholds, cutoff}, NoIgnoreMask{}, thresholdIndex);
    }
    else {
-      ArrayMinLoc<T, Exec>(arr, n, std::numeric_limits<T>::max(), ndx);
+      return FindIndexExtremum<T, ArgMin<T>, AllIndices, NoThreshold, NoIgnoreMask, Exec>(
+         arr, n, AllIndices{}, NoThreshold{}, NoIgnoreMask{}, nullptr);
    }
-
-   return ndx ;
 }
 
 //******************************************************************************
@@ -1577,12 +3853,8 @@ int FindIndexMinAboveThresholds(care::host_device_ptr<const T> arr, int n,
 template<typename T, typename Exec>
 int FindIndexMinSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> subset, int lenset)
 {
-   RAJAReduceMinLoc<T> min { std::numeric_limits<T>::max(), -1 };
-   LOOP_REDUCE(i, 0, lenset) {
-      int curr = subset[i] ;
-      min.minloc(arr[curr], curr);
-   } LOOP_REDUCE_END
-   return min.getLoc();
+   return FindIndexExtremum<T, ArgMin<T>, SubsetIndices, NoThreshold, NoIgnoreMask, Exec>(
+      arr, lenset, SubsetIndices{subset}, NoThreshold{}, NoIgnoreMask{}, nullptr);
 }
 
 //******************************************************************************
@@ -1604,24 +3876,13 @@ int FindIndexMinSubsetAboveThresholds(care::host_device_ptr<const T> arr, care::
                                       care::host_device_ptr<double const> thresholds, double cutoff,
                                       int * thresholdIndex)
 {
-   int  ndx = -1 ;
    if (thresholds) {
-      RAJAReduceMinLoc<T> min { std::numeric_limits<T>::max(), -1 };
-      RAJAReduceMinLoc<T> thresholdmin { std::numeric_limits<T>::max(), -1 };
-      LOOP_REDUCE(i, 0, lenset) {
-         int curr = subset[i] ;
-         if (thresholds[i] > cutoff) { // if threshold were sized as arr, this would be thresholds[curr]
-            min.minloc(arr[curr], curr);
-            thresholdmin.minloc(arr[curr], i);
-         }
-      } LOOP_REDUCE_END
-      *thresholdIndex = thresholdmin.getLoc();
-      ndx = min.getLoc();
+      return FindSubsetIndexExtremum<T, ArgMin<T>, AboveThreshold, NoIgnoreMask, Exec>(
+         arr, lenset, SubsetIndices{subset}, AboveThreshold{thresholds, cutoff}, NoIgnoreMask{}, thresholdIndex);
    }
    else {
-      ndx = FindIndexMinSubset<T, Exec>(arr, subset, lenset);
+      return FindIndexMinSubset<T, Exec>(arr, subset, lenset);
    }
-   return ndx ;
 }
 
 //******************************************************************************
@@ -1646,22 +3907,7 @@ int PickAndPerformFindMinIndex(care::host_device_ptr<const T> arr,
                                double cutoff,
                                int *thresholdIndex)
 {
-   int minIndex;
-   if (subset) {
-      minIndex =  FindIndexMinSubsetAboveThresholds<T, Exec>(arr, subset, n,
-                                                             thresholds, cutoff,
-                                                             thresholdIndex);
-   }
-   else {
-      minIndex =   FindIndexMinAboveThresholds<T, Exec>(arr, n, thresholds, cutoff,
-                                                        thresholdIndex);
-   }
-   if (mask && n > 0) {
-      if (minIndex >= 0 && mask.pick(minIndex) == 1) {
-         minIndex = -1;
-      }
-   }
-   return minIndex;
+   return PickAndPerformFindIndexExtremum<T, ArgMin<T>, Exec>(arr, mask, subset, n, thresholds, cutoff, thresholdIndex);
 }
 
 //******************************************************************************
@@ -1678,22 +3924,14 @@ int FindIndexMaxAboveThresholds(care::host_device_ptr<const T> arr, int n,
                                 double cutoff,
                                 int * thresholdIndex)
 {
-   int ndx = -1;
    if (thresholds) {
-      RAJAReduceMaxLoc<T> max { std::numeric_limits<T>::lowest(), ndx };
-      LOOP_REDUCE(i, 0, n) {
-         if (thresholds[i] > cutoff) {
-            max.maxloc(arr[i], i);
-         }
-      } LOOP_REDUCE_END
-      ndx = max.getLoc();
-      *thresholdIndex = ndx;
+      return FindIndexExtremum<T, ArgMax<T>, AllIndices, AboveThreshold, NoIgnoreMask, Exec>(
+         arr, n, AllIndices{}, AboveThreshold{thresholds, cutoff}, NoIgnoreMask{}, thresholdIndex);
    }
    else {
-      ArrayMaxLoc<T, Exec>(arr, n, std::numeric_limits<T>::lowest(), ndx);
+      return FindIndexExtremum<T, ArgMax<T>, AllIndices, NoThreshold, NoIgnoreMask, Exec>(
+         arr, n, AllIndices{}, NoThreshold{}, NoIgnoreMask{}, nullptr);
    }
-
-   return ndx ;
 }
 
 //******************************************************************************
@@ -1707,12 +3945,8 @@ int FindIndexMaxAboveThresholds(care::host_device_ptr<const T> arr, int n,
 template<typename T, typename Exec>
 int FindIndexMaxSubset(care::host_device_ptr<const T> arr, care::host_device_ptr<int const> subset, int lenset)
 {
-   RAJAReduceMaxLoc<T> max { std::numeric_limits<T>::lowest(), -1 };
-   LOOP_REDUCE(i, 0, lenset) {
-      int curr = subset[i] ;
-      max.maxloc(arr[curr], curr);
-   } LOOP_REDUCE_END
-   return max.getLoc();
+   return FindIndexExtremum<T, ArgMax<T>, SubsetIndices, NoThreshold, NoIgnoreMask, Exec>(
+      arr, lenset, SubsetIndices{subset}, NoThreshold{}, NoIgnoreMask{}, nullptr);
 }
 
 //******************************************************************************
@@ -1733,26 +3967,13 @@ int FindIndexMaxSubsetAboveThresholds(care::host_device_ptr<const T> arr, care::
                                       care::host_device_ptr<double const> thresholds, double cutoff,
                                       int * thresholdIndex)
 {
-   int  ndx = -1 ;
-   ndx = -1;
    if (thresholds) {
-      RAJAReduceMaxLoc<T> max { std::numeric_limits<T>::lowest(), -1 };
-      RAJAReduceMaxLoc<T> thresholdmax { std::numeric_limits<T>::lowest(), -1 };
-      LOOP_REDUCE(i, 0, lenset) {
-         int curr = subset[i] ;
-
-         if (thresholds[i] > cutoff) {
-            max.maxloc(arr[curr], curr);
-            thresholdmax.maxloc(arr[curr], i);
-         }
-      } LOOP_REDUCE_END
-      *thresholdIndex = thresholdmax.getLoc();
-      ndx = max.getLoc();
+      return FindSubsetIndexExtremum<T, ArgMax<T>, AboveThreshold, NoIgnoreMask, Exec>(
+         arr, lenset, SubsetIndices{subset}, AboveThreshold{thresholds, cutoff}, NoIgnoreMask{}, thresholdIndex);
    }
    else {
-      ndx = FindIndexMaxSubset<T, Exec>(arr, subset, lenset);
+      return FindIndexMaxSubset<T, Exec>(arr, subset, lenset);
    }
-   return ndx ;
 }
 
 //******************************************************************************
@@ -1777,22 +3998,7 @@ int PickAndPerformFindMaxIndex(care::host_device_ptr<const T> arr,
                                double cutoff,
                                int *thresholdIndex)
 {
-   int maxIndex;
-   if (subset) {
-      maxIndex =  FindIndexMaxSubsetAboveThresholds<T, Exec>(arr, subset, n,
-                                                             thresholds, cutoff,
-                                                             thresholdIndex);
-   }
-   else {
-      maxIndex =   FindIndexMaxAboveThresholds<T, Exec>(arr, n, thresholds, cutoff,
-                                                        thresholdIndex);
-   }
-   if (mask && n > 0) {
-      if (maxIndex >= 0 && mask.pick(maxIndex) == 1) {
-         maxIndex = -1;
-      }
-   }
-   return maxIndex;
+   return PickAndPerformFindIndexExtremum<T, ArgMax<T>, Exec>(arr, mask, subset, n, thresholds, cutoff, thresholdIndex);
 }
 
 } // end namespace care_utils
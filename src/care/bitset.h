@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_BITSET_H_
+#define _CARE_BITSET_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other CARE headers
+#include "care/care.h"
+#include "care/util.h"
+
+namespace care {
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// A packed, managed array of bits, stored as 64 bit words so
+   /// a mask costs one bit per entry instead of an int. Like
+   /// host_device_ptr it is captured by value in loops and is
+   /// readable and writable on the host and the device. set and
+   /// reset are not atomic, so bits sharing a word must not be
+   /// written by different threads; the word-granular constructor
+   /// and setWord are safe to use in parallel. Bits at or past
+   /// size() are always zero.
+   ///
+   ////////////////////////////////////////////////////////////////
+   class bitset {
+      public:
+         static constexpr int bitsPerWord = 64;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Default constructor. Holds no bits.
+         ///////////////////////////////////////////////////////////////////////////
+         bitset() = default;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Allocates a bitset of size bits, all cleared
+         /// @param[in] size The number of bits
+         /// @param[in] name The name of the underlying managed array
+         ///////////////////////////////////////////////////////////////////////////
+         explicit bitset(int size, const char* name = "bitset")
+            : m_size(size),
+              m_words(wordsFor(size) > 0 ? wordsFor(size) : 1, name)
+         {
+            care::host_device_ptr<unsigned long long> words = m_words;
+
+            LOOP_STREAM(w, 0, wordsFor(size)) {
+               words[w] = 0ull;
+            } LOOP_STREAM_END
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Packs an int mask. Bit i is set if mask[i] is nonzero.
+         /// @param[in] mask The mask to pack
+         /// @param[in] size The length of mask
+         /// @param[in] name The name of the underlying managed array
+         ///////////////////////////////////////////////////////////////////////////
+         bitset(care::host_device_ptr<int const> mask, int size, const char* name = "bitset")
+            : m_size(size),
+              m_words(wordsFor(size) > 0 ? wordsFor(size) : 1, name)
+         {
+            care::host_device_ptr<unsigned long long> words = m_words;
+
+            LOOP_STREAM(w, 0, wordsFor(size)) {
+               const int first = w * bitsPerWord;
+               const int last = first + bitsPerWord < size ? first + bitsPerWord : size;
+               unsigned long long word = 0ull;
+
+               for (int i = first; i < last; ++i) {
+                  word |= (unsigned long long) (mask[i] != 0) << (i - first);
+               }
+
+               words[w] = word;
+            } LOOP_STREAM_END
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief The number of 64 bit words needed to hold size bits
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE static constexpr int wordsFor(int size) {
+            return (size + bitsPerWord - 1) / bitsPerWord;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief The number of bits
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE int size() const {
+            return m_size;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief The number of 64 bit words backing the bits
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE int numWords() const {
+            return wordsFor(m_size);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Whether any storage is held, mirroring the null checks
+         ///        done on int masks
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE explicit operator bool() const {
+            return m_size > 0;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether bit i is set
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE bool test(int i) const {
+            return (m_words[i / bitsPerWord] >> (i % bitsPerWord)) & 1ull;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Sets bit i. Not atomic.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE void set(int i) const {
+            m_words[i / bitsPerWord] |= 1ull << (i % bitsPerWord);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Clears bit i. Not atomic.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE void reset(int i) const {
+            m_words[i / bitsPerWord] &= ~(1ull << (i % bitsPerWord));
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns bits [64*w, 64*w + 64) as a word, bit 0 first
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE unsigned long long word(int w) const {
+            return m_words[w];
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Replaces bits [64*w, 64*w + 64). Bits past size() are dropped.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE void setWord(int w, unsigned long long word) const {
+            m_words[w] = word & validBits(w);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief The bits of word w that lie below size()
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE unsigned long long validBits(int w) const {
+            const int remaining = m_size - w * bitsPerWord;
+            return remaining >= bitsPerWord ? ~0ull : (1ull << remaining) - 1ull;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief The underlying words, for use with array_utils
+         ///////////////////////////////////////////////////////////////////////////
+         care::host_device_ptr<unsigned long long> words() const {
+            return m_words;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the number of set bits
+         ///////////////////////////////////////////////////////////////////////////
+         int count() const {
+            care::host_device_ptr<unsigned long long const> words = m_words;
+            const int length = numWords();
+            RAJAReduceSum<int> total { 0 };
+
+            LOOP_REDUCE(w, 0, length) {
+               total += care::popCount(words[w]);
+            } LOOP_REDUCE_END
+
+            return (int) total;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Frees the underlying storage
+         ///////////////////////////////////////////////////////////////////////////
+         void free() {
+            m_words.free();
+            m_words = nullptr;
+            m_size = 0;
+         }
+
+      private:
+         int m_size = 0; //!< The number of bits
+         care::host_device_ptr<unsigned long long> m_words = nullptr; //!< The packed bits
+   };
+} // namespace care
+
+#endif // !defined(_CARE_BITSET_H_)
+
@@ -81,6 +81,7 @@ using RAJAAtomic = RAJA::auto_atomic;
 #define ATOMIC_OR(ref, val)  RAJA::atomicOr<RAJAAtomic>(&(ref), val)
 #define ATOMIC_AND(ref, val) RAJA::atomicAnd<RAJAAtomic>(&(ref), val)
 #define ATOMIC_XOR(ref, val) RAJA::atomicXor<RAJAAtomic>(&(ref), val)
+#define ATOMIC_CAS(ref, compare, val) RAJA::atomicCAS<RAJAAtomic>(&(ref), compare, val)
 
 // RAJADeviceExec is the device execution policy
 // on this platform, irrespective of whether GPU_ACTIVE is set.
@@ -113,16 +114,24 @@ using RAJADeviceExec = RAJA::seq_exec;
 
 #if CHAI_GPU_SIM_MODE
 
+// Simulated kernels run on the OpenMP threads when they are available (see
+// care::simulate_gpu_kernel), so the reductions must be thread safe
+#if CARE_ENABLE_GPU_SIMULATION_MODE && defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+using RAJASimulationReduce = RAJA::omp_reduce ;
+#else
+using RAJASimulationReduce = RAJA::seq_reduce ;
+#endif
+
 template <class T>
-using RAJAReduceMax = RAJA::ReduceMax< RAJA::seq_reduce, T>  ;
+using RAJAReduceMax = RAJA::ReduceMax< RAJASimulationReduce, T>  ;
 template<class T>
-using RAJAReduceMin = RAJA::ReduceMin< RAJA::seq_reduce, T>  ;
+using RAJAReduceMin = RAJA::ReduceMin< RAJASimulationReduce, T>  ;
 template<class T>
-using RAJAReduceMinLoc = RAJA::ReduceMinLoc< RAJA::seq_reduce, T>  ;
+using RAJAReduceMinLoc = RAJA::ReduceMinLoc< RAJASimulationReduce, T>  ;
 template<class T>
-using RAJAReduceMaxLoc = RAJA::ReduceMaxLoc< RAJA::seq_reduce, T>  ;
+using RAJAReduceMaxLoc = RAJA::ReduceMaxLoc< RAJASimulationReduce, T>  ;
 template<class T>
-using RAJAReduceSum = RAJA::ReduceSum< RAJA::seq_reduce, T>  ;
+using RAJAReduceSum = RAJA::ReduceSum< RAJASimulationReduce, T>  ;
 using RAJAExec = RAJADeviceExec ;
 #define thrustExec thrust::seq
 #define RAJA_PARALLEL_ACTIVE
@@ -215,11 +224,15 @@ using RAJAExec = RAJA::seq_exec ;
 // #define OMP_FOR_END }
 #define OMP_FOR_BEGIN CARE_PRAGMA(omp parallel for schedule(static))
 #define OMP_FOR_END
+#define OMP_DYNAMIC_FOR_BEGIN CARE_PRAGMA(omp parallel for schedule(dynamic))
+#define OMP_DYNAMIC_FOR_END
 
 #else
 
 #define OMP_FOR_BEGIN
 #define OMP_FOR_END
+#define OMP_DYNAMIC_FOR_BEGIN
+#define OMP_DYNAMIC_FOR_END
 
 #endif
 
@@ -17,13 +17,21 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 // CARE headers
+#include "care/GPUSimulation.h"
+#include "care/LoopPolicyTable.h"
 #include "care/policies.h"
 #include "care/RAJAPlugin.h"
 #include "care/util.h"
+#include "care/WorkStealing.h"
 
 // other library headers
 #include "chai/ArrayManager.hpp"
 
+// Std library headers
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
 namespace care {
    template <typename T>
    struct ExecutionPolicyToSpace {
@@ -70,7 +78,7 @@ namespace care {
       const int length = end - start;
 
       if (length != 0) {
-         RAJAPlugin::pre_forall_hook(ExecutionPolicyToSpace<ExecutionPolicy>::value, fileName, lineNumber);
+         RAJAPlugin::pre_forall_hook(ExecutionPolicyToSpace<ExecutionPolicy>::value, fileName, lineNumber, length);
 
 #if CARE_ENABLE_GPU_SIMULATION_MODE
          RAJA::forall<RAJA::seq_exec>(RAJA::RangeSegment(start, end), body);
@@ -82,6 +90,39 @@ namespace care {
       }
    }
 
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Simulates a GPU kernel on the host, in blocks that run concurrently
+   ///        on the OpenMP threads (see simulate_gpu_kernel). Each thread copies
+   ///        the body while the CHAI execution space is the GPU, so captured
+   ///        arrays are moved and captured reducers are private to the thread.
+   ///
+   /// @arg[in] gpu_simulation Used to choose this overload of forall
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void forall(gpu_simulation, const char * fileName, const int lineNumber,
+               const int start, const int end, LB&& body) {
+      const int length = end - start;
+
+      if (length != 0) {
+         RAJAPlugin::pre_forall_hook(chai::GPU, fileName, lineNumber, length);
+
+         simulate_gpu_kernel(start, end, body);
+
+         RAJAPlugin::post_forall_hook(chai::GPU, fileName, lineNumber);
+      }
+   }
+
+#endif
+
    ////////////////////////////////////////////////////////////////////////////////
    ///
    /// @author Alan Dayton
@@ -127,6 +168,35 @@ namespace care {
 #endif
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief If openmp is available, execute on the host threads with work
+   ///        stealing (see work_stealing_forall), for loops whose iterations
+   ///        vary widely in cost. Otherwise, execute sequentially. Each thread
+   ///        copies the body between the RAJAPlugin hooks.
+   ///
+   /// @arg[in] dynamic Used to choose this overload of forall
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void forall(dynamic, const char * fileName, const int lineNumber,
+               const int start, const int end, LB&& body) {
+      const int length = end - start;
+
+      if (length != 0) {
+         RAJAPlugin::pre_forall_hook(chai::CPU, fileName, lineNumber, length);
+
+         work_stealing_forall(start, end, body);
+
+         RAJAPlugin::post_forall_hook(chai::CPU, fileName, lineNumber);
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    ///
    /// @author Alan Dayton
@@ -158,13 +228,65 @@ namespace care {
 #endif
    }
 
+#if defined(_OPENMP) && defined(OPENMP_ACTIVE) && CARE_ENABLE_ADAPTIVE_LOOP_POLICY
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Executes with an openmp policy, or sequentially if the launch is
+   ///        shorter than the calibrated threshold of its call site (see
+   ///        LoopPolicyTable). Launches are only timed until the call site is
+   ///        calibrated. The call site is looked up once per loop body type,
+   ///        so calibrated launches do not lock.
+   ///
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void adaptive_forall(const char * fileName, const int lineNumber,
+                        const int start, const int end, LB&& body) {
+      if (!LoopPolicyTable::isEnabled()) {
+         forall(RAJA::omp_parallel_for_exec{}, fileName, lineNumber, start, end, body);
+         return;
+      }
+
+      // A body type almost always comes from a single call site, but a
+      // functor could be launched from several
+      static const LoopPolicySite cachedSite(fileName, lineNumber);
+      const LoopPolicySite site = cachedSite.isAt(fileName, lineNumber) ?
+                                  cachedSite : LoopPolicySite(fileName, lineNumber);
+
+      const int length = end - start;
+      const bool parallel = site.runInParallel(length);
+      const bool timed = site.getThreshold() < 0;
+      const auto launchStart = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+      if (parallel) {
+         forall(RAJA::omp_parallel_for_exec{}, fileName, lineNumber, start, end, body);
+      }
+      else {
+         forall(RAJA::seq_exec{}, fileName, lineNumber, start, end, body);
+      }
+
+      if (timed) {
+         const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - launchStart;
+         site.record(length, parallel, seconds.count());
+      }
+   }
+
+#endif
+
    ////////////////////////////////////////////////////////////////////////////////
    ///
    /// @author Alan Dayton
    ///
    /// @brief If GPU is available, execute on the device. If GPU is not available
-   ///        but openmp is, execute an openmp policy. Otherwise, execute on the host.
-   ///        This specialization is needed for clang-query.
+   ///        but openmp is, execute an openmp policy, or inline if the launch is
+   ///        too short to benefit (see adaptive_forall). Otherwise, execute on the
+   ///        host. This specialization is needed for clang-query.
    ///
    /// @arg[in] parallel Used to choose this overload of forall
    /// @arg[in] fileName The name of the file where this function is called
@@ -185,6 +307,8 @@ namespace care {
 #elif defined(GPU_ACTIVE) && defined(__HIPCC__)
       forall(RAJA::hip_exec<CARE_CUDA_BLOCK_SIZE, CARE_CUDA_ASYNC>{},
              fileName, lineNumber, start, end, body);
+#elif defined(_OPENMP) && defined(OPENMP_ACTIVE) && CARE_ENABLE_ADAPTIVE_LOOP_POLICY
+      adaptive_forall(fileName, lineNumber, start, end, body);
 #elif defined(_OPENMP) && defined(OPENMP_ACTIVE)
       forall(RAJA::omp_parallel_for_exec{}, fileName, lineNumber, start, end, body);
 #else
@@ -192,6 +316,121 @@ namespace care {
 #endif
    }
 
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Loops over the given 64 bit indices and calls the loop body with
+   ///        each index, for ranges that may pass 2^31. This overload is CHAI
+   ///        and RAJA aware and sets the execution space accordingly. The
+   ///        RAJAPlugin hooks are given the length clamped to an int.
+   ///
+   /// @arg[in] policy Used to choose this overload of forall_64
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename ExecutionPolicy, typename LB>
+   void forall_64(ExecutionPolicy /* policy */, const char * fileName, const int lineNumber,
+                  const std::int64_t start, const std::int64_t end, LB&& body) {
+      const std::int64_t length = end - start;
+
+      if (length > 0) {
+         const int hookLength = length < std::numeric_limits<int>::max() ? (int) length : std::numeric_limits<int>::max();
+         RAJAPlugin::pre_forall_hook(ExecutionPolicyToSpace<ExecutionPolicy>::value, fileName, lineNumber, hookLength);
+
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+         RAJA::forall<RAJA::seq_exec>(RAJA::TypedRangeSegment<std::int64_t>(start, end), body);
+#else
+         RAJA::forall<ExecutionPolicy>(RAJA::TypedRangeSegment<std::int64_t>(start, end), body);
+#endif
+
+         RAJAPlugin::post_forall_hook(ExecutionPolicyToSpace<ExecutionPolicy>::value, fileName, lineNumber);
+      }
+   }
+
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Simulates a GPU kernel over the given 64 bit indices on the host
+   ///        (see forall with gpu_simulation).
+   ///
+   /// @arg[in] gpu_simulation Used to choose this overload of forall_64
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void forall_64(gpu_simulation, const char * fileName, const int lineNumber,
+                  const std::int64_t start, const std::int64_t end, LB&& body) {
+      const std::int64_t length = end - start;
+
+      if (length > 0) {
+         const int hookLength = length < std::numeric_limits<int>::max() ? (int) length : std::numeric_limits<int>::max();
+         RAJAPlugin::pre_forall_hook(chai::GPU, fileName, lineNumber, hookLength);
+
+         simulate_gpu_kernel(start, end, body);
+
+         RAJAPlugin::post_forall_hook(chai::GPU, fileName, lineNumber);
+      }
+   }
+
+#endif
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Executes on the host over the given 64 bit indices.
+   ///
+   /// @arg[in] sequential Used to choose this overload of forall_64
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void forall_64(sequential, const char * fileName, const int lineNumber,
+                  const std::int64_t start, const std::int64_t end, LB&& body) {
+      forall_64(RAJA::seq_exec{}, fileName, lineNumber, start, end, body);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Executes over the given 64 bit indices as forall with parallel
+   ///        does, except that the OpenMP policy is not adaptive.
+   ///
+   /// @arg[in] parallel Used to choose this overload of forall_64
+   /// @arg[in] fileName The name of the file where this function is called
+   /// @arg[in] lineNumber The line number in the file where this function is called
+   /// @arg[in] start The starting index (inclusive)
+   /// @arg[in] end The ending index (exclusive)
+   /// @arg[in] body The loop body to execute at each index
+   ///
+   ////////////////////////////////////////////////////////////////////////////////
+   template <typename LB>
+   void forall_64(parallel, const char * fileName, const int lineNumber,
+                  const std::int64_t start, const std::int64_t end, LB&& body) {
+#if defined(GPU_ACTIVE) && CARE_ENABLE_GPU_SIMULATION_MODE
+      forall_64(gpu_simulation{}, fileName, lineNumber, start, end, body);
+#elif defined(GPU_ACTIVE) && defined(__CUDACC__)
+      forall_64(RAJA::cuda_exec<CARE_CUDA_BLOCK_SIZE, CARE_CUDA_ASYNC>{},
+                fileName, lineNumber, start, end, body);
+#elif defined(GPU_ACTIVE) && defined(__HIPCC__)
+      forall_64(RAJA::hip_exec<CARE_CUDA_BLOCK_SIZE, CARE_CUDA_ASYNC>{},
+                fileName, lineNumber, start, end, body);
+#elif defined(_OPENMP) && defined(OPENMP_ACTIVE)
+      forall_64(RAJA::omp_parallel_for_exec{}, fileName, lineNumber, start, end, body);
+#else
+      forall_64(RAJA::seq_exec{}, fileName, lineNumber, start, end, body);
+#endif
+   }
+
    ////////////////////////////////////////////////////////////////////////////////
    ///
    /// @author Peter Robinson
@@ -279,9 +518,9 @@ namespace care {
          /* trigger the chai copy constructors in captured variables */
          LB my_body = body;
 
-         for (int i = start; i < end; ++i) {
+         simulate_gpu_kernel(start, end, [=] (const int i) {
             my_body(i,fused,action,start,end);
-         }
+         });
 #else
          size_t blockSize = CARE_CUDA_BLOCK_SIZE;
          size_t gridSize = (end - start) / blockSize + 1;
@@ -329,7 +568,8 @@ namespace care {
          threadRM->setExecutionSpace(chai::GPU);
 
 #if CARE_ENABLE_GPU_SIMULATION_MODE
-         RAJA::forall<RAJA::seq_exec>(RAJA::RangeSegment(start, end), body);
+         /* the chai copy constructors are triggered by the per thread copies */
+         simulate_gpu_kernel(start, end, body);
 #elif defined(__CUDACC__)
          RAJA::forall< RAJA::cuda_exec<CARE_CUDA_BLOCK_SIZE, CARE_CUDA_ASYNC>>(RAJA::RangeSegment(start, end), body);
 #elif defined(__HIPCC__)
@@ -11,6 +11,7 @@
 namespace care {
    struct sequential {};
    struct openmp {};
+   struct dynamic {};
    struct gpu {};
    struct parallel {};
    struct raja_fusible {};
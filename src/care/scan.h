@@ -12,36 +12,296 @@
 #include "care/config.h"
 
 // Other Care headers
+#include "care/ChainedScan.h"
 #include "care/CHAIDataGetter.h"
+#include "care/LoopTrace.h"
+#include "care/ScanWorkspace.h"
+#include "care/util.h"
 
 // Other library headers
 #include "chai/ManagedArray.hpp"
 #include "RAJA/RAJA.hpp"
 
+// Std library headers
+#include <cstdint>
+
+#if defined(__GPUCC__) && defined(GPU_ACTIVE) && !CHAI_GPU_SIM_MODE
+#if defined(__CUDACC__)
+#include "cub/cub.cuh"
+#undef CUB_NS_POSTFIX
+#undef CUB_NS_PREFIX
+#elif defined(__HIPCC__)
+#include "hipcub/hipcub.hpp"
+#endif
+#endif
+
+
+namespace care {
+   namespace detail {
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Exclusive scan of raw data with RAJA. rawOutData may equal rawData.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Exec, typename Fn, typename Size>
+      void exclusive_scan_raw(Exec, T * rawData, T * rawOutData, Size size, Fn binop, T val) {
+         if (rawOutData == rawData) {
+            RAJA::exclusive_scan_inplace<Exec, T *, T, Fn>(Exec {}, rawData, rawData+size, binop, val);
+         }
+         else {
+            RAJA::exclusive_scan<Exec, T*, T*, T, Fn>(Exec {},
+                                                      rawData,
+                                                      rawData+size,
+                                                      rawOutData,
+                                                      binop, val);
+         }
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Inclusive scan of raw data with RAJA. rawOutData may equal rawData.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Exec, typename Fn, typename Size>
+      void inclusive_scan_raw(Exec, T * rawData, T * rawOutData, Size size, Fn binop) {
+         if (rawOutData == rawData) {
+            RAJA::inclusive_scan_inplace<Exec, T *, Fn>(Exec {}, rawData, rawData+size, binop);
+         }
+         else {
+            RAJA::inclusive_scan<Exec, T*, T*, Fn>(Exec {},
+                                                   rawData,
+                                                   rawData+size,
+                                                   rawOutData,
+                                                   binop);
+         }
+      }
+
+// The chained scan is only parallel where OPENMP_ACTIVE is defined, so elsewhere
+// the OpenMP scans of RAJA are used
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP) && defined(OPENMP_ACTIVE)
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Exclusive scan of raw host data with the single pass chained scan.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Fn, typename Size>
+      void exclusive_scan_raw(RAJA::omp_parallel_for_exec, T * rawData, T * rawOutData, Size size, Fn binop, T val) {
+         care::chained_scan<T, Size>(__FILE__, __LINE__, 0, size, val,
+                                     [=] (const Size i) -> T { return rawData[i]; },
+                                     binop,
+                                     [=] (const Size i, const T prefix, const T) { rawOutData[i] = prefix; });
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Inclusive scan of raw host data with the single pass chained scan,
+      ///        as an exclusive scan of [1, size) seeded with the first value.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Fn, typename Size>
+      void inclusive_scan_raw(RAJA::omp_parallel_for_exec, T * rawData, T * rawOutData, Size size, Fn binop) {
+         if (size > 0) {
+            const T first = rawData[0];
+            rawOutData[0] = first;
+
+            care::chained_scan<T, Size>(__FILE__, __LINE__, 1, size, first,
+                                        [=] (const Size i) -> T { return rawData[i]; },
+                                        binop,
+                                        [=] (const Size i, const T prefix, const T value) { rawOutData[i] = binop(prefix, value); });
+         }
+      }
+
+#endif // _OPENMP && RAJA_USE_OPENMP && OPENMP_ACTIVE
+
+#if defined(__GPUCC__) && defined(GPU_ACTIVE) && !CHAI_GPU_SIM_MODE
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Exclusive scan of at most 2^31-1 elements of raw device data.
+      ///        Calls the device scan library directly so the temporary storage
+      ///        comes from the scan workspace instead of being allocated on
+      ///        every call. The scan is launched on the default stream and, like
+      ///        the loops of the CARE_CUDA_ASYNC policy, is not waited for.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Fn>
+      void exclusive_scan_device_piece(T * rawData, T * rawOutData, int size, Fn binop, T val) {
+         size_t tempStorageBytes = 0;
+
+#if defined(__CUDACC__)
+         care::gpuAssert(cub::DeviceScan::ExclusiveScan(nullptr, tempStorageBytes, rawData, rawOutData, binop, val, size),
+                         __FILE__, __LINE__);
+#elif defined(__HIPCC__)
+         care::gpuAssert(hipcub::DeviceScan::ExclusiveScan(nullptr, tempStorageBytes, rawData, rawOutData, binop, val, size),
+                         __FILE__, __LINE__);
+#endif
+
+         chai::ManagedArray<char> tempStorage = ScanWorkspace<T>::get(chai::GPU).tempStorage(tempStorageBytes);
+         CHAIDataGetter<char, RAJADeviceExec> charGetter {};
+         void * rawTempStorage = charGetter.getRawArrayData(tempStorage);
+
+#if defined(__CUDACC__)
+         care::gpuAssert(cub::DeviceScan::ExclusiveScan(rawTempStorage, tempStorageBytes, rawData, rawOutData, binop, val, size),
+                         __FILE__, __LINE__);
+#elif defined(__HIPCC__)
+         care::gpuAssert(hipcub::DeviceScan::ExclusiveScan(rawTempStorage, tempStorageBytes, rawData, rawOutData, binop, val, size),
+                         __FILE__, __LINE__);
+#endif
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Copies one element of device data to the host.
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T>
+      T copyDeviceValueToHost(const T * rawDeviceData) {
+         T value;
+#if defined(__CUDACC__)
+         care::gpuAssert(cudaMemcpy(&value, rawDeviceData, sizeof(T), cudaMemcpyDeviceToHost),
+                         __FILE__, __LINE__);
+#elif defined(__HIPCC__)
+         care::gpuAssert(hipMemcpy(&value, rawDeviceData, sizeof(T), hipMemcpyDeviceToHost),
+                         __FILE__, __LINE__);
+#endif
+         return value;
+      }
+
+      ////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Exclusive scan of raw device data. The device scan libraries count
+      ///        elements with an int, so longer scans are done in pieces, each
+      ///        seeded with the prefix carried out of the one before. Scans of
+      ///        up to 2^30 elements are a single piece with no copies.
+      ///
+      ///        Returns without waiting for the last piece. Later kernels on the
+      ///        default stream and CHAI moves of the output are ordered after it,
+      ///        but a caller that reads the raw output on the host must first
+      ///        synchronize the device (see care::gpuDeviceSynchronize).
+      ///
+      ////////////////////////////////////////////////////////////////////////////////
+      template <typename T, typename Fn, typename Size>
+      void exclusive_scan_raw(RAJADeviceExec, T * rawData, T * rawOutData, Size size, Fn binop, T val) {
+         const Size maxPieceSize = Size(1) << 30;
+         T carry = val;
+
+         for (Size pieceStart = 0; pieceStart < size; pieceStart += maxPieceSize) {
+            const Size remaining = size - pieceStart;
+            const int pieceSize = (int) (remaining < maxPieceSize ? remaining : maxPieceSize);
+
+            if (remaining <= maxPieceSize) {
+               exclusive_scan_device_piece(rawData + pieceStart, rawOutData + pieceStart, pieceSize, binop, carry);
+               break;
+            }
+            else {
+               // The last input of the piece is needed for the carry, and an
+               // in place scan overwrites it
+               const Size pieceLast = pieceStart + pieceSize - 1;
+               const T lastValue = copyDeviceValueToHost(rawData + pieceLast);
+
+               exclusive_scan_device_piece(rawData + pieceStart, rawOutData + pieceStart, pieceSize, binop, carry);
 
-// exclusive scan functionality
-template <typename T, typename Exec, typename Fn>
+               carry = binop(copyDeviceValueToHost(rawOutData + pieceLast), lastValue);
+            }
+         }
+      }
+
+#endif // __GPUCC__ && GPU_ACTIVE && !CHAI_GPU_SIM_MODE
+   } // namespace detail
+
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// A count or position for each of NumCategories categories,
+   /// the value scanned by SCAN_PARTITION_LOOP. Adds elementwise,
+   /// so one scan of these computes the positions of every
+   /// category at once.
+   ///
+   ////////////////////////////////////////////////////////////////
+   template <int NumCategories>
+   struct CategoryCounts {
+      int value[NumCategories]; //!< The count of each category
+
+      CARE_HOST_DEVICE int& operator[](const int category) {
+         return value[category];
+      }
+
+      CARE_HOST_DEVICE const int& operator[](const int category) const {
+         return value[category];
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Returns a count of one in the given category, or no counts if
+      ///        the category is out of range
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE static CategoryCounts unit(const int category) {
+         CategoryCounts result;
+
+         for (int i = 0; i < NumCategories; ++i) {
+            result.value[i] = i == category ? 1 : 0;
+         }
+
+         return result;
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Returns the category of a value returned by unit, or -1 if it
+      ///        has no counts
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE static int category(const CategoryCounts& unitCounts) {
+         for (int i = 0; i < NumCategories; ++i) {
+            if (unitCounts.value[i] != 0) {
+               return i;
+            }
+         }
+
+         return -1;
+      }
+
+      ///////////////////////////////////////////////////////////////////////////
+      /// @brief Returns the category counted between two consecutive prefixes
+      ///        of an exclusive scan of unit values, or -1 if there is none
+      ///////////////////////////////////////////////////////////////////////////
+      CARE_HOST_DEVICE static int category(const CategoryCounts& before, const CategoryCounts& after) {
+         for (int i = 0; i < NumCategories; ++i) {
+            if (after.value[i] != before.value[i]) {
+               return i;
+            }
+         }
+
+         return -1;
+      }
+
+      CARE_HOST_DEVICE friend CategoryCounts operator+(const CategoryCounts& a, const CategoryCounts& b) {
+         CategoryCounts result;
+
+         for (int i = 0; i < NumCategories; ++i) {
+            result.value[i] = a.value[i] + b.value[i];
+         }
+
+         return result;
+      }
+   };
+} // namespace care
+
+// exclusive scan functionality. size may be of any integral type, so scans of
+// more than 2^31 elements are given a 64 bit size.
+template <typename T, typename Exec, typename Fn, typename Size>
 void exclusive_scan(chai::ManagedArray<T> data, chai::ManagedArray<T> outData,
-                    int size, Fn binop, T val, bool inPlace);
+                    Size size, Fn binop, T val, bool inPlace,
+                    const care::SourceLocation & caller = CARE_CALLER);
 
-template <typename T, typename Exec, typename Fn>
+template <typename T, typename Exec, typename Fn, typename Size>
 void exclusive_scan(chai::ManagedArray<T> data, chai::ManagedArray<T> outData,
-                    int size, Fn binop, T val, bool inPlace) {
+                    Size size, Fn binop, T val, bool inPlace,
+                    const care::SourceLocation & caller) {
+   care::LoopTraceScope trace("scan", caller, CHAIDataGetter<T, Exec>::ChaiPolicy, size);
+
    if (size > 1 && data != nullptr) {
       CHAIDataGetter<T, Exec> D {};
       T * rawData = D.getRawArrayData(data);
-      T * rawDataEnd = rawData+size;
-      if (inPlace) {
-         RAJA::exclusive_scan_inplace<Exec, T *, T, Fn>(Exec {}, rawData, rawDataEnd, binop, val);
-      }
-      else {
-         T * rawOutData = D.getRawArrayData(outData);
-         RAJA::exclusive_scan<Exec, T*, T*, T, Fn>(Exec {},
-                                                   rawData,
-                                                   rawDataEnd,
-                                                   rawOutData,
-                                                   binop, val);
-      }
+      T * rawOutData = inPlace ? rawData : D.getRawArrayData(outData);
+      care::detail::exclusive_scan_raw(Exec {}, rawData, rawOutData, size, binop, val);
    }
    else {
       if ( size == 1) {
@@ -62,49 +322,44 @@ void exclusive_scan(chai::ManagedArray<T> data, chai::ManagedArray<T> outData,
 }
 
 //typesafe wrapper for out of place scan
-template <typename T, typename Exec, typename Fn>
+template <typename T, typename Exec, typename Fn, typename Size>
 void exclusive_scan(chai::ManagedArray<const T> inData, chai::ManagedArray<T> outData,
-                    int size, Fn binop, T val) { 
+                    Size size, Fn binop, T val,
+                    const care::SourceLocation & caller = CARE_CALLER) { 
     const bool inPlace = false;
-    exclusive_scan<T, Exec, Fn>(*reinterpret_cast<chai::ManagedArray<T> *>(&inData), outData, size, binop, val, inPlace);
+    exclusive_scan<T, Exec, Fn, Size>(*reinterpret_cast<chai::ManagedArray<T> *>(&inData), outData, size, binop, val, inPlace, caller);
 }
 
 // inclusive scan functionality
-template <typename T, typename Exec, typename Fn>
+template <typename T, typename Exec, typename Fn, typename Size>
 void inclusive_scan(chai::ManagedArray<T> data, chai::ManagedArray<T> outData,
-                    int size, Fn binop, bool inPlace);
+                    Size size, Fn binop, bool inPlace,
+                    const care::SourceLocation & caller = CARE_CALLER);
 
-template <typename T, typename Exec, typename Fn>
+template <typename T, typename Exec, typename Fn, typename Size>
 void inclusive_scan(chai::ManagedArray<T> data, chai::ManagedArray<T> outData,
-                    int size, Fn binop, bool inPlace) {
+                    Size size, Fn binop, bool inPlace,
+                    const care::SourceLocation & caller) {
+   care::LoopTraceScope trace("scan", caller, CHAIDataGetter<T, Exec>::ChaiPolicy, size);
    CHAIDataGetter<T, Exec> D {};
    T * rawData = D.getRawArrayData(data);
-   T * rawDataEnd = rawData+size;
-   if (inPlace) {
-      RAJA::inclusive_scan_inplace<Exec, T *, Fn>(Exec {}, rawData, rawDataEnd, binop);
-   }
-   else {
-      T * rawOutData = D.getRawArrayData(outData);
-      RAJA::inclusive_scan<Exec, T*, T*, Fn>(Exec {},
-                                             rawData,
-                                             rawDataEnd,
-                                             rawOutData,
-                                             binop);
-   }
+   T * rawOutData = inPlace ? rawData : D.getRawArrayData(outData);
+   care::detail::inclusive_scan_raw(Exec {}, rawData, rawOutData, size, binop);
 }
 
 //typesafe wrapper for out of place scan
-template <typename T, typename Exec, typename Fn>
+template <typename T, typename Exec, typename Fn, typename Size>
 void inclusive_scan(chai::ManagedArray<const T> inData, chai::ManagedArray<T> outData,
-                    int size, Fn binop, T val) { 
+                    Size size, Fn binop, T val,
+                    const care::SourceLocation & caller = CARE_CALLER) { 
     const bool inPlace = false;
-    inclusive_scan<T, Exec, Fn>(*reinterpret_cast<chai::ManagedArray<T> *>(&inData), outData, size, binop, val, inPlace);
+    inclusive_scan<T, Exec, Fn, Size>(*reinterpret_cast<chai::ManagedArray<T> *>(&inData), outData, size, binop, val, inPlace, caller);
 }
 
 template<typename T>
-inline void getFinalScanCountFromPinned(chai::ManagedArray<T> scanvar_length, T& scanCount) {
+inline void getFinalScanCountFromPinned(chai::ManagedArray<T> scanvar_length, int slot, T& scanCount) {
    CARE_CHECKED_HOST_KERNEL_WITH_REF_START(scan_loop_check, scanCount) {
-      scanCount = scanvar_length[0];
+      scanCount = scanvar_length[slot];
    } CARE_CHECKED_HOST_KERNEL_WITH_REF_END(scan_loop_check)
 }
 
@@ -129,11 +384,15 @@ inline void getFinalScanCount(chai::ManagedArray<T> scanvar, int length, T& scan
 
 #define SCANVARNAME(INDXNAME) INDXNAME ## _scanvar
 #define SCANVARLENGTHNAME(INDXNAME) INDXNAME ## _scanvar_length
+#define SCANVARSLOTNAME(INDXNAME) INDXNAME ## _scanvar_slot
+#define SCANVARWORKSPACENAME(INDXNAME) INDXNAME ## _scanvar_workspace
+#define SCANVARFLAGNAME(INDXNAME) INDXNAME ## _scanvar_flag
 #define SCANVARENDNAME(SCANVAR) SCANVAR ## _end
 #define SCANVARSTARTNAME(SCANVAR) SCANVAR ## _start
 
 #if defined GPU_ACTIVE || defined CARE_ALWAYS_USE_RAJA_SCAN
-// scan var is an managed array of ints
+// scan var is an managed array of ints, drawn from the scan workspace of the
+// calling thread, and the length is read back through a pinned count slot
 using ScanVar = chai::ManagedArray<int>;
 
 #if CARE_HAVE_LLNL_GLOBALID
@@ -142,8 +401,12 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
 
 #endif // CARE_HAVE_LLNL_GLOBALID
 
-// initialize field to be scanned with the expression given, then perform the scan in place
-#define SCAN_LOOP_INIT(INDX, START, END, SCANVAR, SCANVARLENGTH, SCANVAR_OFFSET, EXPR) \
+// scan var of the 64 bit scan idioms, whose positions and lengths may pass 2^31
+using ScanVar64 = chai::ManagedArray<std::int64_t>;
+
+// initialize field to be scanned with the expression given, then perform the scan in place.
+// An empty scan only sets the count, so the scan array is not moved to the host.
+#define SCAN_LOOP_INIT(INDX, START, END, SCANVAR, SCANVARLENGTH, SCANVARSLOT, SCANVAR_OFFSET, EXPR) \
    if (END - START > 0) { \
       int const SCANVARENDNAME(SCANVAR) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END+1, scan_loop_init_check) { \
@@ -152,14 +415,13 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
       exclusive_scan<int, RAJAExec>(SCANVAR, nullptr, END-START+1, RAJA::operators::plus<int>{}, SCANVAR_OFFSET, true); \
    } else { \
       CARE_CHECKED_SEQUENTIAL_LOOP_START(INDX, 0, 1, scan_loop_init_check) { \
-         SCANVAR[INDX] = SCANVAR_OFFSET; \
-         SCANVARLENGTH[0] = SCANVAR_OFFSET; \
+         SCANVARLENGTH[SCANVARSLOT] = SCANVAR_OFFSET; \
       } CARE_CHECKED_SEQUENTIAL_LOOP_END(scan_loop_init_check) \
    }
 
 #if CARE_HAVE_LLNL_GLOBALID
 
-#define SCAN_LOOP_GID_INIT(INDX, START, END, SCANVAR, SCANVARLENGTH, SCANVAR_OFFSET, EXPR) \
+#define SCAN_LOOP_GID_INIT(INDX, START, END, SCANVAR, SCANVARLENGTH, SCANVARSLOT, SCANVAR_OFFSET, EXPR) \
    if (END - START > 0) { \
       int const SCANVARENDNAME(SCANVAR) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END+1, scan_loop_gid_init_check) { \
@@ -168,35 +430,48 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
       exclusive_scan<GIDTYPE, RAJAExec>(SCANVAR, nullptr, END-START+1, RAJA::operators::plus<GIDTYPE>{}, SCANVAR_OFFSET.Value(), true); \
    } else { \
       CARE_CHECKED_SEQUENTIAL_LOOP_START(INDX, 0, 1, scan_loop_gid_init_check) { \
-         SCANVAR[INDX] = SCANVAR_OFFSET.Value(); \
-         SCANVARLENGTH[0] = SCANVAR_OFFSET.Value(); \
+         SCANVARLENGTH[SCANVARSLOT] = SCANVAR_OFFSET.Value(); \
       } CARE_CHECKED_SEQUENTIAL_LOOP_END(scan_loop_gid_init_check) \
    }
 
 #endif // CARE_HAVE_LLNL_GLOBALID
 
+#define SCAN_LOOP_64_INIT(INDX, START, END, SCANVAR, SCANVARLENGTH, SCANVARSLOT, SCANVAR_OFFSET, EXPR) \
+   if (END - START > 0) { \
+      std::int64_t const SCANVARENDNAME(SCANVAR) = END; \
+      CARE_CHECKED_PARALLEL_LOOP_64_START(INDX, START, SCANVARENDNAME(SCANVAR)+1, scan_loop_64_init_check) { \
+         SCANVAR[INDX-START] = (INDX != SCANVARENDNAME(SCANVAR)) && (EXPR) ; \
+      } CARE_CHECKED_PARALLEL_LOOP_64_END(scan_loop_64_init_check) \
+      exclusive_scan<std::int64_t, RAJAExec>(SCANVAR, nullptr, END-START+1, RAJA::operators::plus<std::int64_t>{}, SCANVAR_OFFSET, true); \
+   } else { \
+      CARE_CHECKED_SEQUENTIAL_LOOP_START(INDX, 0, 1, scan_loop_64_init_check) { \
+         SCANVARLENGTH[SCANVARSLOT] = SCANVAR_OFFSET; \
+      } CARE_CHECKED_SEQUENTIAL_LOOP_END(scan_loop_64_init_check) \
+   }
+
 // grab the number of elements that met the scan criteria, place it in SCANLENGTH
-#define SCAN_LOOP_FINAL(END, SCANVARLENGTH, SCANCOUNT) getFinalScanCountFromPinned(SCANVARLENGTH, SCANCOUNT);
+#define SCAN_LOOP_FINAL(END, SCANVARLENGTH, SCANVARSLOT, SCANCOUNT) getFinalScanCountFromPinned(SCANVARLENGTH, SCANVARSLOT, SCANCOUNT);
 
 #define SCAN_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
    { \
       int const SCANVARSTARTNAME(SCANINDX) = START; \
-      ScanVar SCANVARNAME(SCANINDX)(END-START+1); \
-      ScanVar SCANVARLENGTHNAME(SCANINDX)(1, chai::PINNED); \
-      SCAN_LOOP_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      care::ScanWorkspace<int> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<int>::get(CHAIDataGetter<int, RAJAExec>::ChaiPolicy); \
+      ScanVar SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVar SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
       int const SCANVARENDNAME(SCANINDX) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END, scan_loop_check) { \
          if (INDX == SCANVARENDNAME(SCANINDX) -1) { \
-            SCANVARLENGTHNAME(SCANINDX)[0] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
          } \
          if (EXPR) { \
             const int SCANINDX = SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)];
 
 #define SCAN_LOOP_END(END, SCANINDX, SCANLENGTH) } \
    } CARE_CHECKED_PARALLEL_LOOP_END(scan_loop_check) \
-   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANLENGTH) \
-   SCANVARNAME(SCANINDX).free(); \
-   SCANVARLENGTHNAME(SCANINDX).free(); \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
    }
 
 #if CARE_HAVE_LLNL_GLOBALID
@@ -204,63 +479,155 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
 #define SCAN_LOOP_GID(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
    { \
       int const SCANVARSTARTNAME(SCANINDX) = START; \
-      ScanVarGID SCANVARNAME(SCANINDX)(END-START+1); \
-      ScanVarGID SCANVARLENGTHNAME(SCANINDX)(1, chai::PINNED); \
-      SCAN_LOOP_GID_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      care::ScanWorkspace<GIDTYPE> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<GIDTYPE>::get(CHAIDataGetter<int, RAJAExec>::ChaiPolicy); \
+      ScanVarGID SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVarGID SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_GID_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
       int const SCANVARENDNAME(SCANINDX) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END, scan_loop_gid_check) { \
          if (INDX == SCANVARENDNAME(SCANINDX)-1) { \
-            SCANVARLENGTHNAME(SCANINDX)[0] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
          } \
          if (EXPR) { \
             const globalID SCANINDX = globalID(SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)]);
 
 #define SCAN_LOOP_GID_END(END, SCANINDX, SCANLENGTH) } \
    } CARE_CHECKED_PARALLEL_LOOP_END(scan_loop_gid_check) \
-   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANLENGTH.Ref()) \
-   SCANVARNAME(SCANINDX).free(); \
-   SCANVARLENGTHNAME(SCANINDX).free(); \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH.Ref()) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
    }
 
 #endif // CARE_HAVE_LLNL_GLOBALID
 
 #define SCAN_EVERYWHERE_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
    { \
-      ScanVar SCANVARNAME(SCANINDX)(END-START+1); \
-      ScanVar SCANVARLENGTHNAME(SCANINDX)(1, chai::PINNED); \
-      SCAN_LOOP_INIT(INDX, START, END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      care::ScanWorkspace<int> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<int>::get(CHAIDataGetter<int, RAJAExec>::ChaiPolicy); \
+      ScanVar SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVar SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_INIT(INDX, START, END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
       int const SCANVARENDNAME(SCANINDX) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END, scaneverywhere_loop_check) { \
          if (INDX == SCANVARENDNAME(SCANINDX)-1) { \
-            SCANVARLENGTHNAME(SCANINDX)[0] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
          } \
          const int SCANINDX = SCANVARNAME(SCANINDX)[INDX-START];
 
 
 #define SCAN_EVERYWHERE_LOOP_END(END, SCANINDX, SCANLENGTH) \
    } CARE_CHECKED_PARALLEL_LOOP_END(scaneverywhere_loop_check) \
-   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANLENGTH) \
-   SCANVARNAME(SCANINDX).free(); \
-   SCANVARLENGTHNAME(SCANINDX).free(); \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
    }
 
 #define SCAN_EVERYWHERE_REDUCE_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
    { \
-      ScanVar SCANVARNAME(SCANINDX)(END-START+1); \
-      ScanVar SCANVARLENGTHNAME(SCANINDX)(1, chai::PINNED); \
-      SCAN_LOOP_INIT(INDX, START, END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      care::ScanWorkspace<int> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<int>::get(CHAIDataGetter<int, RAJAExec>::ChaiPolicy); \
+      ScanVar SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVar SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_INIT(INDX, START, END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
       int const SCANVARENDNAME(SCANINDX) = END; \
       CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END, scaneverywhere_reduce_loop_check) { \
          if (INDX == SCANVARENDNAME(SCANINDX)-1) { \
-            SCANVARLENGTHNAME(SCANINDX)[0] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
          } \
          const int SCANINDX = SCANVARNAME(SCANINDX)[INDX-START];
 
 #define SCAN_EVERYWHERE_REDUCE_LOOP_END(END, SCANINDX, SCANLENGTH) \
    } CARE_CHECKED_PARALLEL_LOOP_END(scaneverywhere_reduce_loop_check) \
-   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANLENGTH) \
-   SCANVARNAME(SCANINDX).free(); \
-   SCANVARLENGTHNAME(SCANINDX).free(); \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
+   }
+
+// 64 bit versions of SCAN_LOOP and SCAN_EVERYWHERE_LOOP, for compactions of
+// more than 2^31 elements or whose positions can pass 2^31. INDX, SCANINDX and
+// SCANLENGTH are std::int64_t, and START, END and SCANINDX_OFFSET may be.
+#define SCAN_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      std::int64_t const SCANVARSTARTNAME(SCANINDX) = START; \
+      care::ScanWorkspace<std::int64_t> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<std::int64_t>::get(CHAIDataGetter<std::int64_t, RAJAExec>::ChaiPolicy); \
+      ScanVar64 SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVar64 SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_64_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      std::int64_t const SCANVARENDNAME(SCANINDX) = END; \
+      CARE_CHECKED_PARALLEL_LOOP_64_START(INDX, SCANVARSTARTNAME(SCANINDX), SCANVARENDNAME(SCANINDX), scan_loop_64_check) { \
+         if (INDX == SCANVARENDNAME(SCANINDX) -1) { \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+         } \
+         if (EXPR) { \
+            const std::int64_t SCANINDX = SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)];
+
+#define SCAN_LOOP_64_END(END, SCANINDX, SCANLENGTH) } \
+   } CARE_CHECKED_PARALLEL_LOOP_64_END(scan_loop_64_check) \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
+   }
+
+#define SCAN_EVERYWHERE_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      care::ScanWorkspace<std::int64_t> & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<std::int64_t>::get(CHAIDataGetter<std::int64_t, RAJAExec>::ChaiPolicy); \
+      ScanVar64 SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      ScanVar64 SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_LOOP_64_INIT(INDX, START, END, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSET, EXPR); \
+      std::int64_t const SCANVARENDNAME(SCANINDX) = END; \
+      CARE_CHECKED_PARALLEL_LOOP_64_START(INDX, START, SCANVARENDNAME(SCANINDX), scaneverywhere_loop_64_check) { \
+         if (INDX == SCANVARENDNAME(SCANINDX)-1) { \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+         } \
+         const std::int64_t SCANINDX = SCANVARNAME(SCANINDX)[INDX-START];
+
+#define SCAN_EVERYWHERE_LOOP_64_END(END, SCANINDX, SCANLENGTH) \
+   } CARE_CHECKED_PARALLEL_LOOP_64_END(scaneverywhere_loop_64_check) \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTH) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
+   }
+
+// Multi-way partition. CATEGORYEXPR is evaluated once per index and gives its
+// category in [0, NUMCATEGORIES), or anything else to leave it out. The body runs
+// for each index in a category, with CATEGORY set to the category and SCANINDX to
+// the position of the index within it. SCANINDX_OFFSETS and SCANLENGTHS are
+// care::CategoryCounts<NUMCATEGORIES>, holding the first position of each category
+// and, at the end, the position after the last. All the categories are found with
+// one pass over the range and one scan, instead of one SCAN_LOOP per category.
+#define SCAN_PARTITION_LOOP_INIT(INDX, START, END, NUMCATEGORIES, SCANVAR, SCANVARLENGTH, SCANVARSLOT, SCANVAR_OFFSETS, CATEGORYEXPR) \
+   if (END - START > 0) { \
+      int const SCANVARENDNAME(SCANVAR) = END; \
+      CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END+1, scan_partition_loop_init_check) { \
+         SCANVAR[INDX-START] = care::CategoryCounts<NUMCATEGORIES>::unit(INDX != SCANVARENDNAME(SCANVAR) ? (CATEGORYEXPR) : -1); \
+      } CARE_CHECKED_PARALLEL_LOOP_END(scan_partition_loop_init_check) \
+      exclusive_scan<care::CategoryCounts<NUMCATEGORIES>, RAJAExec>(SCANVAR, nullptr, END-START+1, RAJA::operators::plus<care::CategoryCounts<NUMCATEGORIES> >{}, SCANVAR_OFFSETS, true); \
+   } else { \
+      CARE_CHECKED_SEQUENTIAL_LOOP_START(INDX, 0, 1, scan_partition_loop_init_check) { \
+         SCANVARLENGTH[SCANVARSLOT] = SCANVAR_OFFSETS; \
+      } CARE_CHECKED_SEQUENTIAL_LOOP_END(scan_partition_loop_init_check) \
+   }
+
+#define SCAN_PARTITION_LOOP(INDX, START, END, NUMCATEGORIES, CATEGORY, SCANINDX, SCANINDX_OFFSETS, CATEGORYEXPR) \
+   { \
+      int const SCANVARSTARTNAME(SCANINDX) = START; \
+      care::ScanWorkspace<care::CategoryCounts<NUMCATEGORIES> > & SCANVARWORKSPACENAME(SCANINDX) = care::ScanWorkspace<care::CategoryCounts<NUMCATEGORIES> >::get(CHAIDataGetter<int, RAJAExec>::ChaiPolicy); \
+      chai::ManagedArray<care::CategoryCounts<NUMCATEGORIES> > SCANVARNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).scanArray(END-START+1); \
+      chai::ManagedArray<care::CategoryCounts<NUMCATEGORIES> > SCANVARLENGTHNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).counts(); \
+      int const SCANVARSLOTNAME(SCANINDX) = SCANVARWORKSPACENAME(SCANINDX).nextCountSlot(); \
+      SCAN_PARTITION_LOOP_INIT(INDX, SCANVARSTARTNAME(SCANINDX), END, NUMCATEGORIES, SCANVARNAME(SCANINDX), SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANINDX_OFFSETS, CATEGORYEXPR); \
+      int const SCANVARENDNAME(SCANINDX) = END; \
+      CARE_CHECKED_PARALLEL_LOOP_START(INDX, START, END, scan_partition_loop_check) { \
+         if (INDX == SCANVARENDNAME(SCANINDX)-1) { \
+            SCANVARLENGTHNAME(SCANINDX)[SCANVARSLOTNAME(SCANINDX)] = SCANVARNAME(SCANINDX)[SCANVARENDNAME(SCANINDX)-START]; \
+         } \
+         const int CATEGORY = care::CategoryCounts<NUMCATEGORIES>::category(SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)], \
+                                                                             SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)+1]); \
+         if (CATEGORY >= 0) { \
+            const int SCANINDX = SCANVARNAME(SCANINDX)[INDX-SCANVARSTARTNAME(SCANINDX)][CATEGORY];
+
+#define SCAN_PARTITION_LOOP_END(END, SCANINDX, SCANLENGTHS) } \
+   } CARE_CHECKED_PARALLEL_LOOP_END(scan_partition_loop_check) \
+   SCAN_LOOP_FINAL(END, SCANVARLENGTHNAME(SCANINDX), SCANVARSLOTNAME(SCANINDX), SCANLENGTHS) \
+   SCANVARWORKSPACENAME(SCANINDX).releaseScanArray(SCANVARNAME(SCANINDX)); \
    }
 
 #define SCAN_COUNTS_TO_OFFSETS_LOOP(INDX, START, END, SCANVAR) \
@@ -273,6 +640,133 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
    }
          
 
+#elif defined(_OPENMP) && defined(OPENMP_ACTIVE) && CARE_ENABLE_PARALLEL_HOST_SCAN && !defined(CARE_LEGACY_COMPATIBILITY_MODE)
+
+// OpenMP version of scan idiom. A single pass over the index range with the
+// chained scan, see care::chained_scan. EXPR is evaluated once per index and
+// the body runs in parallel in a lambda, and no scan array is allocated.
+#define SCAN_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      int SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_NEST_BEGIN(scan_loop_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<int>(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const int INDX) -> int { return (EXPR) ? 1 : 0; }, \
+         RAJA::operators::plus<int>{}, \
+         [=] (const int INDX, const int SCANVARLENGTHNAME(SCANINDX), const int SCANVARFLAGNAME(SCANINDX)) { \
+         if (SCANVARFLAGNAME(SCANINDX)) { \
+            const int SCANINDX = SCANVARLENGTHNAME(SCANINDX);
+
+#define SCAN_LOOP_END(END, SCANINDX, SCANLENGTH) } \
+   }); \
+   CARE_NEST_END(scan_loop_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_EVERYWHERE_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      int SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_NEST_BEGIN(scaneverywhere_loop_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<int>(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const int INDX) -> int { return (EXPR) ? 1 : 0; }, \
+         RAJA::operators::plus<int>{}, \
+         [=] (const int INDX, const int SCANINDX, const int) {
+
+#define SCAN_EVERYWHERE_LOOP_END(END, SCANINDX, SCANLENGTH) \
+   }); \
+   CARE_NEST_END(scaneverywhere_loop_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_EVERYWHERE_REDUCE_LOOP(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      int SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_NEST_BEGIN(scaneverywhere_reduce_loop_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<int>(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const int INDX) -> int { return (EXPR) ? 1 : 0; }, \
+         RAJA::operators::plus<int>{}, \
+         [=] (const int INDX, const int SCANINDX, const int) {
+
+#define SCAN_EVERYWHERE_REDUCE_LOOP_END(END, SCANINDX, SCANLENGTH) \
+   }); \
+   CARE_NEST_END(scaneverywhere_reduce_loop_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      std::int64_t SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_NEST_BEGIN(scan_loop_64_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<std::int64_t, std::int64_t>(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const std::int64_t INDX) -> std::int64_t { return (EXPR) ? 1 : 0; }, \
+         RAJA::operators::plus<std::int64_t>{}, \
+         [=] (const std::int64_t INDX, const std::int64_t SCANVARLENGTHNAME(SCANINDX), const std::int64_t SCANVARFLAGNAME(SCANINDX)) { \
+         if (SCANVARFLAGNAME(SCANINDX)) { \
+            const std::int64_t SCANINDX = SCANVARLENGTHNAME(SCANINDX);
+
+#define SCAN_LOOP_64_END(END, SCANINDX, SCANLENGTH) } \
+   }); \
+   CARE_NEST_END(scan_loop_64_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_EVERYWHERE_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      std::int64_t SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_NEST_BEGIN(scaneverywhere_loop_64_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<std::int64_t, std::int64_t>(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const std::int64_t INDX) -> std::int64_t { return (EXPR) ? 1 : 0; }, \
+         RAJA::operators::plus<std::int64_t>{}, \
+         [=] (const std::int64_t INDX, const std::int64_t SCANINDX, const std::int64_t) {
+
+#define SCAN_EVERYWHERE_LOOP_64_END(END, SCANINDX, SCANLENGTH) \
+   }); \
+   CARE_NEST_END(scaneverywhere_loop_64_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_PARTITION_LOOP(INDX, START, END, NUMCATEGORIES, CATEGORY, SCANINDX, SCANINDX_OFFSETS, CATEGORYEXPR) \
+   { \
+      care::CategoryCounts<NUMCATEGORIES> SCANVARNAME(SCANINDX) = SCANINDX_OFFSETS; \
+      CARE_NEST_BEGIN(scan_partition_loop_check) \
+      SCANVARNAME(SCANINDX) = care::chained_scan<care::CategoryCounts<NUMCATEGORIES> >(__FILE__, __LINE__, START, END, SCANVARNAME(SCANINDX), \
+         [=] (const int INDX) -> care::CategoryCounts<NUMCATEGORIES> { return care::CategoryCounts<NUMCATEGORIES>::unit(CATEGORYEXPR); }, \
+         RAJA::operators::plus<care::CategoryCounts<NUMCATEGORIES> >{}, \
+         [=] (const int INDX, const care::CategoryCounts<NUMCATEGORIES> & SCANVARLENGTHNAME(SCANINDX), const care::CategoryCounts<NUMCATEGORIES> & SCANVARFLAGNAME(SCANINDX)) { \
+         const int CATEGORY = care::CategoryCounts<NUMCATEGORIES>::category(SCANVARFLAGNAME(SCANINDX)); \
+         if (CATEGORY >= 0) { \
+            const int SCANINDX = SCANVARLENGTHNAME(SCANINDX)[CATEGORY];
+
+#define SCAN_PARTITION_LOOP_END(END, SCANINDX, SCANLENGTHS) } \
+   }); \
+   CARE_NEST_END(scan_partition_loop_check) \
+   SCANLENGTHS = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_COUNTS_TO_OFFSETS_LOOP(INDX, START, END, SCANVAR) \
+   { \
+      CARE_CHECKED_OPENMP_LOOP_START(INDX, START, END, scan_counts_to_offsets_loop_check) { \
+
+#define SCAN_COUNTS_TO_OFFSETS_LOOP_END(INDX, LENGTH, SCANVAR) \
+      } CARE_CHECKED_OPENMP_LOOP_END(scan_counts_to_offsets_loop_check) \
+      exclusive_scan<int, RAJA::omp_parallel_for_exec>(SCANVAR, nullptr, LENGTH, RAJA::operators::plus<int>{}, 0, true); \
+   }
+
+#if CARE_HAVE_LLNL_GLOBALID
+
+#define SCAN_LOOP_GID(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      globalID SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_START(INDX, START, END, scan_loop_gid_check, SCANVARNAME(SCANINDX)) { \
+         if (EXPR) { \
+            const globalID SCANINDX = SCANVARNAME(SCANINDX)++;
+
+#define SCAN_LOOP_GID_END(END, SCANINDX, SCANLENGTH) } \
+   } CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_END(scan_loop_gid_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#endif // CARE_HAVE_LLNL_GLOBALID
+
 #else // GPU_ACTIVE || CARE_ALWAYS_USE_RAJA_SCAN
 
 // CPU version of scan idiom. Designed to look like we're doing a scan, but
@@ -321,6 +815,42 @@ using ScanVarGID = chai::ManagedArray<GIDTYPE>;
    SCANLENGTH = SCANVARNAME(SCANINDX); \
    }
 
+#define SCAN_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      std::int64_t SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_START(INDX, START, END, scan_loop_64_check, SCANVARNAME(SCANINDX)) { \
+         if (EXPR) { \
+            const std::int64_t SCANINDX = SCANVARNAME(SCANINDX)++;
+
+#define SCAN_LOOP_64_END(END, SCANINDX, SCANLENGTH) } \
+   } CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_END(scan_loop_64_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_EVERYWHERE_LOOP_64(INDX, START, END, SCANINDX, SCANINDX_OFFSET, EXPR) \
+   { \
+      std::int64_t SCANVARNAME(SCANINDX) = SCANINDX_OFFSET; \
+      CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_START(INDX, START, END, scaneverywhere_loop_64_check, SCANVARNAME(SCANINDX)) { \
+         const std::int64_t SCANINDX = (EXPR) ?  SCANVARNAME(SCANINDX)++ : SCANVARNAME(SCANINDX);
+
+#define SCAN_EVERYWHERE_LOOP_64_END(END, SCANINDX, SCANLENGTH) \
+   } CARE_CHECKED_SEQUENTIAL_LOOP_64_WITH_REF_END(scaneverywhere_loop_64_check) \
+   SCANLENGTH = SCANVARNAME(SCANINDX); \
+   }
+
+#define SCAN_PARTITION_LOOP(INDX, START, END, NUMCATEGORIES, CATEGORY, SCANINDX, SCANINDX_OFFSETS, CATEGORYEXPR) \
+   { \
+      care::CategoryCounts<NUMCATEGORIES> SCANVARNAME(SCANINDX) = SCANINDX_OFFSETS; \
+      CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_START(INDX, START, END, scan_partition_loop_check, SCANVARNAME(SCANINDX)) { \
+         const int CATEGORY = (CATEGORYEXPR); \
+         if (CATEGORY >= 0 && CATEGORY < NUMCATEGORIES) { \
+            const int SCANINDX = SCANVARNAME(SCANINDX)[CATEGORY]++;
+
+#define SCAN_PARTITION_LOOP_END(END, SCANINDX, SCANLENGTHS) } \
+   } CARE_CHECKED_SEQUENTIAL_LOOP_WITH_REF_END(scan_partition_loop_check) \
+   SCANLENGTHS = SCANVARNAME(SCANINDX); \
+   }
+
 #define SCAN_COUNTS_TO_OFFSETS_LOOP(INDX, START, END, SCANVAR) \
    { \
       CARE_CHECKED_SEQUENTIAL_LOOP_START(INDX, START, END, scan_counts_to_offsets_loop_check) { \
@@ -0,0 +1,568 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_SIMD_H_
+#define _CARE_SIMD_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other library headers
+#include "RAJA/RAJA.hpp"
+
+// Std library headers
+#include <type_traits>
+#include <vector>
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+   #include <omp.h>
+#endif
+
+// Explicit AVX2/AVX-512 kernels need GCC style target attributes and runtime
+// cpu detection. Everywhere else the portable kernels below are used.
+#if CARE_ENABLE_SIMD && !defined(__GPUCC__) && !defined(__INTEL_COMPILER) && \
+    (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CARE_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define CARE_HAVE_X86_SIMD 0
+#endif
+
+// host_device_ptr data can be read directly on the host whenever RAJAExec
+// is a host policy (sequential or OpenMP).
+#if CARE_ENABLE_SIMD && !(defined(__GPUCC__) && defined(GPU_ACTIVE))
+#define CARE_SIMD_HOST_EXEC
+#endif
+
+namespace care {
+   namespace simd {
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Instruction sets the kernels in this file can dispatch to
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      enum class Level {
+         SCALAR = 0,
+         AVX2 = 1,
+         AVX512 = 2
+      };
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns the widest instruction set supported by the running cpu
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      inline Level getMaxLevel() {
+#if CARE_HAVE_X86_SIMD
+         static const Level maxLevel = [] {
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx512f")) {
+               return Level::AVX512;
+            }
+            else if (__builtin_cpu_supports("avx2")) {
+               return Level::AVX2;
+            }
+            else {
+               return Level::SCALAR;
+            }
+         }();
+
+         return maxLevel;
+#else
+         return Level::SCALAR;
+#endif
+      }
+
+      namespace detail {
+         inline Level& currentLevel() {
+            static Level level = getMaxLevel();
+            return level;
+         }
+
+         // Below this length the OpenMP overloads do not start a parallel region
+         constexpr int minParallelLength = 1 << 15;
+
+         enum class Operation {
+            MIN,
+            MAX,
+            SUM
+         };
+      } // namespace detail
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns the instruction set the kernels currently dispatch to
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      inline Level getLevel() {
+         return detail::currentLevel();
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Restricts the kernels to the given instruction set (clamped to what
+      ///        the cpu supports). Mainly useful for testing and benchmarking.
+      ///
+      /// @arg[in] level The widest instruction set to use
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      inline void setLevel(Level level) {
+         const Level maxLevel = getMaxLevel();
+         detail::currentLevel() = static_cast<int>(level) < static_cast<int>(maxLevel) ? level : maxLevel;
+      }
+
+      namespace detail {
+         template <Operation Op, typename T>
+         inline T apply(const T& lhs, const T& rhs) {
+            // same argument order as CARE_MIN / CARE_MAX, which the vector
+            // min / max instructions also follow for unordered operands
+            return Op == Operation::MIN ? (lhs < rhs ? lhs : rhs) :
+                   Op == Operation::MAX ? (lhs > rhs ? lhs : rhs) :
+                                          lhs + rhs;
+         }
+
+         // Portable kernels. Independent accumulators break the loop carried
+         // dependency so the compiler is free to vectorize and pipeline.
+         namespace scalar {
+            template <Operation Op, typename T, typename R>
+            inline R reduce(const T* data, int n, R initVal) {
+               const R identity = Op == Operation::SUM ? R(0) : initVal;
+               R acc0 = identity, acc1 = identity, acc2 = identity, acc3 = identity;
+               int i = 0;
+
+               for (; i + 4 <= n; i += 4) {
+                  acc0 = apply<Op>(acc0, (R) data[i]);
+                  acc1 = apply<Op>(acc1, (R) data[i + 1]);
+                  acc2 = apply<Op>(acc2, (R) data[i + 2]);
+                  acc3 = apply<Op>(acc3, (R) data[i + 3]);
+               }
+
+               R result = apply<Op>(initVal, apply<Op>(apply<Op>(acc0, acc1), apply<Op>(acc2, acc3)));
+
+               for (; i < n; ++i) {
+                  result = apply<Op>(result, (R) data[i]);
+               }
+
+               return result;
+            }
+
+            template <typename T>
+            inline int count(const T* data, int n, T value) {
+               int count0 = 0, count1 = 0, count2 = 0, count3 = 0;
+               int i = 0;
+
+               for (; i + 4 <= n; i += 4) {
+                  count0 += data[i] == value;
+                  count1 += data[i + 1] == value;
+                  count2 += data[i + 2] == value;
+                  count3 += data[i + 3] == value;
+               }
+
+               int result = count0 + count1 + count2 + count3;
+
+               for (; i < n; ++i) {
+                  result += data[i] == value;
+               }
+
+               return result;
+            }
+
+            template <typename T>
+            inline void fill(T* data, int n, T value) {
+               for (int i = 0; i < n; ++i) {
+                  data[i] = value;
+               }
+            }
+         } // namespace scalar
+
+#if CARE_HAVE_X86_SIMD
+
+#define CARE_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define CARE_SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+
+         // Each instruction set gets the same kernels; only the target
+         // attribute differs, which cannot be a template parameter.
+#define CARE_SIMD_DEFINE_KERNELS(TARGET)                                                    \
+         template <typename V, Operation Op>                                                 \
+         TARGET inline typename V::Scalar reduce(const typename V::Scalar* data, int n,      \
+                                                 typename V::Scalar initVal) {               \
+            using Scalar = typename V::Scalar;                                               \
+            typename V::Vector acc0 = V::set1(Op == Operation::SUM ? Scalar(0) : initVal);   \
+            typename V::Vector acc1 = acc0;                                                  \
+            int i = 0;                                                                       \
+            for (; i + 2 * V::width <= n; i += 2 * V::width) {                              \
+               acc0 = V::template apply<Op>(acc0, V::load(data + i));                        \
+               acc1 = V::template apply<Op>(acc1, V::load(data + i + V::width));             \
+            }                                                                                \
+            Scalar lanes[V::width];                                                          \
+            V::store(lanes, V::template apply<Op>(acc0, acc1));                              \
+            Scalar result = initVal;                                                         \
+            for (int k = 0; k < V::width; ++k) {                                             \
+               result = detail::apply<Op>(result, lanes[k]);                                 \
+            }                                                                                \
+            for (; i < n; ++i) {                                                             \
+               result = detail::apply<Op>(result, data[i]);                                  \
+            }                                                                                \
+            return result;                                                                   \
+         }                                                                                   \
+                                                                                             \
+         template <typename V>                                                               \
+         TARGET inline int count(const typename V::Scalar* data, int n,                      \
+                                 typename V::Scalar value) {                                 \
+            const typename V::Vector target = V::set1(value);                                \
+            int result = 0;                                                                  \
+            int i = 0;                                                                       \
+            for (; i + V::width <= n; i += V::width) {                                       \
+               result += V::countEqual(V::load(data + i), target);                           \
+            }                                                                                \
+            for (; i < n; ++i) {                                                             \
+               result += data[i] == value;                                                   \
+            }                                                                                \
+            return result;                                                                   \
+         }                                                                                   \
+                                                                                             \
+         template <typename V>                                                               \
+         TARGET inline void fill(typename V::Scalar* data, int n, typename V::Scalar value) { \
+            const typename V::Vector vector = V::set1(value);                                \
+            int i = 0;                                                                       \
+            for (; i + V::width <= n; i += V::width) {                                       \
+               V::store(data + i, vector);                                                   \
+            }                                                                                \
+            for (; i < n; ++i) {                                                             \
+               data[i] = value;                                                              \
+            }                                                                                \
+         }
+
+#define CARE_SIMD_DEFINE_TRAITS(NAME, TARGET, SCALAR, VECTOR, WIDTH, SET1, LOAD, STORE,     \
+                                MIN_FN, MAX_FN, ADD_FN, COUNT_EQUAL)                         \
+         struct NAME {                                                                       \
+            using Scalar = SCALAR;                                                           \
+            using Vector = VECTOR;                                                           \
+            static constexpr int width = WIDTH;                                              \
+            TARGET static inline Vector set1(Scalar value) { return SET1(value); }           \
+            TARGET static inline Vector load(const Scalar* data) { return LOAD(data); }      \
+            TARGET static inline void store(Scalar* data, Vector value) { STORE(data, value); } \
+            TARGET static inline int countEqual(Vector a, Vector b) { return COUNT_EQUAL(a, b); } \
+            template <Operation Op>                                                          \
+            TARGET static inline Vector apply(Vector a, Vector b) {                          \
+               return Op == Operation::MIN ? MIN_FN(a, b) :                                  \
+                      Op == Operation::MAX ? MAX_FN(a, b) :                                  \
+                                             ADD_FN(a, b);                                   \
+            }                                                                                \
+         };
+
+#define CARE_SIMD_LOAD_SI256(data) _mm256_loadu_si256((const __m256i*) (data))
+#define CARE_SIMD_STORE_SI256(data, value) _mm256_storeu_si256((__m256i*) (data), value)
+#define CARE_SIMD_COUNT_EQUAL_AVX2_PD(a, b) __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)))
+#define CARE_SIMD_COUNT_EQUAL_AVX2_PS(a, b) __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)))
+#define CARE_SIMD_COUNT_EQUAL_AVX2_EPI32(a, b) __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))))
+
+#define CARE_SIMD_LOAD_SI512(data) _mm512_loadu_si512((const void*) (data))
+#define CARE_SIMD_STORE_SI512(data, value) _mm512_storeu_si512((void*) (data), value)
+#define CARE_SIMD_COUNT_EQUAL_AVX512_PD(a, b) __builtin_popcount(_mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ))
+#define CARE_SIMD_COUNT_EQUAL_AVX512_PS(a, b) __builtin_popcount(_mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ))
+#define CARE_SIMD_COUNT_EQUAL_AVX512_EPI32(a, b) __builtin_popcount(_mm512_cmpeq_epi32_mask(a, b))
+
+         namespace avx2 {
+            CARE_SIMD_DEFINE_TRAITS(Double, CARE_SIMD_TARGET_AVX2, double, __m256d, 4,
+                                    _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+                                    _mm256_min_pd, _mm256_max_pd, _mm256_add_pd,
+                                    CARE_SIMD_COUNT_EQUAL_AVX2_PD)
+
+            CARE_SIMD_DEFINE_TRAITS(Float, CARE_SIMD_TARGET_AVX2, float, __m256, 8,
+                                    _mm256_set1_ps, _mm256_loadu_ps, _mm256_storeu_ps,
+                                    _mm256_min_ps, _mm256_max_ps, _mm256_add_ps,
+                                    CARE_SIMD_COUNT_EQUAL_AVX2_PS)
+
+            CARE_SIMD_DEFINE_TRAITS(Int, CARE_SIMD_TARGET_AVX2, int, __m256i, 8,
+                                    _mm256_set1_epi32, CARE_SIMD_LOAD_SI256, CARE_SIMD_STORE_SI256,
+                                    _mm256_min_epi32, _mm256_max_epi32, _mm256_add_epi32,
+                                    CARE_SIMD_COUNT_EQUAL_AVX2_EPI32)
+
+            CARE_SIMD_DEFINE_KERNELS(CARE_SIMD_TARGET_AVX2)
+         } // namespace avx2
+
+         namespace avx512 {
+            CARE_SIMD_DEFINE_TRAITS(Double, CARE_SIMD_TARGET_AVX512, double, __m512d, 8,
+                                    _mm512_set1_pd, _mm512_loadu_pd, _mm512_storeu_pd,
+                                    _mm512_min_pd, _mm512_max_pd, _mm512_add_pd,
+                                    CARE_SIMD_COUNT_EQUAL_AVX512_PD)
+
+            CARE_SIMD_DEFINE_TRAITS(Float, CARE_SIMD_TARGET_AVX512, float, __m512, 16,
+                                    _mm512_set1_ps, _mm512_loadu_ps, _mm512_storeu_ps,
+                                    _mm512_min_ps, _mm512_max_ps, _mm512_add_ps,
+                                    CARE_SIMD_COUNT_EQUAL_AVX512_PS)
+
+            CARE_SIMD_DEFINE_TRAITS(Int, CARE_SIMD_TARGET_AVX512, int, __m512i, 16,
+                                    _mm512_set1_epi32, CARE_SIMD_LOAD_SI512, CARE_SIMD_STORE_SI512,
+                                    _mm512_min_epi32, _mm512_max_epi32, _mm512_add_epi32,
+                                    CARE_SIMD_COUNT_EQUAL_AVX512_EPI32)
+
+            CARE_SIMD_DEFINE_KERNELS(CARE_SIMD_TARGET_AVX512)
+         } // namespace avx512
+
+         template <typename AVX2, typename AVX512>
+         struct DispatchedKernels {
+            using T = typename AVX2::Scalar;
+
+            template <Operation Op>
+            static T reduce(const T* data, int n, T initVal) {
+               switch (getLevel()) {
+                  case Level::AVX512:
+                     return avx512::reduce<AVX512, Op>(data, n, initVal);
+                  case Level::AVX2:
+                     return avx2::reduce<AVX2, Op>(data, n, initVal);
+                  default:
+                     return scalar::reduce<Op>(data, n, initVal);
+               }
+            }
+
+            static int count(const T* data, int n, T value) {
+               switch (getLevel()) {
+                  case Level::AVX512:
+                     return avx512::count<AVX512>(data, n, value);
+                  case Level::AVX2:
+                     return avx2::count<AVX2>(data, n, value);
+                  default:
+                     return scalar::count(data, n, value);
+               }
+            }
+
+            static void fill(T* data, int n, T value) {
+               switch (getLevel()) {
+                  case Level::AVX512:
+                     avx512::fill<AVX512>(data, n, value);
+                     break;
+                  case Level::AVX2:
+                     avx2::fill<AVX2>(data, n, value);
+                     break;
+                  default:
+                     scalar::fill(data, n, value);
+                     break;
+               }
+            }
+         };
+
+#endif // CARE_HAVE_X86_SIMD
+
+         // Types without explicit kernels use the portable ones
+         template <typename T>
+         struct Kernels {
+            template <Operation Op>
+            static T reduce(const T* data, int n, T initVal) {
+               return scalar::reduce<Op>(data, n, initVal);
+            }
+
+            static int count(const T* data, int n, T value) {
+               return scalar::count(data, n, value);
+            }
+
+            static void fill(T* data, int n, T value) {
+               scalar::fill(data, n, value);
+            }
+         };
+
+#if CARE_HAVE_X86_SIMD
+         template <>
+         struct Kernels<double> : DispatchedKernels<avx2::Double, avx512::Double> {};
+
+         template <>
+         struct Kernels<float> : DispatchedKernels<avx2::Float, avx512::Float> {};
+
+         template <>
+         struct Kernels<int> : DispatchedKernels<avx2::Int, avx512::Int> {};
+#endif // CARE_HAVE_X86_SIMD
+
+         template <Operation Op, typename T, typename R>
+         inline R reduce(const T* data, int n, R initVal, std::true_type) {
+            return Kernels<T>::template reduce<Op>(data, n, initVal);
+         }
+
+         template <Operation Op, typename T, typename R>
+         inline R reduce(const T* data, int n, R initVal, std::false_type) {
+            return scalar::reduce<Op>(data, n, initVal);
+         }
+
+         template <Operation Op, typename T, typename R>
+         inline R reduce(const T* data, int n, R initVal) {
+            return reduce<Op>(data, n, initVal, std::is_same<T, R>{});
+         }
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+         /////////////////////////////////////////////////////////////////////////////////
+         ///
+         /// @brief Splits [0, n) into one contiguous chunk per thread and combines
+         ///        the per-thread results in thread order, so results do not
+         ///        depend on scheduling. Runs serially for short arrays or when
+         ///        already inside a parallel region.
+         ///
+         /// @arg[in] n The number of elements
+         /// @arg[in] identity The result for an empty chunk
+         /// @arg[in] kernel Called as kernel(offset, length) for each chunk
+         /// @arg[in] combine Combines the results of two chunks
+         ///
+         /////////////////////////////////////////////////////////////////////////////////
+         template <typename R, typename Kernel, typename Combine>
+         inline R parallelReduce(int n, R identity, Kernel kernel, Combine combine) {
+            if (n < minParallelLength || omp_in_parallel()) {
+               return kernel(0, n);
+            }
+
+            std::vector<R> partials(omp_get_max_threads(), identity);
+
+#pragma omp parallel
+            {
+               const int thread = omp_get_thread_num();
+               const int numThreads = omp_get_num_threads();
+               const int begin = (int) ((long long) n * thread / numThreads);
+               const int end = (int) ((long long) n * (thread + 1) / numThreads);
+               partials[thread] = kernel(begin, end - begin);
+            }
+
+            R result = partials[0];
+
+            for (size_t thread = 1; thread < partials.size(); ++thread) {
+               result = combine(result, partials[thread]);
+            }
+
+            return result;
+         }
+#endif // defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+      } // namespace detail
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns the minimum of initVal and data[0, n) using the widest
+      ///        instruction set enabled for the element type
+      ///
+      /// @arg[in] policy The execution policy (sequential or OpenMP)
+      /// @arg[in] data The host array to reduce
+      /// @arg[in] n The number of elements
+      /// @arg[in] initVal The starting value
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      template <typename ExecutionPolicy, typename T>
+      inline T reduceMin(ExecutionPolicy, const T* data, int n, T initVal) {
+         return detail::reduce<detail::Operation::MIN>(data, n, initVal);
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns the maximum of initVal and data[0, n)
+      ///
+      /// @arg[in] policy The execution policy (sequential or OpenMP)
+      /// @arg[in] data The host array to reduce
+      /// @arg[in] n The number of elements
+      /// @arg[in] initVal The starting value
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      template <typename ExecutionPolicy, typename T>
+      inline T reduceMax(ExecutionPolicy, const T* data, int n, T initVal) {
+         return detail::reduce<detail::Operation::MAX>(data, n, initVal);
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns initVal plus the sum of data[0, n), accumulated in type R.
+      ///        Vector kernels are used when R is the element type. The
+      ///        summation order differs from a sequential loop, so floating
+      ///        point results can differ in the last bits.
+      ///
+      /// @arg[in] policy The execution policy (sequential or OpenMP)
+      /// @arg[in] data The host array to reduce
+      /// @arg[in] n The number of elements
+      /// @arg[in] initVal The starting value
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      template <typename ExecutionPolicy, typename T, typename R>
+      inline R reduceSum(ExecutionPolicy, const T* data, int n, R initVal) {
+         return detail::reduce<detail::Operation::SUM>(data, n, initVal);
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Returns the number of elements of data[0, n) equal to value
+      ///
+      /// @arg[in] policy The execution policy (sequential or OpenMP)
+      /// @arg[in] data The host array to search
+      /// @arg[in] n The number of elements
+      /// @arg[in] value The value to count
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      template <typename ExecutionPolicy, typename T>
+      inline int count(ExecutionPolicy, const T* data, int n, T value) {
+         return detail::Kernels<T>::count(data, n, value);
+      }
+
+      /////////////////////////////////////////////////////////////////////////////////
+      ///
+      /// @brief Sets data[0, n) to value
+      ///
+      /// @arg[in] policy The execution policy (sequential or OpenMP)
+      /// @arg[out] data The host array to fill
+      /// @arg[in] n The number of elements
+      /// @arg[in] value The value to fill with
+      ///
+      /////////////////////////////////////////////////////////////////////////////////
+      template <typename ExecutionPolicy, typename T>
+      inline void fill(ExecutionPolicy, T* data, int n, T value) {
+         detail::Kernels<T>::fill(data, n, value);
+      }
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+      template <typename T>
+      inline T reduceMin(RAJA::omp_parallel_for_exec, const T* data, int n, T initVal) {
+         return detail::parallelReduce(n, initVal,
+                                       [=] (int offset, int length) {
+                                          return detail::reduce<detail::Operation::MIN>(data + offset, length, initVal);
+                                       },
+                                       detail::apply<detail::Operation::MIN, T>);
+      }
+
+      template <typename T>
+      inline T reduceMax(RAJA::omp_parallel_for_exec, const T* data, int n, T initVal) {
+         return detail::parallelReduce(n, initVal,
+                                       [=] (int offset, int length) {
+                                          return detail::reduce<detail::Operation::MAX>(data + offset, length, initVal);
+                                       },
+                                       detail::apply<detail::Operation::MAX, T>);
+      }
+
+      template <typename T, typename R>
+      inline R reduceSum(RAJA::omp_parallel_for_exec, const T* data, int n, R initVal) {
+         return initVal + detail::parallelReduce(n, R(0),
+                                                 [=] (int offset, int length) {
+                                                    return detail::reduce<detail::Operation::SUM>(data + offset, length, R(0));
+                                                 },
+                                                 detail::apply<detail::Operation::SUM, R>);
+      }
+
+      template <typename T>
+      inline int count(RAJA::omp_parallel_for_exec, const T* data, int n, T value) {
+         return detail::parallelReduce(n, 0,
+                                       [=] (int offset, int length) {
+                                          return detail::Kernels<T>::count(data + offset, length, value);
+                                       },
+                                       detail::apply<detail::Operation::SUM, int>);
+      }
+
+      template <typename T>
+      inline void fill(RAJA::omp_parallel_for_exec, T* data, int n, T value) {
+         detail::parallelReduce(n, 0,
+                                [=] (int offset, int length) {
+                                   detail::Kernels<T>::fill(data + offset, length, value);
+                                   return 0;
+                                },
+                                detail::apply<detail::Operation::SUM, int>);
+      }
+#endif // defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+   } // namespace simd
+} // namespace care
+
+#endif // !defined(_CARE_SIMD_H_)
+
@@ -0,0 +1,288 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CARE_UNORDERED_MAP_H_
+#define _CARE_UNORDERED_MAP_H_
+
+// CARE config header
+#include "care/config.h"
+
+// Other CARE headers
+#include "care/care.h"
+#include "care/util.h"
+
+namespace care {
+   ////////////////////////////////////////////////////////////////
+   ///
+   /// A read-only hash map from Key to Value, built in parallel
+   /// from arrays of keys and values. The main use is mapping
+   /// global IDs to local indices, which otherwise needs a sort
+   /// and a binary search per lookup.
+   ///
+   /// The table uses open addressing with linear probing and at
+   /// least twice as many slots as keys. Keys and values are
+   /// stored in the slots themselves, so a lookup that hits on
+   /// the first probe touches one cache line of each. Like
+   /// host_device_ptr, it is captured by value in loops, where
+   /// findSlot, contains and lookup query it on the host or the
+   /// device. Outside of loops, use hostFindSlot, hostContains and
+   /// hostLookup, which read the table through the host copy.
+   ///
+   /// If a key is given more than once, the value paired with its
+   /// first occurrence is kept.
+   ///
+   ////////////////////////////////////////////////////////////////
+   template <typename Key, typename Value = int>
+   class unordered_map {
+      public:
+         using key_type = Key;
+         using mapped_type = Value;
+         using size_type = int;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Default constructor. Finds nothing.
+         ///////////////////////////////////////////////////////////////////////////
+         unordered_map() = default;
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Maps keys[i] to values[i] for i in [0, n)
+         /// @param[in] keys   The keys
+         /// @param[in] values The values paired with the keys
+         /// @param[in] n      The number of pairs
+         ///////////////////////////////////////////////////////////////////////////
+         unordered_map(host_device_ptr<const Key> keys, host_device_ptr<const Value> values, const int n) {
+            build(keys, values, n);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Maps keys[i] to i for i in [0, n), the inverse of keys
+         /// @param[in] keys The keys, such as the global IDs of local entities
+         /// @param[in] n    The number of keys
+         ///////////////////////////////////////////////////////////////////////////
+         unordered_map(host_device_ptr<const Key> keys, const int n) {
+            build(keys, host_device_ptr<const Value>(nullptr), n);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the number of slots needed for n keys, the smallest
+         ///        power of two that is at least 2n
+         ///////////////////////////////////////////////////////////////////////////
+         static int capacityFor(const int n) {
+            int capacity = 2;
+
+            while (capacity < 2 * n) {
+               capacity <<= 1;
+            }
+
+            return capacity;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the number of distinct keys
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE size_type size() const {
+            return m_size;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether there are no keys
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE bool empty() const {
+            return m_size == 0;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the number of slots
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE size_type capacity() const {
+            return m_capacity;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the slot holding key, or -1 if it is not present.
+         ///        Must be called in a loop that captures the map.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE int findSlot(const Key& key) const {
+            return probe(m_occupied, m_keys, key);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether key is present. Must be called in a loop that
+         ///        captures the map.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE bool contains(const Key& key) const {
+            return findSlot(key) != -1;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the value mapped to key, or notFound if it is not
+         ///        present. Must be called in a loop that captures the map.
+         ///////////////////////////////////////////////////////////////////////////
+         CARE_HOST_DEVICE Value lookup(const Key& key, const Value notFound) const {
+            const int slot = findSlot(key);
+            return slot == -1 ? notFound : m_values[slot];
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the slot holding key, or -1 if it is not present.
+         ///        Called on the host outside of loops, and brings the table to
+         ///        the host if it was built on the device.
+         ///////////////////////////////////////////////////////////////////////////
+         int hostFindSlot(const Key& key) const {
+            if (m_capacity == 0) {
+               return -1;
+            }
+
+            return probe(host_ptr<const bool>(host_device_ptr<const bool>(m_occupied)),
+                         host_ptr<const Key>(host_device_ptr<const Key>(m_keys)),
+                         key);
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns whether key is present. Called on the host outside of
+         ///        loops.
+         ///////////////////////////////////////////////////////////////////////////
+         bool hostContains(const Key& key) const {
+            return hostFindSlot(key) != -1;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Returns the value mapped to key, or notFound if it is not
+         ///        present. Called on the host outside of loops.
+         ///////////////////////////////////////////////////////////////////////////
+         Value hostLookup(const Key& key, const Value notFound) const {
+            const int slot = hostFindSlot(key);
+            return slot == -1 ? notFound : host_ptr<const Value>(host_device_ptr<const Value>(m_values))[slot];
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Frees the underlying storage
+         ///////////////////////////////////////////////////////////////////////////
+         void free() {
+            m_occupied.free();
+            m_keys.free();
+            m_values.free();
+            m_occupied = nullptr;
+            m_keys = nullptr;
+            m_values = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+         }
+
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Builds the table in parallel.
+         /// Each key claims a slot by storing its index with a compare and swap,
+         ///    and a later occurrence of the same key only ever replaces a larger
+         ///    index, so the first occurrence wins regardless of thread order.
+         ///    The winning pairs are then copied into the slots.
+         ///    Public because device lambdas cannot be in private functions.
+         /// @return void
+         ///////////////////////////////////////////////////////////////////////////
+         void build(host_device_ptr<const Key> keys, host_device_ptr<const Value> values, const int n) {
+            const int capacity = capacityFor(n);
+            const unsigned int mask = (unsigned int) (capacity - 1);
+            const bool hasValues = values != nullptr;
+
+            host_device_ptr<int> table{(size_t) capacity, "unordered_map table"};
+            host_device_ptr<bool> occupied{(size_t) capacity, "unordered_map occupied"};
+            host_device_ptr<Key> slotKeys{(size_t) capacity, "unordered_map keys"};
+            host_device_ptr<Value> slotValues{(size_t) capacity, "unordered_map values"};
+
+            LOOP_STREAM(slot, 0, capacity) {
+               table[slot] = -1;
+            } LOOP_STREAM_END
+
+            LOOP_STREAM(i, 0, n) {
+               const Key key = keys[i];
+               unsigned int slot = hashValue(key) & mask;
+
+               while (true) {
+                  int owner = table[slot];
+
+                  if (owner == -1) {
+                     owner = ATOMIC_CAS(table[slot], -1, i);
+
+                     if (owner == -1) {
+                        break;
+                     }
+                  }
+
+                  if (keys[owner] == key) {
+                     while (i < owner) {
+                        const int previous = ATOMIC_CAS(table[slot], owner, i);
+
+                        if (previous == owner) {
+                           break;
+                        }
+
+                        owner = previous;
+                     }
+
+                     break;
+                  }
+
+                  slot = (slot + 1) & mask;
+               }
+            } LOOP_STREAM_END
+
+            RAJAReduceSum<int> size { 0 };
+
+            LOOP_REDUCE(slot, 0, capacity) {
+               const int owner = table[slot];
+               occupied[slot] = owner != -1;
+
+               if (owner != -1) {
+                  slotKeys[slot] = keys[owner];
+                  slotValues[slot] = hasValues ? values[owner] : (Value) owner;
+                  size += 1;
+               }
+            } LOOP_REDUCE_END
+
+            table.free();
+
+            m_size = (int) size;
+            m_capacity = capacity;
+            m_occupied = occupied;
+            m_keys = slotKeys;
+            m_values = slotValues;
+         }
+
+      private:
+         ///////////////////////////////////////////////////////////////////////////
+         /// @brief Linear probing for key in the given views of the table
+         ///////////////////////////////////////////////////////////////////////////
+         template <typename OccupiedView, typename KeyView>
+         CARE_HOST_DEVICE int probe(const OccupiedView& occupied, const KeyView& keys,
+                                    const Key& key) const {
+            if (m_capacity == 0) {
+               return -1;
+            }
+
+            const unsigned int mask = (unsigned int) (m_capacity - 1);
+            unsigned int slot = hashValue(key) & mask;
+
+            while (occupied[slot]) {
+               if (keys[slot] == key) {
+                  return (int) slot;
+               }
+
+               slot = (slot + 1) & mask;
+            }
+
+            return -1;
+         }
+
+         int m_size = 0; //!< The number of distinct keys
+         int m_capacity = 0; //!< The number of slots, a power of two
+         host_device_ptr<bool> m_occupied = nullptr; //!< Whether each slot holds a key
+         host_device_ptr<Key> m_keys = nullptr; //!< The key in each slot
+         host_device_ptr<Value> m_values = nullptr; //!< The value in each slot
+   };
+} // namespace care
+
+#endif // !defined(_CARE_UNORDERED_MAP_H_)
+
@@ -17,6 +17,7 @@
 #endif
 
 // Std library headers
+#include <cstring>
 #include <type_traits>
 
 /// Whether or not to force CUDA device synchronization after every call to forall
@@ -298,6 +299,137 @@ namespace care {
    }
 #endif
 
+   namespace detail {
+      /// The murmur3 64 bit finalizer, so that the low bits (which are used to
+      /// pick a slot) are well mixed
+      CARE_HOST_DEVICE inline unsigned int finalizeHash(unsigned long long hash) {
+         hash ^= hash >> 33;
+         hash *= 0xff51afd7ed558ccdull;
+         hash ^= hash >> 33;
+         hash *= 0xc4ceb9fe1a85ec53ull;
+         hash ^= hash >> 33;
+         return (unsigned int) hash;
+      }
+
+      /// The bits of a double, with -0.0 normalized to +0.0 since they compare equal
+      CARE_HOST_DEVICE inline unsigned long long doubleBits(const double value) {
+         const double normalized = value == 0.0 ? 0.0 : value;
+         unsigned long long bits;
+         memcpy(&bits, &normalized, sizeof(bits));
+         return bits;
+      }
+
+      struct HashInteger {};
+      struct HashFloatingPoint {};
+      struct HashBytes {};
+
+      template <typename T>
+      using HashMethod = typename std::conditional<std::is_integral<T>::value || std::is_enum<T>::value,
+                                                   HashInteger,
+                                                   typename std::conditional<std::is_floating_point<T>::value,
+                                                                             HashFloatingPoint,
+                                                                             HashBytes>::type>::type;
+
+      template <typename T>
+      CARE_HOST_DEVICE inline unsigned int hashValue(const T value, HashInteger) {
+         return finalizeHash((unsigned long long) value);
+      }
+
+      // The value is split into the nearest double and the remainder, which
+      // are exact, so padding (as in long double) is never read
+      template <typename T>
+      CARE_HOST_DEVICE inline unsigned int hashValue(const T value, HashFloatingPoint) {
+         const double high = (double) value;
+         const double low = (double) (value - (T) high);
+         return finalizeHash(doubleBits(high) ^ (doubleBits(low) * 0x9e3779b97f4a7c15ull));
+      }
+
+      // FNV-1a over the bytes
+      template <typename T>
+      CARE_HOST_DEVICE inline unsigned int hashValue(const T & value, HashBytes) {
+#if defined(__cpp_lib_has_unique_object_representations)
+         static_assert(std::has_unique_object_representations<T>::value,
+                       "care::hashValue needs equal values of T to have equal bytes");
+#endif
+
+         const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+         unsigned long long hash = 14695981039346656037ull;
+
+         for (size_t i = 0; i < sizeof(T); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+         }
+
+         return finalizeHash(hash);
+      }
+   } // namespace detail
+
+   /////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Hashes a value for use in open addressing hash tables. Values
+   ///        that compare equal hash the same: integers and enums are hashed
+   ///        by value, and floating point values by value with +0.0 and -0.0
+   ///        normalized, whatever padding their type has. Other types are
+   ///        hashed by their bytes, so they must not have padding or several
+   ///        representations of a value (checked when compiled as C++17).
+   ///
+   /// @arg[in] value The value to hash
+   ///
+   /// @return The hash of the value
+   ///
+   /////////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   CARE_HOST_DEVICE inline unsigned int hashValue(const T value)
+   {
+      return detail::hashValue(value, detail::HashMethod<T>{});
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Counts the set bits of a 64 bit word on the host or device.
+   ///
+   /// @arg[in] word The bits to count
+   ///
+   /// @return The number of set bits
+   ///
+   /////////////////////////////////////////////////////////////////////////////////
+   CARE_HOST_DEVICE inline int popCount(unsigned long long word)
+   {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+      return __popcll(word);
+#elif defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(word);
+#else
+      int count = 0;
+
+      for (; word != 0; word &= word - 1) {
+         ++count;
+      }
+
+      return count;
+#endif
+   }
+
+   /////////////////////////////////////////////////////////////////////////////////
+   ///
+   /// @brief Finds the lowest set bit of a nonzero 64 bit word on the host or device.
+   ///
+   /// @arg[in] word The bits to search. Must not be zero.
+   ///
+   /// @return The index of the lowest set bit
+   ///
+   /////////////////////////////////////////////////////////////////////////////////
+   CARE_HOST_DEVICE inline int countTrailingZeros(unsigned long long word)
+   {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+      return __ffsll((long long) word) - 1;
+#elif defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(word);
+#else
+      return popCount((word & (~word + 1)) - 1);
+#endif
+   }
+
 } // namespace care
 
 #if defined(__GPUCC__) && defined(GPU_ACTIVE) && defined(CARE_DEBUG)
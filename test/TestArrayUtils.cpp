@@ -10,7 +10,10 @@
 #include "care/config.h"
 
 // std library headers
+#include <algorithm>
 #include <array>
+#include <iterator>
+#include <vector>
 
 // other library headers
 #include "gtest/gtest.h"
@@ -130,6 +133,63 @@ TEST(array_utils, binarysearch) {
    EXPECT_EQ(result, -1);
 }
 
+TEST(array_utils, gallopsearch) {
+   int a[7] = {-9, 0, 3, 7, 77, 500, 999};
+   int result = 0;
+
+   // first entry not less than the number
+   result = care_utils::GallopSearch<int>(a, 0, 7, 77);
+   EXPECT_EQ(result, 4);
+
+   result = care_utils::GallopSearch<int>(a, 0, 7, 8);
+   EXPECT_EQ(result, 4);
+
+   result = care_utils::GallopSearch<int>(a, 0, 7, -100);
+   EXPECT_EQ(result, 0);
+
+   // one past the end of the region if everything is smaller
+   result = care_utils::GallopSearch<int>(a, 0, 7, 1000);
+   EXPECT_EQ(result, 7);
+
+   result = care_utils::GallopSearch<int>(a, 2, 7-2, 0);
+   EXPECT_EQ(result, 2);
+
+   result = care_utils::GallopSearch<int>(a, 2, 3, 500);
+   EXPECT_EQ(result, 5);
+}
+
+TEST(array_utils, mergepathsearch) {
+   int a[4] = {1, 3, 5, 7};
+   int b[4] = {2, 3, 4, 8};
+
+   // merged: 1(a) 2(b) 3(a) 3(b) 4(b) 5(a) 7(a) 8(b)
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 0), 0);
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 1), 1);
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 3), 2);
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 4), 2);
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 7), 4);
+   EXPECT_EQ(care_utils::MergePathSearch<int>(a, 0, 4, b, 0, 4, 8), 4);
+
+   // the match of 3 is found by the slice that contains the 3 from a
+   int matches1[1], matches2[1];
+   EXPECT_EQ(care_utils::MergePathIntersect<int>(a, 0, 4, b, 0, 4, 0, 3, matches1, matches2, 0), 1);
+   EXPECT_EQ(matches1[0], 1);
+   EXPECT_EQ(matches2[0], 1);
+   EXPECT_EQ(care_utils::MergePathIntersect<int>(a, 0, 4, b, 0, 4, 3, 8, nullptr, nullptr, 0), 0);
+}
+
+TEST(array_utils, segmentedmergepathsearch) {
+   int offsets[4] = {0, 2, 2, 5};
+
+   // merged: 0 1 end(0) end(1) 2 3 4 end(2)
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 0), 0);
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 2), 0);
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 3), 1);
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 4), 2);
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 5), 2);
+   EXPECT_EQ(care_utils::SegmentedMergePathSearch(offsets, 3, 5, 8), 3);
+}
+
 TEST(array_utils, intersectarrays) {
    int tempa[3] = {1, 2, 5};
    int tempb[5] = {2, 3, 4, 5, 6};
@@ -184,6 +244,823 @@ TEST(array_utils, intersectarrays) {
    EXPECT_EQ(numMatches[0], 0);
 }
 
+TEST(array_utils, setoperations) {
+   int tempa[5] = {1, 2, 5, 8, 9};
+   int tempb[4] = {2, 3, 5, 10};
+   care::host_device_ptr<int> a(tempa, 5, "a");
+   care::host_device_ptr<int> b(tempb, 4, "b");
+
+   care::host_device_ptr<int> result, indices, positions1, positions2;
+   int resultSize = -1;
+
+   care_utils::UnionArrays<int>(RAJA::seq_exec(), a, 5, 0, b, 4, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 7);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(2), 3);
+   EXPECT_EQ(result.pick(6), 10);
+
+   care_utils::DifferenceArrays<int>(RAJA::seq_exec(), a, 5, 0, b, 4, 0, result, indices, &resultSize);
+   EXPECT_EQ(resultSize, 3);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(1), 8);
+   EXPECT_EQ(result.pick(2), 9);
+   EXPECT_EQ(indices.pick(0), 0);
+   EXPECT_EQ(indices.pick(1), 3);
+   EXPECT_EQ(indices.pick(2), 4);
+
+   // indices are given as offsets from start1, as in IntersectArrays
+   care_utils::DifferenceArrays<int>(RAJA::seq_exec(), a, 5, 2, b, 4, 0, result, indices, &resultSize);
+   EXPECT_EQ(resultSize, 2);
+   EXPECT_EQ(indices.pick(0), 1);
+   EXPECT_EQ(indices.pick(1), 2);
+
+   care_utils::SymmetricDifferenceArrays<int>(RAJA::seq_exec(), a, 5, 0, b, 4, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 5);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(1), 3);
+   EXPECT_EQ(result.pick(4), 10);
+
+   // identical arrays have no symmetric difference
+   care_utils::SymmetricDifferenceArrays<int>(RAJA::seq_exec(), a, 5, 0, a, 5, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 0);
+   EXPECT_EQ(result, nullptr);
+
+   care_utils::MergeArrays<int>(RAJA::seq_exec(), a, 5, 0, b, 4, 0, result, true, positions1, positions2, &resultSize);
+   EXPECT_EQ(resultSize, 9);
+   EXPECT_EQ(result.pick(1), 2);
+   EXPECT_EQ(result.pick(2), 2);
+   EXPECT_EQ(result.pick(8), 10);
+   EXPECT_EQ(positions1.pick(1), 1);
+   EXPECT_EQ(positions2.pick(0), 2);
+   EXPECT_EQ(positions2.pick(3), 8);
+}
+
+// Large enough for many merge path slices of 64, so values in both arrays
+// straddle slice boundaries: the match of value 6k takes diagonals 5k and
+// 5k+1, which are split for k = 51, 115, ...
+template <typename Exec>
+static void testSetOperationsPartitioned() {
+   const int len = 1000;
+   std::vector<int> hostEvens(len), hostThrees(len), hostHalves(len), hostThirds(len);
+
+   for (int i = 0; i < len; ++i) {
+      hostEvens[i] = 2*i;
+      hostThrees[i] = 3*i;
+      hostHalves[i] = i/2;
+      hostThirds[i] = i/3;
+   }
+
+   care::host_device_ptr<int> evens(hostEvens.data(), len, "evens");
+   care::host_device_ptr<int> threes(hostThrees.data(), len, "threes");
+   care::host_device_ptr<int> result, indices, positions1, positions2;
+   int resultSize = -1;
+
+   std::vector<int> expected;
+   std::set_union(hostEvens.begin(), hostEvens.end(), hostThrees.begin(), hostThrees.end(), std::back_inserter(expected));
+   care_utils::UnionArrays<int>(Exec(), evens, len, 0, threes, len, 0, result, &resultSize);
+   ASSERT_EQ(resultSize, (int) expected.size());
+
+   for (int i = 0; i < resultSize; ++i) {
+      EXPECT_EQ(result.pick(i), expected[i]);
+   }
+
+   expected.clear();
+   std::set_difference(hostEvens.begin(), hostEvens.end(), hostThrees.begin(), hostThrees.end(), std::back_inserter(expected));
+   care_utils::DifferenceArrays<int>(Exec(), evens, len, 0, threes, len, 0, result, indices, &resultSize);
+   ASSERT_EQ(resultSize, (int) expected.size());
+
+   for (int i = 0; i < resultSize; ++i) {
+      EXPECT_EQ(result.pick(i), expected[i]);
+      EXPECT_EQ(indices.pick(i), expected[i]/2);
+   }
+
+   expected.clear();
+   std::set_symmetric_difference(hostEvens.begin(), hostEvens.end(), hostThrees.begin(), hostThrees.end(), std::back_inserter(expected));
+   care_utils::SymmetricDifferenceArrays<int>(Exec(), evens, len, 0, threes, len, 0, result, &resultSize);
+   ASSERT_EQ(resultSize, (int) expected.size());
+
+   for (int i = 0; i < resultSize; ++i) {
+      EXPECT_EQ(result.pick(i), expected[i]);
+   }
+
+   // runs of duplicates within and across the arrays
+   care::host_device_ptr<int> halves(hostHalves.data(), len, "halves");
+   care::host_device_ptr<int> thirds(hostThirds.data(), len, "thirds");
+
+   expected.clear();
+   std::merge(hostHalves.begin(), hostHalves.end(), hostThirds.begin(), hostThirds.end(), std::back_inserter(expected));
+   care_utils::MergeArrays<int>(Exec(), halves, len, 0, thirds, len, 0, result, true, positions1, positions2, &resultSize);
+   ASSERT_EQ(resultSize, 2*len);
+
+   for (int i = 0; i < resultSize; ++i) {
+      EXPECT_EQ(result.pick(i), expected[i]);
+   }
+
+   // ties are taken from the first array first
+   for (int i = 0; i < len; ++i) {
+      const int position1 = positions1.pick(i);
+      const int position2 = positions2.pick(i);
+      EXPECT_EQ(result.pick(position1), hostHalves[i]);
+      EXPECT_EQ(result.pick(position2), hostThirds[i]);
+      EXPECT_EQ(position1, i + (int) (std::lower_bound(hostThirds.begin(), hostThirds.end(), hostHalves[i]) - hostThirds.begin()));
+      EXPECT_EQ(position2, i + (int) (std::upper_bound(hostHalves.begin(), hostHalves.end(), hostThirds[i]) - hostHalves.begin()));
+   }
+
+   result.free();
+   indices.free();
+   positions1.free();
+   positions2.free();
+}
+
+TEST(array_utils, setoperations_partitioned) {
+   testSetOperationsPartitioned<RAJAExec>();
+   testSetOperationsPartitioned<RAJA::seq_exec>();
+}
+
+template <typename T>
+static void testNthElementTopK(const int length, T (*value)(int))
+{
+  care::host_device_ptr<T> a(length, "selectarr");
+  std::vector<T> sorted(length);
+
+  for (int i = 0; i < length; ++i) {
+    sorted[i] = value(i);
+    a.set(i, sorted[i]);
+  }
+
+  std::sort(sorted.begin(), sorted.end());
+
+  const int ranks[] = {0, 1, length / 3, length / 2, length - 2, length - 1};
+
+  for (int k : ranks) {
+    EXPECT_EQ(care_utils::NthElement<T>(a, length, k), sorted[k]);
+  }
+
+  const int counts[] = {0, 1, 17, length / 2, length};
+
+  for (int k : counts) {
+    care::host_device_ptr<T> values;
+    care::host_device_ptr<int> indices;
+    care_utils::TopK<T>(a, length, k, values, indices);
+
+    std::vector<T> top(k);
+
+    for (int i = 0; i < k; ++i) {
+      top[i] = values.pick(i);
+      EXPECT_EQ(a.pick(indices.pick(i)), top[i]);
+
+      if (i > 0) {
+        EXPECT_LT(indices.pick(i - 1), indices.pick(i));
+      }
+    }
+
+    std::sort(top.begin(), top.end());
+
+    for (int i = 0; i < k; ++i) {
+      EXPECT_EQ(top[i], sorted[length - k + i]);
+    }
+
+    values.free();
+    indices.free();
+  }
+
+  a.free();
+}
+
+static int selectInt(int i) {
+  return (int) ((i * 2654435761ll) % 1000) - 500;
+}
+
+static double selectDouble(int i) {
+  return 0.25 * ((i * 40503ll) % 997) - 100.0;
+}
+
+static long long selectWide(int i) {
+  return (long long) (i * 0x9E3779B97F4A7C15ull);
+}
+
+static unsigned int selectUnsigned(int i) {
+  return 4000000000u - 3u * (unsigned int) (i % 50);
+}
+
+TEST(array_utils, nthelement_topk)
+{
+  // long enough to compact the survivors and to span several histogram chunks
+  testNthElementTopK<int>(20000, selectInt);
+  testNthElementTopK<double>(5000, selectDouble);
+  testNthElementTopK<long long>(10000, selectWide);
+  testNthElementTopK<unsigned int>(300, selectUnsigned);
+}
+
+TEST(array_utils, nthelement_bounds)
+{
+  const int length = 5;
+  care::host_device_ptr<int> a(length, "boundsarr");
+
+  for (int i = 0; i < length; ++i) {
+    a.set(i, 10 * (length - i));
+  }
+
+  // out of range ranks are clamped
+  EXPECT_EQ(care_utils::NthElement<int>(a, length, length), 50);
+  EXPECT_EQ(care_utils::NthElement<int>(a, length, 2 * length), 50);
+  EXPECT_EQ(care_utils::NthElement<int>(a, length, -1), 10);
+  EXPECT_EQ(care_utils::NthElement<int>(a, 0, 0), 0);
+
+  a.free();
+}
+
+// counts how many elements FindFirst tests
+struct CountingEqualTo {
+  int val;
+  care::host_device_ptr<int> evaluations;
+
+  CARE_HOST_DEVICE bool operator()(const int & x) const {
+    ATOMIC_ADD(evaluations[0], 1);
+    return x == val;
+  }
+};
+
+static int findFirstCounted(care::host_device_ptr<int> a, int start, int end, int val, int* evaluations)
+{
+  care::host_device_ptr<int> count(1, "findcount");
+  count.set(0, 0);
+
+  const int result = care_utils::FindFirst<int, CountingEqualTo>(a, start, end, CountingEqualTo{val, count});
+
+  *evaluations = count.pick(0);
+  count.free();
+  return result;
+}
+
+TEST(array_utils, findfirst_chunks)
+{
+  // chunks of 16384, 32768, 65536, 131072 and the 16384 left over
+  const int length = 1 << 18;
+  care::host_device_ptr<int> a(length, "findarr");
+
+  LOOP_STREAM(i, 0, length) {
+    a[i] = i;
+  } LOOP_STREAM_END
+
+  int evaluations = 0;
+
+  // a match in the first chunk stops the search after it
+  EXPECT_EQ(findFirstCounted(a, 0, length, 5, &evaluations), 5);
+  EXPECT_EQ(evaluations, 16384);
+
+  // a match in the fourth chunk stops the search before the last
+  EXPECT_EQ(findFirstCounted(a, 0, length, 120000, &evaluations), 120000);
+  EXPECT_EQ(evaluations, 245760);
+
+  // chunks are counted from start
+  EXPECT_EQ(findFirstCounted(a, 100, length, 16484, &evaluations), 16484);
+  EXPECT_EQ(evaluations, 49152);
+
+  // no match searches every chunk
+  EXPECT_EQ(findFirstCounted(a, 0, length, -1, &evaluations), -1);
+  EXPECT_EQ(evaluations, length);
+
+  EXPECT_EQ(findFirstCounted(a, 0, 0, 0, &evaluations), -1);
+  EXPECT_EQ(evaluations, 0);
+
+  a.free();
+}
+
+// reference for PickAndPerformFind*Index on data without ties
+static int findIndexExtremumReference(const std::vector<int>& arr, const std::vector<int>& mask,
+                                      const std::vector<int>& subset, const std::vector<double>& thresholds,
+                                      int n, bool isMax, int* position) {
+  int best = -1;
+
+  for (int i = 0; i < n; ++i) {
+    const int curr = subset.empty() ? i : subset[i];
+
+    if (!thresholds.empty() && !(thresholds[i] > 0.5)) {
+      continue;
+    }
+
+    if (best == -1 || (isMax ? arr[curr] > arr[subset.empty() ? best : subset[best]]
+                             : arr[curr] < arr[subset.empty() ? best : subset[best]])) {
+      best = i;
+    }
+  }
+
+  *position = best;
+
+  if (best == -1) {
+    return -1;
+  }
+
+  const int index = subset.empty() ? best : subset[best];
+  return !mask.empty() && mask[index] == 1 ? -1 : index;
+}
+
+static void testFindIndexExtremumCombinations()
+{
+  const int length = 1000;
+  const int sublength = 300;
+
+  std::vector<int> hostArr(length), hostMask(length), hostSubset(sublength);
+  std::vector<double> hostThresholds(length);
+
+  for (int i = 0; i < length; ++i) {
+    hostArr[i] = (int) ((i * 7919ll) % 1009); // distinct, so no ties
+    hostMask[i] = (i % 3 == 0);
+    hostThresholds[i] = (i % 5 == 0) ? 0.0 : 1.0;
+  }
+
+  for (int i = 0; i < sublength; ++i) {
+    hostSubset[i] = (i * 37) % length;
+  }
+
+  care::host_device_ptr<int> arr(hostArr.data(), length, "arr");
+  care::host_device_ptr<int> mask(hostMask.data(), length, "mask");
+  care::host_device_ptr<int> subset(hostSubset.data(), sublength, "subset");
+  care::host_device_ptr<double> thresholds(hostThresholds.data(), length, "thresholds");
+
+  for (int combination = 0; combination < 8; ++combination) {
+    const bool useMask = combination & 1;
+    const bool useSubset = combination & 2;
+    const bool useThresholds = combination & 4;
+    const int n = useSubset ? sublength : length;
+
+    const std::vector<int> refMask = useMask ? hostMask : std::vector<int>();
+    const std::vector<int> refSubset = useSubset ? hostSubset : std::vector<int>();
+    const std::vector<double> refThresholds = useThresholds ? hostThresholds : std::vector<double>();
+
+    for (int isMax = 0; isMax < 2; ++isMax) {
+      int expectedPosition = -1;
+      const int expected = findIndexExtremumReference(hostArr, refMask, refSubset, refThresholds,
+                                                      n, isMax, &expectedPosition);
+
+      int thresholdIndex = -2;
+      care::host_device_ptr<int const> maskArg = useMask ? mask : nullptr;
+      care::host_device_ptr<int const> subsetArg = useSubset ? subset : nullptr;
+      care::host_device_ptr<double const> thresholdsArg = useThresholds ? thresholds : nullptr;
+
+      const int result = isMax ?
+        care_utils::PickAndPerformFindMaxIndex<int>(arr, maskArg, subsetArg, n, thresholdsArg, 0.5, &thresholdIndex) :
+        care_utils::PickAndPerformFindMinIndex<int>(arr, maskArg, subsetArg, n, thresholdsArg, 0.5, &thresholdIndex);
+
+      EXPECT_EQ(result, expected) << "combination " << combination << " max " << isMax;
+      EXPECT_EQ(thresholdIndex, useThresholds ? expectedPosition : -2) << "combination " << combination << " max " << isMax;
+    }
+  }
+}
+
+TEST(array_utils, findindexextremum_combinations)
+{
+  testFindIndexExtremumCombinations();
+}
+
+// ties go to the first candidate, and a mask only rejects the winner
+TEST(array_utils, findindexextremum_ties)
+{
+  const int length = 6;
+  const int sublength = 3;
+  int hostArr[length] = {4, 1, 7, 1, 7, 2};
+  int hostMask[length] = {0, 1, 0, 0, 1, 0};
+  int hostSubset[sublength] = {1, 3, 5};
+  double hostThresholds[sublength] = {0.0, 1.0, 1.0};
+
+  care::host_device_ptr<int> arr(hostArr, length, "arr");
+  care::host_device_ptr<int> mask(hostMask, length, "mask");
+  care::host_device_ptr<int> subset(hostSubset, sublength, "subset");
+  care::host_device_ptr<double> thresholds(hostThresholds, sublength, "thresholds");
+
+  int thresholdIndex = -2;
+
+  EXPECT_EQ(care_utils::PickAndPerformFindMinIndex<int>(arr, nullptr, nullptr, length, nullptr, 0.5, &thresholdIndex), 1);
+  EXPECT_EQ(care_utils::PickAndPerformFindMaxIndex<int>(arr, nullptr, nullptr, length, nullptr, 0.5, &thresholdIndex), 2);
+  EXPECT_EQ(thresholdIndex, -2);
+
+  // the minimum is masked off, the maximum is not
+  EXPECT_EQ(care_utils::PickAndPerformFindMinIndex<int>(arr, mask, nullptr, length, nullptr, 0.5, &thresholdIndex), -1);
+  EXPECT_EQ(care_utils::PickAndPerformFindMaxIndex<int>(arr, mask, nullptr, length, nullptr, 0.5, &thresholdIndex), 2);
+
+  EXPECT_EQ(care_utils::FindIndexMinSubset<int>(arr, subset, sublength), 1);
+  EXPECT_EQ(care_utils::FindIndexMaxSubset<int>(arr, subset, sublength), 5);
+  EXPECT_EQ(care_utils::PickAndPerformFindMinIndex<int>(arr, mask, subset, sublength, nullptr, 0.5, &thresholdIndex), -1);
+
+  // the threshold rules out the first position of the subset
+  EXPECT_EQ(care_utils::FindIndexMinSubsetAboveThresholds<int>(arr, subset, sublength, thresholds, 0.5, &thresholdIndex), 3);
+  EXPECT_EQ(thresholdIndex, 1);
+  EXPECT_EQ(care_utils::PickAndPerformFindMinIndex<int>(arr, mask, subset, sublength, thresholds, 0.5, &thresholdIndex), 3);
+  EXPECT_EQ(thresholdIndex, 1);
+  EXPECT_EQ(care_utils::PickAndPerformFindMaxIndex<int>(arr, mask, subset, sublength, thresholds, 0.5, &thresholdIndex), 5);
+  EXPECT_EQ(thresholdIndex, 2);
+}
+
+TEST(array_utils, findindexextremum_empty)
+{
+  const int length = 3;
+  int hostArr[length] = {3, 2, 1};
+  int hostMask[length] = {0, 0, 0};
+  int hostSubset[length] = {0, 1, 2};
+  double hostThresholds[length] = {1.0, 1.0, 1.0};
+
+  care::host_device_ptr<int> arr(hostArr, length, "arr");
+  care::host_device_ptr<int> mask(hostMask, length, "mask");
+  care::host_device_ptr<int> subset(hostSubset, length, "subset");
+  care::host_device_ptr<double> thresholds(hostThresholds, length, "thresholds");
+
+  for (int combination = 0; combination < 8; ++combination) {
+    care::host_device_ptr<int const> maskArg = combination & 1 ? mask : nullptr;
+    care::host_device_ptr<int const> subsetArg = combination & 2 ? subset : nullptr;
+    care::host_device_ptr<double const> thresholdsArg = combination & 4 ? thresholds : nullptr;
+
+    int thresholdIndex = -2;
+    EXPECT_EQ(care_utils::PickAndPerformFindMinIndex<int>(arr, maskArg, subsetArg, 0, thresholdsArg, 0.5, &thresholdIndex), -1) << "combination " << combination;
+    EXPECT_EQ(thresholdIndex, combination & 4 ? -1 : -2) << "combination " << combination;
+
+    thresholdIndex = -2;
+    EXPECT_EQ(care_utils::PickAndPerformFindMaxIndex<int>(arr, maskArg, subsetArg, 0, thresholdsArg, 0.5, &thresholdIndex), -1) << "combination " << combination;
+    EXPECT_EQ(thresholdIndex, combination & 4 ? -1 : -2) << "combination " << combination;
+  }
+
+  // every candidate filtered out
+  int thresholdIndex = -2;
+  EXPECT_EQ(care_utils::FindIndexMinAboveThresholds<int>(arr, length, thresholds, 2.0, &thresholdIndex), -1);
+  EXPECT_EQ(thresholdIndex, -1);
+}
+
+static void testArrayStats()
+{
+  int vals[7] = {4, -2, 7, 4, 9, 0, 4};
+  int maskvals[7] = {1, 0, 1, 1, 0, 1, 1};
+
+  care::host_device_ptr<const int> a(vals, 7, "statsarr");
+  care::host_device_ptr<const int> mask(maskvals, 7, "statsmask");
+
+  care_utils::ArrayStatistics<int> stats = care_utils::ArrayStats<int>(a, 7, care_utils::ARRAY_STAT_ALL, 4);
+  EXPECT_EQ(stats.min, -2);
+  EXPECT_EQ(stats.minLoc, 1);
+  EXPECT_EQ(stats.max, 9);
+  EXPECT_EQ(stats.maxLoc, 4);
+  EXPECT_EQ(stats.sum, 26);
+  EXPECT_EQ(stats.sumOfSquares, 182);
+  EXPECT_EQ(stats.count, 3);
+  EXPECT_EQ(stats.numIncluded, 7);
+
+  // only the requested statistics are filled in
+  stats = care_utils::ArrayStats<int>(a, 7, care_utils::ARRAY_STAT_MAX | care_utils::ARRAY_STAT_SUM);
+  EXPECT_EQ(stats.max, 9);
+  EXPECT_EQ(stats.maxLoc, 4);
+  EXPECT_EQ(stats.sum, 26);
+  EXPECT_EQ(stats.min, std::numeric_limits<int>::max());
+  EXPECT_EQ(stats.minLoc, -1);
+  EXPECT_EQ(stats.sumOfSquares, 0);
+  EXPECT_EQ(stats.count, 0);
+
+  // masked, with a wider reduction type
+  care_utils::ArrayStatistics<int, double> masked = care_utils::ArrayStats<int, double>(a, mask, 7, care_utils::ARRAY_STAT_ALL, 4);
+  EXPECT_EQ(masked.min, 0);
+  EXPECT_EQ(masked.minLoc, 5);
+  EXPECT_EQ(masked.max, 7);
+  EXPECT_EQ(masked.maxLoc, 2);
+  EXPECT_EQ(masked.sum, 19.0);
+  EXPECT_EQ(masked.sumOfSquares, 97.0);
+  EXPECT_EQ(masked.count, 3);
+  EXPECT_EQ(masked.numIncluded, 5);
+
+  // everything masked off
+  int offvals[7] = {0};
+  care::host_device_ptr<const int> offmask(offvals, 7, "statsoffmask");
+  stats = care_utils::ArrayStats<int>(a, offmask, 7, care_utils::ARRAY_STAT_ALL, 4);
+  EXPECT_EQ(stats.numIncluded, 0);
+  EXPECT_EQ(stats.minLoc, -1);
+  EXPECT_EQ(stats.maxLoc, -1);
+  EXPECT_EQ(stats.count, 0);
+
+  // nil test
+  stats = care_utils::ArrayStats<int>(nullptr, 0, care_utils::ARRAY_STAT_ALL);
+  EXPECT_EQ(stats.numIncluded, 0);
+  EXPECT_EQ(stats.minLoc, -1);
+
+  // long enough to be split into many partial results, with ties for the
+  // minimum and maximum in several of them
+  const int length = 100003;
+  care::host_device_ptr<int> b(length, "statslong");
+
+  LOOP_SEQUENTIAL(i, 0, length) {
+    b[i] = (i * 7919) % 1009;
+  } LOOP_SEQUENTIAL_END
+
+  int expectedMin = b.pick(0), expectedMax = b.pick(0);
+  int expectedMinLoc = 0, expectedMaxLoc = 0, expectedCount = 0;
+  long long expectedSum = 0;
+
+  for (int i = 0; i < length; ++i) {
+    const int val = b.pick(i);
+    expectedSum += val;
+    expectedCount += val == 17;
+
+    if (val < expectedMin) {
+      expectedMin = val;
+      expectedMinLoc = i;
+    }
+
+    if (val > expectedMax) {
+      expectedMax = val;
+      expectedMaxLoc = i;
+    }
+  }
+
+  care_utils::ArrayStatistics<int, long long> longStats =
+    care_utils::ArrayStats<int, long long>(b, length, care_utils::ARRAY_STAT_ALL, 17);
+  EXPECT_EQ(longStats.min, expectedMin);
+  EXPECT_EQ(longStats.minLoc, expectedMinLoc);
+  EXPECT_EQ(longStats.max, expectedMax);
+  EXPECT_EQ(longStats.maxLoc, expectedMaxLoc);
+  EXPECT_EQ(longStats.sum, expectedSum);
+  EXPECT_EQ(longStats.count, expectedCount);
+  EXPECT_EQ(longStats.numIncluded, length);
+
+  b.free();
+}
+
+TEST(array_utils, arraystats)
+{
+  testArrayStats();
+}
+
+static void testSegmented()
+{
+  // one long segment so that partitions have to carry partial results
+  const int numSegments = 5;
+  const int length = 203;
+  int offsetvals[numSegments + 1] = {0, 3, 3, 200, 201, 203};
+  care::host_device_ptr<int> offsets(offsetvals, numSegments + 1, "segoffsets");
+  care::host_device_ptr<int> a(length, "segarr");
+
+  LOOP_SEQUENTIAL(i, 0, length) {
+    a[i] = (i * 7) % 11 - 5;
+  } LOOP_SEQUENTIAL_END
+
+  care::host_device_ptr<int> sums(numSegments, "segsums");
+  care::host_device_ptr<int> mins(numSegments, "segmins");
+  care::host_device_ptr<int> maxs(numSegments, "segmaxs");
+  care::host_device_ptr<int> locs(numSegments, "seglocs");
+  care::host_device_ptr<int> scan(length, "segscan");
+
+  care_utils::SegmentedSum<int>(a, offsets, numSegments, sums);
+  care_utils::SegmentedMin<int>(a, offsets, numSegments, 100, mins);
+  care_utils::SegmentedMax<int>(a, offsets, numSegments, -100, maxs);
+  care_utils::SegmentedArgMin<int>(a, offsets, numSegments, locs);
+  care_utils::segmented_exclusive_scan<int>(a, scan, offsets, numSegments);
+
+  for (int s = 0; s < numSegments; ++s) {
+    int sum = 0, min = 100, max = -100, loc = -1;
+    for (int i = offsetvals[s]; i < offsetvals[s + 1]; ++i) {
+      EXPECT_EQ(scan.pick(i), sum);
+      int val = a.pick(i);
+      sum += val;
+      max = val > max ? val : max;
+      if (val < min) {
+        min = val;
+        loc = i;
+      }
+    }
+    EXPECT_EQ(sums.pick(s), sum);
+    EXPECT_EQ(mins.pick(s), min);
+    EXPECT_EQ(maxs.pick(s), max);
+    EXPECT_EQ(locs.pick(s), loc);
+  }
+
+  // empty segment
+  EXPECT_EQ(sums.pick(1), 0);
+  EXPECT_EQ(mins.pick(1), 100);
+  EXPECT_EQ(locs.pick(1), -1);
+
+  a.free();
+  sums.free();
+  mins.free();
+  maxs.free();
+  locs.free();
+  scan.free();
+}
+
+TEST(array_utils, segmented)
+{
+  testSegmented();
+}
+
+template <typename Exec>
+static void testUniqArray()
+{
+  // runs of duplicates that straddle the 64 element flag words
+  const int length = 200;
+  care::host_device_ptr<int> a(length, "uniqarr");
+
+  LOOP_SEQUENTIAL(i, 0, length) {
+    a[i] = i / 3;
+  } LOOP_SEQUENTIAL_END
+
+  const int expectedLength = (length + 2) / 3;
+
+  care::host_device_ptr<int> out;
+  int outLength = -1;
+  care_utils::uniqArray(Exec{}, a, length, out, outLength);
+  ASSERT_EQ(outLength, expectedLength);
+
+  for (int i = 0; i < expectedLength; ++i) {
+    EXPECT_EQ(out.pick(i), i);
+  }
+
+  out.free();
+
+  // in place, keeping the original allocation
+  int newLength = care_utils::uniqArray(Exec{}, a, length);
+  ASSERT_EQ(newLength, expectedLength);
+
+  for (int i = 0; i < expectedLength; ++i) {
+    EXPECT_EQ(a.pick(i), i);
+  }
+
+  // already unique, so nothing moves
+  newLength = care_utils::uniqArray(Exec{}, a, expectedLength, true);
+  ASSERT_EQ(newLength, expectedLength);
+
+  for (int i = 0; i < expectedLength; ++i) {
+    EXPECT_EQ(a.pick(i), i);
+  }
+
+  a.free();
+}
+
+TEST(array_utils, uniqarray)
+{
+  testUniqArray<RAJAExec>();
+  testUniqArray<RAJA::seq_exec>();
+}
+
+template <typename Exec>
+static void testCompressArray()
+{
+  // removals inside, at the edges of, and spanning whole 64 element flag words
+  const int length = 300;
+  const int removedLen = 80;
+  care::host_device_ptr<int> removed(removedLen, "removed");
+
+  LOOP_SEQUENTIAL(i, 0, removedLen) {
+    removed[i] = i < 64 ? 64 + i : 3 * (i - 64) + 200;
+  } LOOP_SEQUENTIAL_END
+
+  care::host_device_ptr<int> a(length, "compressint");
+  care::host_device_ptr<double> b(length, "compressdouble");
+
+  LOOP_SEQUENTIAL(i, 0, length) {
+    a[i] = i;
+    b[i] = 0.5 * i;
+  } LOOP_SEQUENTIAL_END
+
+  care::host_device_ptr<int> c = care_utils::ArrayDup<int>(a, length);
+  care::host_device_ptr<int> d = care_utils::ArrayDup<int>(a, length);
+  care::host_device_ptr<double> e = care_utils::ArrayDup<double>(b, length);
+
+  care_utils::CompressArray(Exec{}, c, length, removed, removedLen);
+  care_utils::CompressArrays(Exec{}, length, removed, removedLen, true, a, b);
+  // copied back into the arrays, through scratch shared by both types
+  care_utils::CompressArrays(Exec{}, length, removed, removedLen, false, d, e);
+
+  const int newLength = length - removedLen;
+  int expected = 0;
+
+  for (int i = 0; i < newLength; ++i, ++expected) {
+    while ((expected >= 64 && expected < 128) ||
+           (expected >= 200 && expected < 248 && expected % 3 == 2)) {
+      ++expected;
+    }
+
+    EXPECT_EQ(a.pick(i), expected);
+    EXPECT_EQ(b.pick(i), 0.5 * expected);
+    EXPECT_EQ(c.pick(i), expected);
+    EXPECT_EQ(d.pick(i), expected);
+    EXPECT_EQ(e.pick(i), 0.5 * expected);
+  }
+
+  a.free();
+  b.free();
+  c.free();
+  d.free();
+  e.free();
+  removed.free();
+}
+
+TEST(array_utils, compressarray)
+{
+  testCompressArray<RAJAExec>();
+  testCompressArray<RAJA::seq_exec>();
+}
+
+template <typename Exec>
+static void testExpandArrays()
+{
+  // every other slot past the first 100, so later writes overlap earlier reads
+  const int length = 200;
+  const int capacity = 300;
+  care::host_device_ptr<int> indexSet(length, "indexSet");
+  care::host_device_ptr<int> a(capacity, "expandint");
+  care::host_device_ptr<double> b(capacity, "expanddouble");
+
+  LOOP_SEQUENTIAL(i, 0, capacity) {
+    if (i < length) {
+      indexSet[i] = i < 100 ? i : 2 * i - 100;
+    }
+
+    a[i] = i < length ? i : -1;
+    b[i] = i < length ? 0.5 * i : -1.0;
+  } LOOP_SEQUENTIAL_END
+
+  care::host_device_ptr<int> c = care_utils::ArrayDup<int>(a, capacity);
+
+  care_utils::ExpandArrayInPlace(Exec{}, c, indexSet, length);
+  care_utils::ExpandArrays(Exec{}, indexSet, length, a, b);
+
+  for (int i = 0; i < length; ++i) {
+    const int idx = indexSet.pick(i);
+    EXPECT_EQ(a.pick(idx), i);
+    EXPECT_EQ(b.pick(idx), 0.5 * i);
+    EXPECT_EQ(c.pick(idx), i);
+  }
+
+  // slots not in indexSet past the original length are untouched
+  EXPECT_EQ(a.pick(capacity - 1), -1);
+  EXPECT_EQ(b.pick(capacity - 1), -1.0);
+
+  indexSet.free();
+  a.free();
+  b.free();
+  c.free();
+}
+
+TEST(array_utils, expandarrays)
+{
+  testExpandArrays<RAJAExec>();
+  testExpandArrays<RAJA::seq_exec>();
+}
+
+static void testBitsetMask()
+{
+  // mask whole words, partial words, and a ragged tail
+  const int length = 300;
+  care::host_device_ptr<int> a(length, "bitsetarr");
+  care::host_device_ptr<int> mask(length, "bitsetmask");
+  care::host_device_ptr<int> subset(length / 2, "bitsetsubset");
+
+  LOOP_SEQUENTIAL(i, 0, length) {
+    a[i] = (i * 37) % 101 - 50;
+    mask[i] = (i >= 64 && i < 128) || i % 5 == 0;
+
+    if (i < length / 2) {
+      subset[i] = 2 * i;
+    }
+  } LOOP_SEQUENTIAL_END
+
+  care::bitset bits(mask, length, "bits");
+
+  double minInt, maxInt, minBits, maxBits;
+  int resultInt = care_utils::ArrayMinMax<int>(a, mask, length, &minInt, &maxInt);
+  int resultBits = care_utils::ArrayMinMax<int>(a, bits, length, &minBits, &maxBits);
+  EXPECT_EQ(resultBits, resultInt);
+  EXPECT_EQ(minBits, minInt);
+  EXPECT_EQ(maxBits, maxInt);
+
+  EXPECT_EQ((care_utils::ArrayMaskedSum<int>(a, bits, length, 0)),
+            (care_utils::ArrayMaskedSum<int>(a, mask, length, 0)));
+  EXPECT_EQ((care_utils::ArrayMaskedSum<int>(a, bits, 100, 0)),
+            (care_utils::ArrayMaskedSum<int>(a, mask, 100, 0)));
+  EXPECT_EQ((care_utils::PickAndPerformSum<int>(a, bits, subset, length / 2)),
+            (care_utils::PickAndPerformSum<int>(a, mask, subset, length / 2)));
+  EXPECT_EQ((care_utils::PickAndPerformSum<int>(a, bits, nullptr, length)),
+            (care_utils::PickAndPerformSum<int>(a, mask, nullptr, length)));
+
+  // nothing included
+  care::bitset all(length, "all");
+  LOOP_SEQUENTIAL(w, 0, all.numWords()) {
+    all.setWord(w, ~0ull);
+  } LOOP_SEQUENTIAL_END
+
+  EXPECT_EQ(care_utils::ArrayMaskedSum<int>(a, all, length, 0), 0);
+
+  care::bitset none(length, "none");
+  EXPECT_EQ(care_utils::ArrayMinMax<int>(a, none, length, &minBits, &maxBits), 0);
+  EXPECT_EQ(minBits, -DBL_MAX);
+
+  all.free();
+  none.free();
+  bits.free();
+  subset.free();
+  mask.free();
+  a.free();
+}
+
+TEST(array_utils, bitsetmask)
+{
+  testBitsetMask();
+}
+
 #if defined(__GPUCC__)
 
 // Adapted from CHAI
@@ -1086,6 +1963,77 @@ GPU_TEST(array_utils, findindexmax)
   EXPECT_EQ(result, -1);
 }
 
+GPU_TEST(array_utils, arraystats)
+{
+  testArrayStats();
+}
+
+GPU_TEST(array_utils, segmented)
+{
+  testSegmented();
+}
+
+GPU_TEST(array_utils, uniqarray)
+{
+  testUniqArray<RAJAExec>();
+  testUniqArray<RAJA::seq_exec>();
+}
+
+GPU_TEST(array_utils, compressarray)
+{
+  testCompressArray<RAJAExec>();
+  testCompressArray<RAJA::seq_exec>();
+}
+
+GPU_TEST(array_utils, expandarrays)
+{
+  testExpandArrays<RAJAExec>();
+  testExpandArrays<RAJA::seq_exec>();
+}
+
+GPU_TEST(array_utils, bitsetmask)
+{
+  testBitsetMask();
+}
+
+GPU_TEST(array_utils, nthelement_topk)
+{
+  // long enough to compact the survivors and to span several histogram chunks
+  testNthElementTopK<int>(20000, selectInt);
+  testNthElementTopK<double>(5000, selectDouble);
+  testNthElementTopK<long long>(10000, selectWide);
+  testNthElementTopK<unsigned int>(300, selectUnsigned);
+}
+
+GPU_TEST(array_utils, findfirst_chunks)
+{
+  // long enough for several chunks, with matches in the first, a later, and no chunk
+  const int length = 100000;
+  care::host_device_ptr<int> a(length, "findarr");
+
+  LOOP_STREAM(i, 0, length) {
+    a[i] = i % 50000;
+  } LOOP_STREAM_END
+
+  EXPECT_EQ(care_utils::ArrayFind<int>(a, length, 7, 0), 7);
+  EXPECT_EQ(care_utils::ArrayFind<int>(a, length, 7, 8), 50007);
+  EXPECT_EQ(care_utils::ArrayFind<int>(a, length, 49999, 0), 49999);
+  EXPECT_EQ(care_utils::ArrayFind<int>(a, length, -1, 0), -1);
+  EXPECT_EQ(care_utils::ArrayFind<int>(a, 50000, 7, 8), -1);
+
+  EXPECT_EQ(care_utils::FindIndexGT<int>(a, length, 40000), 40001);
+  EXPECT_EQ(care_utils::FindIndexGT<int>(a, length, 49999), -1);
+
+  EXPECT_EQ((care_utils::FindFirst<int, care_utils::GreaterThanValue<int>>(a, 60000, length, care_utils::GreaterThanValue<int>{20000})), 70001);
+
+  a.free();
+}
+
+GPU_TEST(array_utils, findindexextremum_combinations)
+{
+  testFindIndexExtremumCombinations();
+}
+
 // duplicating and copying arrays
 // NOTE: no test for when to and from are the same array or aliased. I'm assuming that is not allowed.
 GPU_TEST(array_utils, dup_and_copy) {
@@ -1214,5 +2162,101 @@ GPU_TEST(array_utils, intersectarrays) {
    EXPECT_EQ(numMatches[0], 0);
 }
 
+GPU_TEST(array_utils, intersectarrays_partitioned) {
+   const int len = 1000;
+   care::host_device_ptr<int> evens(len, "evens");
+   care::host_device_ptr<int> threes(len, "threes");
+
+   LOOP_STREAM(i, 0, len) {
+      evens[i] = 2*i;
+      threes[i] = 3*i;
+   } LOOP_STREAM_END
+
+   care::host_device_ptr<int> matches1, matches2;
+   int numMatches[1] = {0};
+
+   // similar sizes, so the matches are split across many merge path slices
+   care_utils::IntersectArrays<int>(RAJAExec(), evens, len, 0, threes, len, 0, matches1, matches2, numMatches);
+   EXPECT_EQ(numMatches[0], 334);
+
+   LOOP_SEQUENTIAL(i, 0, numMatches[0]) {
+      EXPECT_EQ(matches1[i], 3*i);
+      EXPECT_EQ(matches2[i], 2*i);
+   } LOOP_SEQUENTIAL_END
+
+   // very different sizes, so the larger array is searched by galloping
+   int tempa[3] = {10, 1000, 1998};
+   care::host_device_ptr<int> a(tempa, 3, "a");
+
+   care_utils::IntersectArrays<int>(RAJAExec(), evens, len, 0, a, 3, 0, matches1, matches2, numMatches);
+   EXPECT_EQ(numMatches[0], 3);
+   EXPECT_EQ(matches1.pick(0), 5);
+   EXPECT_EQ(matches1.pick(1), 500);
+   EXPECT_EQ(matches1.pick(2), 999);
+   EXPECT_EQ(matches2.pick(0), 0);
+   EXPECT_EQ(matches2.pick(1), 1);
+   EXPECT_EQ(matches2.pick(2), 2);
+
+   evens.free();
+   threes.free();
+   matches1.free();
+   matches2.free();
+}
+
+GPU_TEST(array_utils, setoperations_partitioned) {
+   testSetOperationsPartitioned<RAJAExec>();
+}
+
+GPU_TEST(array_utils, setoperations) {
+   int tempa[5] = {1, 2, 5, 8, 9};
+   int tempb[4] = {2, 3, 5, 10};
+   care::host_device_ptr<int> a(tempa, 5, "a");
+   care::host_device_ptr<int> b(tempb, 4, "b");
+
+   care::host_device_ptr<int> result, indices, positions1, positions2;
+   int resultSize = -1;
+
+   care_utils::UnionArrays<int>(RAJAExec(), a, 5, 0, b, 4, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 7);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(2), 3);
+   EXPECT_EQ(result.pick(6), 10);
+
+   care_utils::DifferenceArrays<int>(RAJAExec(), a, 5, 0, b, 4, 0, result, indices, &resultSize);
+   EXPECT_EQ(resultSize, 3);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(1), 8);
+   EXPECT_EQ(result.pick(2), 9);
+   EXPECT_EQ(indices.pick(0), 0);
+   EXPECT_EQ(indices.pick(1), 3);
+   EXPECT_EQ(indices.pick(2), 4);
+
+   // indices are given as offsets from start1, as in IntersectArrays
+   care_utils::DifferenceArrays<int>(RAJAExec(), a, 5, 2, b, 4, 0, result, indices, &resultSize);
+   EXPECT_EQ(resultSize, 2);
+   EXPECT_EQ(indices.pick(0), 1);
+   EXPECT_EQ(indices.pick(1), 2);
+
+   care_utils::SymmetricDifferenceArrays<int>(RAJAExec(), a, 5, 0, b, 4, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 5);
+   EXPECT_EQ(result.pick(0), 1);
+   EXPECT_EQ(result.pick(1), 3);
+   EXPECT_EQ(result.pick(4), 10);
+
+   // identical arrays have no symmetric difference
+   care_utils::SymmetricDifferenceArrays<int>(RAJAExec(), a, 5, 0, a, 5, 0, result, &resultSize);
+   EXPECT_EQ(resultSize, 0);
+   EXPECT_EQ(result, nullptr);
+
+   care_utils::MergeArrays<int>(RAJAExec(), a, 5, 0, b, 4, 0, result, true, positions1, positions2, &resultSize);
+   EXPECT_EQ(resultSize, 9);
+   EXPECT_EQ(result.pick(1), 2);
+   EXPECT_EQ(result.pick(2), 2);
+   EXPECT_EQ(result.pick(8), 10);
+   EXPECT_EQ(positions1.pick(1), 1);
+   EXPECT_EQ(positions2.pick(0), 2);
+   EXPECT_EQ(positions2.pick(3), 8);
+}
+
 #endif // __GPUCC__
 
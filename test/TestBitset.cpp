@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#define GPU_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/bitset.h"
+
+TEST(bitset, set_reset_count)
+{
+   const int size = 130;
+   care::bitset bits(size, "bits");
+
+   EXPECT_EQ(bits.size(), size);
+   EXPECT_EQ(bits.numWords(), 3);
+   EXPECT_EQ(bits.count(), 0);
+
+   bits.set(0);
+   bits.set(63);
+   bits.set(64);
+   bits.set(129);
+   EXPECT_EQ(bits.count(), 4);
+   EXPECT_TRUE(bits.test(63));
+   EXPECT_FALSE(bits.test(62));
+
+   bits.reset(63);
+   EXPECT_FALSE(bits.test(63));
+   EXPECT_EQ(bits.count(), 3);
+
+   // bits past the end are dropped
+   bits.setWord(2, ~0ull);
+   EXPECT_EQ(bits.word(2), 3ull);
+   EXPECT_EQ(bits.count(), 4);
+
+   bits.free();
+   EXPECT_FALSE(bits);
+}
+
+TEST(bitset, from_mask)
+{
+   const int size = 200;
+   care::host_device_ptr<int> mask(size, "mask");
+
+   LOOP_SEQUENTIAL(i, 0, size) {
+      mask[i] = i % 3 == 0 ? 7 : 0;
+   } LOOP_SEQUENTIAL_END
+
+   care::bitset bits(mask, size, "bits");
+
+   EXPECT_EQ(bits.count(), (size + 2) / 3);
+
+   for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(bits.test(i), i % 3 == 0);
+   }
+
+   bits.free();
+   mask.free();
+}
+
+#if defined(__GPUCC__)
+
+// Adapted from CHAI
+#define GPU_TEST(X, Y) \
+   static void gpu_test_##X##Y(); \
+   TEST(X, gpu_test_##Y) { gpu_test_##X##Y(); } \
+   static void gpu_test_##X##Y()
+
+GPU_TEST(bitset, from_mask)
+{
+   const int size = 200;
+   care::host_device_ptr<int> mask(size, "mask");
+
+   LOOP_STREAM(i, 0, size) {
+      mask[i] = i % 3 == 0 ? 7 : 0;
+   } LOOP_STREAM_END
+
+   care::bitset bits(mask, size, "bits");
+
+   EXPECT_EQ(bits.count(), (size + 2) / 3);
+
+   RAJAReduceMin<bool> passed{true};
+
+   LOOP_REDUCE(i, 0, size) {
+      if (bits.test(i) != (i % 3 == 0)) {
+         passed.min(false);
+      }
+   } LOOP_REDUCE_END
+
+   ASSERT_TRUE((bool) passed);
+
+   bits.free();
+   mask.free();
+}
+
+#endif // __GPUCC__
+
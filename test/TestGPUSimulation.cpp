@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/care.h"
+#include "care/GPUSimulation.h"
+
+// std library headers
+#include <atomic>
+#include <vector>
+
+TEST(GPUSimulation, visitsEachIndexOnce)
+{
+   const int start = 7;
+   const int end = 7 + 10 * care::gpuSimulationBlockSize + 13;
+   std::vector<std::atomic<int>> visits(end);
+
+   for (std::atomic<int> & visit : visits) {
+      visit.store(0);
+   }
+
+   std::atomic<int> * counts = visits.data();
+
+   care::simulate_gpu_kernel(start, end, [=] (const int i) {
+      counts[i].fetch_add(1);
+   });
+
+   for (int i = 0; i < end; ++i) {
+      EXPECT_EQ(visits[i].load(), i < start ? 0 : 1);
+   }
+}
+
+TEST(GPUSimulation, launchCoordinates)
+{
+   const int start = 3;
+   const int end = 3 + 4 * care::gpuSimulationBlockSize + 100;
+   const int numBlocks = 5;
+   std::vector<int> globalIndex(end, -1);
+   std::vector<int> gridDim(end, -1);
+   int * global = globalIndex.data();
+   int * grid = gridDim.data();
+
+   care::simulate_gpu_kernel(start, end, [=] (const int i) {
+      const care::SimulatedGPUThread & thread = care::simulatedGPUThread();
+      global[i] = thread.blockDim.x * thread.blockIdx.x + thread.threadIdx.x;
+      grid[i] = thread.gridDim.x;
+   });
+
+   for (int i = start; i < end; ++i) {
+      EXPECT_EQ(globalIndex[i], i - start);
+      EXPECT_EQ(gridDim[i], numBlocks);
+   }
+
+   // Outside a simulated kernel the coordinates are zero
+   EXPECT_EQ(care::simulatedGPUThread().blockDim.x, 0u);
+   EXPECT_EQ(care::simulatedGPUThread().gridDim.x, 0u);
+}
+
+TEST(GPUSimulation, emptyRange)
+{
+   int calls = 0;
+   int * callsPtr = &calls;
+
+   care::simulate_gpu_kernel(5, 5, [=] (const int) { ++*callsPtr; });
+   care::simulate_gpu_kernel(5, 2, [=] (const int) { ++*callsPtr; });
+
+   EXPECT_EQ(calls, 0);
+}
+
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+
+// Each thread reduces into its own copy of the body, so the reducers combine
+// correctly however the blocks are divided between the threads
+TEST(GPUSimulation, reductions)
+{
+   const int start = 0;
+   const int end = 37 * care::gpuSimulationBlockSize + 5;
+
+   RAJAReduceSum<int> sum(0);
+   RAJAReduceMin<int> minimum(end);
+   RAJAReduceMax<int> maximum(-1);
+
+   care::forall(care::gpu_simulation{}, __FILE__, __LINE__, start, end, [=] (const int i) {
+      sum += i % 7;
+      minimum.min(i);
+      maximum.max(i);
+   });
+
+   int expected = 0;
+
+   for (int i = start; i < end; ++i) {
+      expected += i % 7;
+   }
+
+   EXPECT_EQ((int) sum, expected);
+   EXPECT_EQ((int) minimum, start);
+   EXPECT_EQ((int) maximum, end - 1);
+}
+
+#endif // CARE_ENABLE_GPU_SIMULATION_MODE
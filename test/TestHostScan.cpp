@@ -0,0 +1,388 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of the parallel host scans, so the loops run on the OpenMP threads
+// rather than the device
+#define OPENMP_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/care.h"
+#include "care/ChainedScan.h"
+#include "care/scan.h"
+#include "care/ScanWorkspace.h"
+
+// std library headers
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+// Uses several threads for the scope of a test, even on a machine with one core
+class HostScanThreads {
+   public:
+      explicit HostScanThreads(const int numThreads) {
+#if defined(_OPENMP)
+         m_num_threads = omp_get_max_threads();
+         omp_set_num_threads(numThreads);
+#else
+         (void) numThreads;
+#endif
+      }
+
+      ~HostScanThreads() {
+#if defined(_OPENMP)
+         omp_set_num_threads(m_num_threads);
+#endif
+      }
+
+   private:
+      int m_num_threads = 1;
+};
+
+// Many chunks per thread, and a partial last chunk, so chunks look back over
+// both published aggregates and published prefixes
+static const int hostScanLength = 37 * care::chainedScanChunkSize + 123;
+
+TEST(HostScan, chainedScan)
+{
+   for (int numThreads : {1, 2, 4, 16}) {
+      HostScanThreads threads(numThreads);
+
+      std::vector<int> prefixes(hostScanLength, -1);
+      int * rawPrefixes = prefixes.data();
+
+      const int total = care::chained_scan<int>(__FILE__, __LINE__, 0, hostScanLength, 7,
+                                                [=] (const int i) { return i % 5; },
+                                                [] (const int a, const int b) { return a + b; },
+                                                [=] (const int i, const int prefix, const int) { rawPrefixes[i] = prefix; });
+
+      int expected = 7;
+
+      for (int i = 0; i < hostScanLength; ++i) {
+         ASSERT_EQ(prefixes[i], expected) << "index " << i << " with " << numThreads << " threads";
+         expected += i % 5;
+      }
+
+      EXPECT_EQ(total, expected);
+   }
+}
+
+// The operation is associative but not commutative, so chunks combined in the
+// wrong order give the wrong answer
+TEST(HostScan, chainedScanNotCommutative)
+{
+   HostScanThreads threads(4);
+
+   // Keeps the last value that is not zero
+   auto last = [] (const int a, const int b) { return b != 0 ? b : a; };
+   std::vector<int> prefixes(hostScanLength, -1);
+   int * rawPrefixes = prefixes.data();
+
+   care::chained_scan<int>(__FILE__, __LINE__, 0, hostScanLength, -2,
+                           [=] (const int i) { return i % 1000 == 0 ? i : 0; },
+                           last,
+                           [=] (const int i, const int prefix, const int) { rawPrefixes[i] = prefix; });
+
+   int expected = -2;
+
+   for (int i = 0; i < hostScanLength; ++i) {
+      ASSERT_EQ(prefixes[i], expected) << "index " << i;
+      expected = last(expected, i % 1000 == 0 ? i : 0);
+   }
+}
+
+TEST(HostScan, exclusiveAndInclusiveScan)
+{
+   HostScanThreads threads(4);
+
+   chai::ManagedArray<int> data(hostScanLength);
+   chai::ManagedArray<int> exclusive(hostScanLength);
+   chai::ManagedArray<int> inclusive(hostScanLength);
+
+   LOOP_SEQUENTIAL(i, 0, hostScanLength) {
+      data[i] = i % 3 + 1;
+   } LOOP_SEQUENTIAL_END
+
+   exclusive_scan<int, RAJA::omp_parallel_for_exec>(data, exclusive, hostScanLength, RAJA::operators::plus<int>{}, 5, false);
+   inclusive_scan<int, RAJA::omp_parallel_for_exec>(data, inclusive, hostScanLength, RAJA::operators::plus<int>{}, false);
+
+   int running = 0;
+
+   for (int i = 0; i < hostScanLength; ++i) {
+      ASSERT_EQ(exclusive.pick(i), running + 5) << "index " << i;
+      running += data.pick(i);
+      ASSERT_EQ(inclusive.pick(i), running) << "index " << i;
+   }
+
+   // In place
+   exclusive_scan<int, RAJA::omp_parallel_for_exec>(data, nullptr, hostScanLength, RAJA::operators::plus<int>{}, 0, true);
+   EXPECT_EQ(data.pick(0), 0);
+   EXPECT_EQ(data.pick(hostScanLength - 1), inclusive.pick(hostScanLength - 2));
+
+   data.free();
+   exclusive.free();
+   inclusive.free();
+}
+
+// The scan loop macros, which this file sees in their OpenMP form
+TEST(HostScan, scanLoops)
+{
+   for (int numThreads : {1, 4}) {
+      HostScanThreads threads(numThreads);
+
+      const int start = 7;
+      const int end = start + hostScanLength;
+      const int numMatches = (end + 2) / 3 - (start + 2) / 3;
+
+      std::vector<int> compacted(hostScanLength, -1);
+      std::vector<int> everywhere(hostScanLength, -1);
+      std::vector<std::int64_t> wide(hostScanLength, -1);
+      int * rawCompacted = compacted.data();
+      int * rawEverywhere = everywhere.data();
+      std::int64_t * rawWide = wide.data();
+
+      int offset = 3;
+
+      SCAN_LOOP(i, start, end, pos, offset, i % 3 == 0) {
+         rawCompacted[pos - 3] = i;
+      } SCAN_LOOP_END(hostScanLength, pos, offset)
+
+      EXPECT_EQ(offset, 3 + numMatches);
+
+      offset = 3;
+
+      SCAN_EVERYWHERE_LOOP(i, start, end, pos, offset, i % 3 == 0) {
+         rawEverywhere[i - start] = pos;
+      } SCAN_EVERYWHERE_LOOP_END(hostScanLength, pos, offset)
+
+      EXPECT_EQ(offset, 3 + numMatches);
+
+      std::int64_t wideOffset = 3000000000LL;
+
+      SCAN_LOOP_64(i, start, end, pos, wideOffset, i % 3 == 0) {
+         rawWide[pos - 3000000000LL] = i;
+      } SCAN_LOOP_64_END(hostScanLength, pos, wideOffset)
+
+      EXPECT_EQ(wideOffset, 3000000000LL + numMatches);
+
+      int expected = 3;
+
+      for (int i = start; i < end; ++i) {
+         ASSERT_EQ(everywhere[i - start], expected) << "index " << i << " with " << numThreads << " threads";
+
+         if (i % 3 == 0) {
+            ASSERT_EQ(compacted[expected - 3], i) << "with " << numThreads << " threads";
+            ASSERT_EQ(wide[expected - 3], i) << "with " << numThreads << " threads";
+            ++expected;
+         }
+      }
+
+      std::vector<int> categories(hostScanLength, -1);
+      int * rawCategories = categories.data();
+      care::CategoryCounts<2> offsets = {{0, hostScanLength / 2}};
+
+      // every third index is in no category
+      SCAN_PARTITION_LOOP(i, 0, hostScanLength, 2, category, pos, offsets, i % 3 == 2 ? -1 : i % 3) {
+         rawCategories[pos] = i;
+      } SCAN_PARTITION_LOOP_END(hostScanLength, pos, offsets)
+
+      EXPECT_EQ(offsets[0], (hostScanLength + 2) / 3);
+      EXPECT_EQ(offsets[1], hostScanLength / 2 + (hostScanLength + 1) / 3);
+
+      for (int i = 0; i < offsets[0]; ++i) {
+         ASSERT_EQ(categories[i], 3 * i) << "with " << numThreads << " threads";
+      }
+
+      for (int i = hostScanLength / 2; i < offsets[1]; ++i) {
+         ASSERT_EQ(categories[i], 3 * (i - hostScanLength / 2) + 1) << "with " << numThreads << " threads";
+      }
+   }
+}
+
+// The 64 bit scan loops over a range that starts past 2^32, so neither the
+// indices nor the positions fit in an int
+TEST(HostScan, scanLoops64)
+{
+   for (int numThreads : {1, 4}) {
+      HostScanThreads threads(numThreads);
+
+      const std::int64_t start = (std::int64_t(1) << 32) + 7;
+      const std::int64_t end = start + hostScanLength;
+      const std::int64_t numMatches = (end + 2) / 3 - (start + 2) / 3;
+
+      std::vector<std::int64_t> compacted(hostScanLength, -1);
+      std::vector<std::int64_t> everywhere(hostScanLength, -1);
+      std::int64_t * rawCompacted = compacted.data();
+      std::int64_t * rawEverywhere = everywhere.data();
+
+      std::int64_t offset = start;
+
+      SCAN_LOOP_64(i, start, end, pos, offset, i % 3 == 0) {
+         rawCompacted[pos - start] = i;
+      } SCAN_LOOP_64_END(end, pos, offset)
+
+      EXPECT_EQ(offset, start + numMatches);
+
+      offset = start;
+
+      SCAN_EVERYWHERE_LOOP_64(i, start, end, pos, offset, i % 3 == 0) {
+         rawEverywhere[i - start] = pos;
+      } SCAN_EVERYWHERE_LOOP_64_END(end, pos, offset)
+
+      EXPECT_EQ(offset, start + numMatches);
+
+      std::int64_t expected = start;
+
+      for (std::int64_t i = start; i < end; ++i) {
+         ASSERT_EQ(everywhere[i - start], expected) << "index " << i << " with " << numThreads << " threads";
+
+         if (i % 3 == 0) {
+            ASSERT_EQ(compacted[expected - start], i) << "with " << numThreads << " threads";
+            ++expected;
+         }
+      }
+   }
+}
+
+// The scan loops only use the OpenMP threads in their OpenMP form
+#if defined(_OPENMP) && CARE_ENABLE_PARALLEL_HOST_SCAN && !defined(CARE_LEGACY_COMPATIBILITY_MODE) && !defined(CARE_ALWAYS_USE_RAJA_SCAN)
+
+// Ranges of more than one chunk are scanned on the OpenMP threads, and a
+// single chunk is scanned without starting a parallel region. GPU simulation
+// mode runs the host policies sequentially, care::openmp included, and only
+// runs simulated GPU kernels on the OpenMP threads, so there no scan loop body
+// runs in a parallel region.
+TEST(HostScan, scanLoopThreads)
+{
+   HostScanThreads threads(4);
+
+   for (int length : {care::chainedScanChunkSize, hostScanLength}) {
+      std::atomic<int> numInParallel(0);
+      std::atomic<int> * const inParallel = &numInParallel;
+      int count = 0;
+
+      SCAN_LOOP(i, 0, length, pos, count, true) {
+         if (omp_in_parallel()) {
+            inParallel->fetch_add(1, std::memory_order_relaxed);
+         }
+      } SCAN_LOOP_END(length, pos, count)
+
+      EXPECT_EQ(count, length);
+
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+      EXPECT_EQ(numInParallel.load(), 0) << "length " << length;
+#else
+      EXPECT_EQ(numInParallel.load(), length == hostScanLength ? length : 0) << "length " << length;
+#endif
+   }
+}
+
+#endif // defined(_OPENMP) && CARE_ENABLE_PARALLEL_HOST_SCAN && !defined(CARE_LEGACY_COMPATIBILITY_MODE) && !defined(CARE_ALWAYS_USE_RAJA_SCAN)
+
+// A scratch buffer is handed out again once it is given back, and not while
+// it is held
+TEST(HostScan, scratchWorkspace)
+{
+   care::ScratchWorkspace& workspace = care::ScratchWorkspace::get(chai::CPU);
+
+   chai::ManagedArray<char> first = workspace.acquire(1000);
+   chai::ManagedArray<char> second = workspace.acquire(10);
+   EXPECT_TRUE(first != second);
+
+   workspace.release(first);
+   chai::ManagedArray<char> third = workspace.acquire(500);
+   EXPECT_TRUE(third == first);
+
+   workspace.release(second);
+   workspace.release(third);
+   care::release_scan_workspaces();
+}
+
+// Counts the times the registry frees and deletes it
+class CountingWorkspaceSet : public care::detail::WorkspaceSet {
+   public:
+      CountingWorkspaceSet(std::atomic<int>* released, std::atomic<int>* deleted)
+         : m_released(released), m_deleted(deleted) {}
+
+      ~CountingWorkspaceSet() { m_deleted->fetch_add(1); }
+
+      void release() override { m_released->fetch_add(1); }
+
+   private:
+      std::atomic<int>* m_released;
+      std::atomic<int>* m_deleted;
+};
+
+// The workspaces of every thread are freed, not just those of the calling
+// thread, and those of threads that have exited are deleted
+TEST(HostScan, releaseScanWorkspaces)
+{
+   care::detail::WorkspaceRegistry& registry = care::detail::WorkspaceRegistry::getInstance();
+   std::atomic<int> released(0);
+   std::atomic<int> deleted(0);
+   std::vector<CountingWorkspaceSet*> liveSets;
+   std::vector<std::thread> threads;
+
+   for (int t = 0; t < 4; ++t) {
+      CountingWorkspaceSet* set = new CountingWorkspaceSet(&released, &deleted);
+
+      if (t % 2 == 0) {
+         liveSets.push_back(set);
+      }
+
+      threads.emplace_back([&registry, set, t] {
+         registry.add(set);
+
+         if (t % 2 == 1) {
+            registry.orphan(set);
+         }
+
+         // Workspaces of a thread that exits are kept until they are released
+         care::ScanWorkspace<int>& workspace = care::ScanWorkspace<int>::get(chai::CPU);
+         workspace.releaseScanArray(workspace.scanArray(100));
+      });
+   }
+
+   for (std::thread& thread : threads) {
+      thread.join();
+   }
+
+   care::release_scan_workspaces();
+
+   EXPECT_EQ(released.load(), 4);
+   EXPECT_EQ(deleted.load(), 2);
+
+   care::release_scan_workspaces();
+
+   EXPECT_EQ(released.load(), 6);
+   EXPECT_EQ(deleted.load(), 2);
+
+   // Scans after the release allocate new workspaces
+   int count = 0;
+
+   SCAN_LOOP(i, 0, hostScanLength, pos, count, i % 3 == 0) {
+   } SCAN_LOOP_END(hostScanLength, pos, count)
+
+   EXPECT_EQ(count, (hostScanLength + 2) / 3);
+
+   for (CountingWorkspaceSet* set : liveSets) {
+      registry.orphan(set);
+   }
+
+   care::release_scan_workspaces();
+
+   EXPECT_EQ(deleted.load(), 4);
+}
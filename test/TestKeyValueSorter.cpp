@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#define GPU_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// std library headers
+#include <cstring>
+
+// care headers
+#include "care/care.h"
+#include "care/KeyValueSorter.h"
+
+template <typename Exec>
+static void testEliminateDuplicates(care::DuplicateElimination method, bool sortFirst)
+{
+   const int len = 8;
+   int data[len] = {5, 3, 5, 1, 3, 7, 1, 5};
+   care::host_device_ptr<int> arr(data, len, "arr");
+
+   care::KeyValueSorter<int, Exec> sorter(len, arr);
+
+   if (sortFirst) {
+      sorter.sort();
+   }
+
+   sorter.eliminateDuplicates(method);
+
+   ASSERT_EQ(sorter.len(), 4);
+
+   const size_t expectedKeys[4] = {0, 1, 3, 5};
+   const int expectedValues[4] = {5, 3, 1, 7};
+
+   care::host_device_ptr<size_t> keys = sorter.keys();
+   care::host_device_ptr<int> values = sorter.values();
+
+   for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(keys.pick(i), expectedKeys[i]);
+      EXPECT_EQ(values.pick(i), expectedValues[i]);
+   }
+}
+
+TEST(KeyValueSorter, eliminateDuplicates_sort)
+{
+   testEliminateDuplicates<RAJA::seq_exec>(care::DuplicateElimination::SORT, false);
+   testEliminateDuplicates<RAJA::seq_exec>(care::DuplicateElimination::SORT, true);
+}
+
+TEST(KeyValueSorter, eliminateDuplicates_hash)
+{
+   testEliminateDuplicates<RAJA::seq_exec>(care::DuplicateElimination::HASH, false);
+   testEliminateDuplicates<RAJA::seq_exec>(care::DuplicateElimination::HASH, true);
+   testEliminateDuplicates<RAJA::seq_exec>(care::DuplicateElimination::AUTOMATIC, false);
+}
+
+TEST(KeyValueSorter, eliminateDuplicates_hash_signed_zero)
+{
+   double data[4] = {0.0, -0.0, 1.5, 0.0};
+   care::host_device_ptr<double> arr(data, 4, "arr");
+
+   care::KeyValueSorter<double, RAJA::seq_exec> sorter(4, arr);
+   sorter.eliminateDuplicates(care::DuplicateElimination::HASH);
+
+   ASSERT_EQ(sorter.len(), 2);
+   EXPECT_EQ(sorter.keys().pick(0), 0);
+   EXPECT_EQ(sorter.keys().pick(1), 2);
+}
+
+// Equal values hash the same whatever their padding bytes hold
+TEST(KeyValueSorter, hashValue_padding)
+{
+   long double a;
+   long double b;
+   memset(&a, 0xff, sizeof(a));
+   memset(&b, 0x00, sizeof(b));
+   a = 1.5L;
+   b = 1.5L;
+
+   EXPECT_EQ(care::hashValue(a), care::hashValue(b));
+   EXPECT_EQ(care::hashValue(0.0L), care::hashValue(-0.0L));
+   EXPECT_EQ(care::hashValue(0.0f), care::hashValue(-0.0f));
+   EXPECT_NE(care::hashValue(1.0L), care::hashValue(1.0L + 1.0e-18L));
+
+   long double data[4] = {a, -0.0L, 2.5L, b};
+   care::host_device_ptr<long double> arr(data, 4, "arr");
+
+   care::KeyValueSorter<long double, RAJA::seq_exec> sorter(4, arr);
+   sorter.eliminateDuplicates(care::DuplicateElimination::AUTOMATIC);
+
+   ASSERT_EQ(sorter.len(), 3);
+   EXPECT_EQ(sorter.keys().pick(0), 0);
+   EXPECT_EQ(sorter.keys().pick(1), 1);
+   EXPECT_EQ(sorter.keys().pick(2), 2);
+}
+
+#if defined(__GPUCC__)
+
+// Adapted from CHAI
+#define GPU_TEST(X, Y) \
+   static void gpu_test_##X##Y(); \
+   TEST(X, gpu_test_##Y) { gpu_test_##X##Y(); } \
+   static void gpu_test_##X##Y()
+
+GPU_TEST(KeyValueSorter, eliminateDuplicates_sort)
+{
+   testEliminateDuplicates<RAJADeviceExec>(care::DuplicateElimination::SORT, false);
+   testEliminateDuplicates<RAJADeviceExec>(care::DuplicateElimination::SORT, true);
+}
+
+GPU_TEST(KeyValueSorter, eliminateDuplicates_hash)
+{
+   testEliminateDuplicates<RAJADeviceExec>(care::DuplicateElimination::HASH, false);
+   testEliminateDuplicates<RAJADeviceExec>(care::DuplicateElimination::HASH, true);
+   testEliminateDuplicates<RAJADeviceExec>(care::DuplicateElimination::AUTOMATIC, false);
+}
+
+#endif // __GPUCC__
+
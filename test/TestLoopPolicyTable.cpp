@@ -0,0 +1,264 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// Run parallel loops through the adaptive policy on the OpenMP threads
+#define OPENMP_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/care.h"
+#include "care/LoopPolicyTable.h"
+
+// std library headers
+#include <cstdio>
+#include <string>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+static int maxThreads()
+{
+#if defined(_OPENMP)
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+// Uses several threads for the scope of a test, even on a machine with one core
+class LoopPolicyThreads {
+   public:
+      explicit LoopPolicyThreads(const int numThreads) {
+#if defined(_OPENMP)
+         m_num_threads = omp_get_max_threads();
+         omp_set_num_threads(numThreads);
+#else
+         (void) numThreads;
+#endif
+      }
+
+      ~LoopPolicyThreads() {
+#if defined(_OPENMP)
+         omp_set_num_threads(m_num_threads);
+#endif
+      }
+
+   private:
+      int m_num_threads = 1;
+};
+
+// The first launches of a call site alternate between sequential and parallel
+// runs, and a threshold is calibrated once enough of each have been timed
+TEST(LoopPolicyTable, calibrates)
+{
+   care::LoopPolicyTable::clear();
+   const char * fileName = "calibrates.cpp";
+
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold(fileName, 1), -1);
+
+   if (maxThreads() < 2) {
+      // Nothing to choose between
+      EXPECT_FALSE(care::LoopPolicyTable::runInParallel(fileName, 1, 1000));
+      return;
+   }
+
+   for (int sample = 0; sample < care::LoopPolicyTable::calibrationSamples; ++sample) {
+      EXPECT_FALSE(care::LoopPolicyTable::runInParallel(fileName, 1, 1000));
+      care::LoopPolicyTable::record(fileName, 1, 1000, false, 1.0e-6);
+
+      EXPECT_TRUE(care::LoopPolicyTable::runInParallel(fileName, 1, 1000));
+      care::LoopPolicyTable::record(fileName, 1, 1000, true, 1.0e-5);
+   }
+
+   // 1 ns per index sequentially and about 10 us to start the threads
+   const int threshold = care::LoopPolicyTable::getThreshold(fileName, 1);
+   EXPECT_GT(threshold, 1000);
+   EXPECT_LE(threshold, care::LoopPolicyTable::maxCalibrationLength);
+
+   EXPECT_FALSE(care::LoopPolicyTable::runInParallel(fileName, 1, threshold - 1));
+   EXPECT_TRUE(care::LoopPolicyTable::runInParallel(fileName, 1, threshold));
+}
+
+TEST(LoopPolicyTable, fixedThreshold)
+{
+   care::LoopPolicyTable::clear();
+   const char * fileName = "fixedThreshold.cpp";
+
+   care::LoopPolicyTable::setThreshold(fileName, 2, 100);
+   care::LoopPolicyTable::record(fileName, 2, 1000, false, 1.0);
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold(fileName, 2), 100);
+
+   if (maxThreads() >= 2) {
+      EXPECT_FALSE(care::LoopPolicyTable::runInParallel(fileName, 2, 99));
+      EXPECT_TRUE(care::LoopPolicyTable::runInParallel(fileName, 2, 100));
+   }
+}
+
+TEST(LoopPolicyTable, saveAndLoad)
+{
+   care::LoopPolicyTable::clear();
+   const std::string path = "TestLoopPolicyTable.thresholds";
+
+   care::LoopPolicyTable::setThreshold("first file.cpp", 3, 123);
+   care::LoopPolicyTable::setThreshold("second.cpp", 4, 4567);
+   ASSERT_TRUE(care::LoopPolicyTable::save(path));
+
+   care::LoopPolicyTable::clear();
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("first file.cpp", 3), -1);
+
+   care::LoopPolicyTable::clear();
+   ASSERT_TRUE(care::LoopPolicyTable::load(path));
+   std::remove(path.c_str());
+
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("first file.cpp", 3), 123);
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("second.cpp", 4), 4567);
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("second.cpp", 5), -1);
+
+   EXPECT_FALSE(care::LoopPolicyTable::load("does/not/exist"));
+}
+
+// A malformed line fails the load, and none of the file is applied
+TEST(LoopPolicyTable, loadMalformed)
+{
+   care::LoopPolicyTable::clear();
+   const std::string path = "TestLoopPolicyTable.malformed";
+
+   FILE * file = std::fopen(path.c_str(), "w");
+   ASSERT_NE(file, nullptr);
+   std::fprintf(file, "123 3 first.cpp\n\nnot a threshold\n456 4 second.cpp\n");
+   std::fclose(file);
+
+   EXPECT_FALSE(care::LoopPolicyTable::load(path));
+   std::remove(path.c_str());
+
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("first.cpp", 3), -1);
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold("second.cpp", 4), -1);
+}
+
+TEST(LoopPolicyTable, disabled)
+{
+   care::LoopPolicyTable::clear();
+   care::LoopPolicyTable::setEnabled(false);
+
+   EXPECT_FALSE(care::LoopPolicyTable::isEnabled());
+   EXPECT_TRUE(care::LoopPolicyTable::runInParallel("disabled.cpp", 5, 10));
+
+   care::LoopPolicyTable::setEnabled(true);
+   EXPECT_TRUE(care::LoopPolicyTable::isEnabled());
+}
+
+// Launches of every length give the same result, whichever way they run
+TEST(LoopPolicyTable, parallelLoops)
+{
+   care::LoopPolicyTable::clear();
+
+   for (int length = 0; length < 2000; length += 37) {
+      chai::ManagedArray<int> values(length);
+
+      LOOP_STREAM(i, 0, length) {
+         values[i] = i;
+      } LOOP_STREAM_END
+
+      RAJAReduceSum<int> sum(0);
+
+      LOOP_STREAM(i, 0, length) {
+         sum += values[i];
+      } LOOP_STREAM_END
+
+      EXPECT_EQ((int) sum, length * (length - 1) / 2);
+      values.free();
+   }
+}
+
+#if defined(_OPENMP) && CARE_ENABLE_ADAPTIVE_LOOP_POLICY
+
+// Always launched from the same lambda, so the call site is cached after the
+// first launch. Records whether each index ran in a parallel region.
+static void launch(const char * fileName, const int lineNumber, const int length,
+                   care::host_device_ptr<int> inParallel)
+{
+   care::forall(care::parallel{}, fileName, lineNumber, 0, length, [=] (const int i) {
+      inParallel[i] = omp_in_parallel();
+   });
+}
+
+static int countInParallel(care::host_device_ptr<int> inParallel, const int length)
+{
+   int count = 0;
+
+   for (int i = 0; i < length; ++i) {
+      count += inParallel.pick(i);
+   }
+
+   return count;
+}
+
+// Launches shorter than the threshold run inline, and later changes to the
+// threshold reach a call site that has already been cached
+TEST(LoopPolicyTable, adaptiveForall)
+{
+   care::LoopPolicyTable::clear();
+   LoopPolicyThreads threads(4);
+   const char * fileName = "adaptiveForall.cpp";
+   care::host_device_ptr<int> inParallel(1000, "inParallel");
+
+   care::LoopPolicyTable::setThreshold(fileName, 6, 100);
+
+   launch(fileName, 6, 99, inParallel);
+   EXPECT_EQ(countInParallel(inParallel, 99), 0);
+
+   launch(fileName, 6, 100, inParallel);
+
+#if CARE_ENABLE_GPU_SIMULATION_MODE
+   // GPU simulation mode runs the host policies sequentially, care::openmp
+   // included, and only runs simulated GPU kernels on the OpenMP threads. So
+   // the launch picks the OpenMP policy but runs outside a parallel region.
+   EXPECT_EQ(countInParallel(inParallel, 100), 0);
+#else
+   EXPECT_EQ(countInParallel(inParallel, 100), 100);
+#endif
+
+   care::LoopPolicyTable::setThreshold(fileName, 6, 1000);
+
+   launch(fileName, 6, 100, inParallel);
+   EXPECT_EQ(countInParallel(inParallel, 100), 0);
+
+   // A different call site from the same lambda is not confused with the
+   // cached one
+   launch(fileName, 7, 100, inParallel);
+   EXPECT_EQ(care::LoopPolicyTable::getThreshold(fileName, 7), -1);
+   EXPECT_EQ(countInParallel(inParallel, 100), 0);
+
+   inParallel.free();
+}
+
+// Launches are timed until the call site is calibrated
+TEST(LoopPolicyTable, adaptiveForallCalibrates)
+{
+   care::LoopPolicyTable::clear();
+   LoopPolicyThreads threads(4);
+   const char * fileName = "adaptiveForallCalibrates.cpp";
+   care::host_device_ptr<int> inParallel(1000, "inParallel");
+
+   for (int sample = 0; sample < 2 * care::LoopPolicyTable::calibrationSamples; ++sample) {
+      EXPECT_EQ(care::LoopPolicyTable::getThreshold(fileName, 8), -1);
+      launch(fileName, 8, 1000, inParallel);
+   }
+
+   const int threshold = care::LoopPolicyTable::getThreshold(fileName, 8);
+   EXPECT_GE(threshold, 1);
+   EXPECT_LE(threshold, care::LoopPolicyTable::maxCalibrationLength);
+
+   inParallel.free();
+}
+
+#endif // _OPENMP && CARE_ENABLE_ADAPTIVE_LOOP_POLICY
@@ -0,0 +1,214 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/array_utils.h"
+#include "care/care.h"
+#include "care/RAJAPlugin.h"
+
+// std library headers
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string readProfile()
+{
+   FILE * file = std::tmpfile();
+   care::RAJAPlugin::writeLoopProfile(file);
+   std::rewind(file);
+
+   std::string contents;
+   char buffer[1024];
+
+   while (std::fgets(buffer, sizeof(buffer), file)) {
+      contents += buffer;
+   }
+
+   std::fclose(file);
+   return contents;
+}
+
+TEST(LoopProfile, countsCallsAndIterations)
+{
+   care::RAJAPlugin::clearLoopProfile();
+   care::RAJAPlugin::enableLoopProfiling(false);
+   EXPECT_TRUE(care::RAJAPlugin::loopProfilingIsEnabled());
+
+   chai::ManagedArray<int> values(100);
+   const int line = __LINE__ + 3;
+
+   for (int call = 0; call < 3; ++call) {
+      LOOP_SEQUENTIAL(i, 0, 100) {
+         values[i] = i;
+      } LOOP_SEQUENTIAL_END
+   }
+
+   care::RAJAPlugin::disableLoopProfiling();
+   EXPECT_FALSE(care::RAJAPlugin::loopProfilingIsEnabled());
+
+   // Not profiled
+   LOOP_SEQUENTIAL(i, 0, 100) {
+      values[i] = 0;
+   } LOOP_SEQUENTIAL_END
+
+   values.free();
+
+   const std::string profile = readProfile();
+   const std::string site = std::string(__FILE__) + ":" + std::to_string(line);
+
+   EXPECT_NE(profile.find("(1 call sites"), std::string::npos) << profile;
+
+   const size_t siteLine = profile.rfind('\n', profile.find(site));
+   ASSERT_NE(siteLine, std::string::npos) << profile;
+
+   double totalSeconds = -1.0;
+   double percent = 0.0;
+   long long calls = 0;
+   double meanMicroseconds = 0.0;
+   double minMicroseconds = 0.0;
+   double maxMicroseconds = 0.0;
+   long long iterations = 0;
+
+   ASSERT_EQ(std::sscanf(profile.c_str() + siteLine + 1, "[CARE] %lf %lf %lld %lf %lf %lf %lld",
+                         &totalSeconds, &percent, &calls, &meanMicroseconds,
+                         &minMicroseconds, &maxMicroseconds, &iterations), 7) << profile;
+
+   EXPECT_GE(totalSeconds, 0.0);
+   EXPECT_EQ(calls, 3);
+   EXPECT_EQ(iterations, 300);
+   EXPECT_LE(minMicroseconds, meanMicroseconds);
+   EXPECT_LE(meanMicroseconds, maxMicroseconds);
+}
+
+TEST(LoopProfile, clear)
+{
+   care::RAJAPlugin::enableLoopProfiling(false);
+
+   LOOP_SEQUENTIAL(i, 0, 10) {
+      (void) i;
+   } LOOP_SEQUENTIAL_END
+
+   care::RAJAPlugin::disableLoopProfiling();
+   care::RAJAPlugin::clearLoopProfile();
+
+   EXPECT_NE(readProfile().find("(0 call sites"), std::string::npos);
+}
+
+// The array_utils reductions are profiled whether or not they run as host
+// SIMD kernels
+TEST(LoopProfile, arrayUtils)
+{
+   care::RAJAPlugin::clearLoopProfile();
+   care::host_device_ptr<int> values(100, "values");
+   care_utils::ArrayFill<int>(values, 100, 2);
+
+   care::RAJAPlugin::enableLoopProfiling(false);
+   const int sum = care_utils::ArraySum<int>(values, 100, 0);
+   const int max = care_utils::ArrayMax<int>(values, 100, 0);
+   care::RAJAPlugin::disableLoopProfiling();
+
+   values.free();
+
+   EXPECT_EQ(sum, 200);
+   EXPECT_EQ(max, 2);
+
+   const std::string profile = readProfile();
+   EXPECT_NE(profile.find("(2 call sites"), std::string::npos) << profile;
+   EXPECT_NE(profile.find("array_utils.h:"), std::string::npos) << profile;
+}
+
+// Loops launched from several threads at once are all counted
+TEST(LoopProfile, multipleThreads)
+{
+   care::RAJAPlugin::clearLoopProfile();
+   care::RAJAPlugin::enableLoopProfiling(false);
+
+   const int numThreads = 4;
+   const int callsPerThread = 1000;
+   const int line = __LINE__ + 6;
+   std::vector<std::thread> threads;
+
+   for (int thread = 0; thread < numThreads; ++thread) {
+      threads.emplace_back([=] () {
+         for (int call = 0; call < callsPerThread; ++call) {
+            care::forall(care::sequential{}, __FILE__, __LINE__, 0, 10, [=] (const int i) {
+               (void) i;
+            });
+         }
+      });
+   }
+
+   for (std::thread & thread : threads) {
+      thread.join();
+   }
+
+   care::RAJAPlugin::disableLoopProfiling();
+
+   const std::string profile = readProfile();
+   const std::string site = std::string(__FILE__) + ":" + std::to_string(line);
+
+   EXPECT_NE(profile.find("(1 call sites"), std::string::npos) << profile;
+
+   const size_t siteLine = profile.rfind('\n', profile.find(site));
+   ASSERT_NE(siteLine, std::string::npos) << profile;
+
+   double totalSeconds = -1.0;
+   double percent = 0.0;
+   long long calls = 0;
+   double meanMicroseconds = 0.0;
+   double minMicroseconds = 0.0;
+   double maxMicroseconds = 0.0;
+   long long iterations = 0;
+
+   ASSERT_EQ(std::sscanf(profile.c_str() + siteLine + 1, "[CARE] %lf %lf %lld %lf %lf %lf %lld",
+                         &totalSeconds, &percent, &calls, &meanMicroseconds,
+                         &minMicroseconds, &maxMicroseconds, &iterations), 7) << profile;
+
+   EXPECT_EQ(calls, numThreads * callsPerThread);
+   EXPECT_EQ(iterations, 10LL * numThreads * callsPerThread);
+
+   care::RAJAPlugin::clearLoopProfile();
+}
+
+// A loop is profiled if profiling was enabled when it started, even if
+// profiling is turned off or on by a loop inside it
+TEST(LoopProfile, toggledInsideLoop)
+{
+   care::RAJAPlugin::clearLoopProfile();
+   care::RAJAPlugin::enableLoopProfiling(false);
+
+   const int outerLine = __LINE__ + 1;
+   care::forall(care::sequential{}, __FILE__, __LINE__, 0, 1, [=] (const int) {
+      care::RAJAPlugin::disableLoopProfiling();
+
+      care::forall(care::sequential{}, __FILE__, __LINE__, 0, 1, [=] (const int) {
+         care::RAJAPlugin::enableLoopProfiling(false);
+      });
+   });
+
+   care::RAJAPlugin::disableLoopProfiling();
+
+   care::forall(care::sequential{}, __FILE__, __LINE__, 0, 1, [=] (const int) {
+      care::RAJAPlugin::enableLoopProfiling(false);
+   });
+
+   care::RAJAPlugin::disableLoopProfiling();
+
+   const std::string profile = readProfile();
+   const std::string site = std::string(__FILE__) + ":" + std::to_string(outerLine);
+
+   EXPECT_NE(profile.find("(1 call sites"), std::string::npos) << profile;
+   EXPECT_NE(profile.find(site), std::string::npos) << profile;
+
+   care::RAJAPlugin::clearLoopProfile();
+}
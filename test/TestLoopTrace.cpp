@@ -0,0 +1,256 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/care.h"
+#include "care/array_utils.h"
+#include "care/LoopTrace.h"
+#include "care/scan.h"
+
+// std library headers
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string readFile(const std::string & path)
+{
+   std::string contents;
+   FILE * file = std::fopen(path.c_str(), "r");
+
+   if (file) {
+      char buffer[1024];
+
+      while (std::fgets(buffer, sizeof(buffer), file)) {
+         contents += buffer;
+      }
+
+      std::fclose(file);
+   }
+
+   return contents;
+}
+
+static int countOccurrences(const std::string & text, const std::string & pattern)
+{
+   int count = 0;
+
+   for (size_t position = text.find(pattern); position != std::string::npos;
+        position = text.find(pattern, position + pattern.size())) {
+      ++count;
+   }
+
+   return count;
+}
+
+TEST(LoopTrace, writesEvents)
+{
+   const std::string path = "TestLoopTrace.writesEvents.json";
+   ASSERT_TRUE(care::LoopTrace::start(path));
+   EXPECT_TRUE(care::LoopTrace::isEnabled());
+
+   const int length = 100;
+   care::host_device_ptr<int> values(length);
+
+   LOOP_SEQUENTIAL(i, 0, length) {
+      values[i] = length - i;
+   } LOOP_SEQUENTIAL_END
+
+   const int sortLine = __LINE__ + 1;
+   care_utils::sortArray(RAJA::seq_exec{}, values, length);
+   const int scanLine = __LINE__ + 1;
+   exclusive_scan<int, RAJA::seq_exec>(values, nullptr, length, RAJA::operators::plus<int>{}, 0, true);
+
+   care::LoopTrace::stop();
+   EXPECT_FALSE(care::LoopTrace::isEnabled());
+   values.free();
+
+   const std::string trace = readFile(path);
+   std::remove(path.c_str());
+
+   EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u) << trace;
+   EXPECT_NE(trace.find("\"droppedEvents\":0}}"), std::string::npos) << trace;
+
+   EXPECT_NE(trace.find("{\"name\":\"" + std::string(__FILE__) + ":"), std::string::npos) << trace;
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"forall\",\"ph\":\"X\""), 1) << trace;
+   EXPECT_NE(trace.find("\"args\":{\"space\":\"CPU\",\"length\":100}"), std::string::npos) << trace;
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"sort\""), 1) << trace;
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"scan\""), 1) << trace;
+
+   // Sorts and scans are named by the line that called them
+   const std::string prefix = "{\"name\":\"" + std::string(__FILE__) + ":";
+   EXPECT_NE(trace.find(prefix + std::to_string(sortLine) + "\",\"cat\":\"sort\""), std::string::npos) << trace;
+   EXPECT_NE(trace.find(prefix + std::to_string(scanLine) + "\",\"cat\":\"scan\""), std::string::npos) << trace;
+   EXPECT_EQ(countOccurrences(trace, "\"name\":\"thread_name\""), 1) << trace;
+}
+
+// Events that do not fit in a full buffer are dropped and counted
+TEST(LoopTrace, dropsEventsWhenFull)
+{
+   const std::string path = "TestLoopTrace.dropsEventsWhenFull.json";
+   ASSERT_TRUE(care::LoopTrace::start(path, 4));
+
+   const int numLoops = 1000;
+   int count = 0;
+   int * countPtr = &count;
+
+   for (int loop = 0; loop < numLoops; ++loop) {
+      LOOP_SEQUENTIAL(i, 0, 1) {
+         ++*countPtr;
+      } LOOP_SEQUENTIAL_END
+   }
+
+   care::LoopTrace::stop();
+
+   const std::string trace = readFile(path);
+   std::remove(path.c_str());
+
+   EXPECT_EQ(count, numLoops);
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"forall\"") + care::LoopTrace::droppedEvents(), numLoops);
+}
+
+// Each thread records into its own buffer and is written as its own track
+TEST(LoopTrace, multipleThreads)
+{
+   const std::string path = "TestLoopTrace.multipleThreads.json";
+   ASSERT_TRUE(care::LoopTrace::start(path));
+
+   const int numThreads = 4;
+   const int eventsPerThread = 100;
+   std::vector<std::thread> threads;
+
+   for (int thread = 0; thread < numThreads; ++thread) {
+      threads.emplace_back([=] () {
+         for (int event = 0; event < eventsPerThread; ++event) {
+            care::LoopTraceScope trace("forall", CARE_CALLER, chai::CPU, thread);
+         }
+      });
+   }
+
+   for (std::thread & thread : threads) {
+      thread.join();
+   }
+
+   care::LoopTrace::stop();
+
+   const std::string trace = readFile(path);
+   std::remove(path.c_str());
+
+   EXPECT_EQ(care::LoopTrace::droppedEvents(), 0);
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"forall\""), numThreads * eventsPerThread) << trace;
+
+   // The thread that started the trace has a buffer as well
+   EXPECT_EQ(countOccurrences(trace, "\"name\":\"thread_name\""), numThreads + 1) << trace;
+
+   for (int thread = 0; thread < numThreads; ++thread) {
+      EXPECT_EQ(countOccurrences(trace, "\"args\":{\"space\":\"CPU\",\"length\":" + std::to_string(thread) + "}"),
+                eventsPerThread) << trace;
+   }
+
+   for (int tid = 1; tid <= numThreads; ++tid) {
+      EXPECT_EQ(countOccurrences(trace, "\"tid\":" + std::to_string(tid) + ",\"args\":{\"space\""),
+                eventsPerThread) << trace;
+   }
+}
+
+// Threads keep recording while the trace is restarted and stopped, so they
+// hold buffers of earlier traces and record after the last drain. Every
+// event of the last trace is either written or counted as dropped.
+TEST(LoopTrace, stopWhileRecording)
+{
+   const std::string path = "TestLoopTrace.stopWhileRecording.json";
+   const int numThreads = 4;
+   const int eventsPerThread = 20000;
+   std::atomic<bool> recording(true);
+   std::atomic<int> numRecorded(0);
+   std::vector<std::thread> threads;
+
+   ASSERT_TRUE(care::LoopTrace::start(path));
+
+   for (int thread = 0; thread < numThreads; ++thread) {
+      threads.emplace_back([&] () {
+         while (recording.load()) {
+            const care::LoopTrace::Clock::time_point now = care::LoopTrace::Clock::now();
+            care::LoopTrace::record("restart", __FILE__, __LINE__, chai::CPU, 1, now, now);
+         }
+      });
+   }
+
+   for (int restart = 0; restart < 20; ++restart) {
+      ASSERT_TRUE(care::LoopTrace::start(path));
+      std::this_thread::yield();
+   }
+
+   recording.store(false);
+
+   for (std::thread & thread : threads) {
+      thread.join();
+   }
+
+   threads.clear();
+   ASSERT_TRUE(care::LoopTrace::start(path));
+
+   for (int thread = 0; thread < numThreads; ++thread) {
+      threads.emplace_back([&] () {
+         for (int event = 0; event < eventsPerThread; ++event) {
+            const care::LoopTrace::Clock::time_point now = care::LoopTrace::Clock::now();
+            care::LoopTrace::record("late", __FILE__, __LINE__, chai::CPU, 1, now, now);
+            numRecorded.fetch_add(1);
+         }
+      });
+   }
+
+   while (numRecorded.load() < numThreads * eventsPerThread / 2) {
+      std::this_thread::yield();
+   }
+
+   care::LoopTrace::stop();
+
+   for (std::thread & thread : threads) {
+      thread.join();
+   }
+
+   const std::string trace = readFile(path);
+   std::remove(path.c_str());
+
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"late\"") + care::LoopTrace::droppedEvents(),
+             numThreads * eventsPerThread);
+}
+
+// A loop that was traced when it started but ends after the trace stopped is
+// counted as dropped
+TEST(LoopTrace, stoppedInsideLoop)
+{
+   const std::string path = "TestLoopTrace.stoppedInsideLoop.json";
+   ASSERT_TRUE(care::LoopTrace::start(path));
+
+   care::forall(care::sequential{}, __FILE__, __LINE__, 0, 1, [=] (const int) {
+      care::LoopTrace::stop();
+   });
+
+   const std::string trace = readFile(path);
+   std::remove(path.c_str());
+
+   EXPECT_EQ(countOccurrences(trace, "\"cat\":\"forall\""), 0) << trace;
+   EXPECT_EQ(care::LoopTrace::droppedEvents(), 1);
+}
+
+TEST(LoopTrace, disabled)
+{
+   EXPECT_FALSE(care::LoopTrace::isEnabled());
+   EXPECT_FALSE(care::LoopTrace::start("does/not/exist/trace.json"));
+   EXPECT_FALSE(care::LoopTrace::isEnabled());
+
+   // Nothing to write
+   care::LoopTrace::stop();
+}
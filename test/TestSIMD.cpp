@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/simd.h"
+
+// std library headers
+#include <vector>
+
+// Compares every kernel against a plain loop at every instruction set the cpu
+// supports, for lengths that exercise both the vector body and the tail.
+template <typename T>
+static void testKernels()
+{
+   const int lengths[] = {0, 1, 7, 16, 33, 100, 1000};
+   const care::simd::Level maxLevel = care::simd::getMaxLevel();
+
+   for (int level = 0; level <= static_cast<int>(maxLevel); ++level) {
+      care::simd::setLevel(static_cast<care::simd::Level>(level));
+
+      for (int n : lengths) {
+         std::vector<T> data(n);
+
+         for (int i = 0; i < n; ++i) {
+            data[i] = T((i * 37) % 23) - T(11);
+         }
+
+         T min = T(100), max = T(-100), sum = T(3);
+         int count = 0;
+
+         for (int i = 0; i < n; ++i) {
+            min = data[i] < min ? data[i] : min;
+            max = data[i] > max ? data[i] : max;
+            sum += data[i];
+            count += data[i] == T(2);
+         }
+
+         EXPECT_EQ(care::simd::reduceMin(RAJA::seq_exec{}, data.data(), n, T(100)), min);
+         EXPECT_EQ(care::simd::reduceMax(RAJA::seq_exec{}, data.data(), n, T(-100)), max);
+         EXPECT_EQ(care::simd::reduceSum(RAJA::seq_exec{}, data.data(), n, T(3)), sum);
+         EXPECT_EQ(care::simd::count(RAJA::seq_exec{}, data.data(), n, T(2)), count);
+
+         care::simd::fill(RAJA::seq_exec{}, data.data(), n, T(5));
+
+         for (int i = 0; i < n; ++i) {
+            EXPECT_EQ(data[i], T(5));
+         }
+      }
+   }
+
+   care::simd::setLevel(maxLevel);
+}
+
+TEST(simd, int)
+{
+   testKernels<int>();
+}
+
+TEST(simd, float)
+{
+   testKernels<float>();
+}
+
+TEST(simd, double)
+{
+   testKernels<double>();
+}
+
+TEST(simd, mixed_sum)
+{
+   std::vector<int> data(100, 1 << 30);
+   long long expected = 7 + 100ll * (1 << 30);
+   EXPECT_EQ(care::simd::reduceSum(RAJA::seq_exec{}, data.data(), 100, 7ll), expected);
+}
+
+#if defined(_OPENMP) && defined(RAJA_USE_OPENMP)
+
+TEST(simd, openmp)
+{
+   const int n = 1 << 20;
+   std::vector<double> data(n);
+
+   for (int i = 0; i < n; ++i) {
+      data[i] = (double) ((i * 7919ll) % 1000003);
+   }
+
+   data[12345] = -1.0;
+   data[654321] = 2e6;
+
+   EXPECT_EQ(care::simd::reduceMin(RAJA::omp_parallel_for_exec{}, data.data(), n, 0.0), -1.0);
+   EXPECT_EQ(care::simd::reduceMax(RAJA::omp_parallel_for_exec{}, data.data(), n, 0.0), 2e6);
+   EXPECT_EQ(care::simd::count(RAJA::omp_parallel_for_exec{}, data.data(), n, 2e6), 1);
+
+   care::simd::fill(RAJA::omp_parallel_for_exec{}, data.data(), n, 0.5);
+   EXPECT_EQ(care::simd::reduceSum(RAJA::omp_parallel_for_exec{}, data.data(), n, 1.0), 1.0 + 0.5 * n);
+}
+
+#endif // defined(_OPENMP) && defined(RAJA_USE_OPENMP)
@@ -124,6 +124,218 @@ GPU_TEST(Scan, test_scan_everywhere) {
    } LOOP_SEQUENTIAL_END
 }
 
+GPU_TEST(Scan, test_scan_many_blocks) {
+   // long enough to be split across threads by the host scan
+   const int starting_offset = 3;
+   int offset = starting_offset;
+   int start = 7;
+   int end = 100007;
+   int length = end - start;
+   int_ptr scan_Result(length);
+
+   SCAN_LOOP(i,start,end,pos,offset,i%3 == 0) {
+      scan_Result[i-start] = pos;
+   } SCAN_LOOP_END(length,pos,offset)
+
+   EXPECT_EQ(offset,starting_offset+(end+2)/3-(start+2)/3);
+
+   int expected = starting_offset;
+
+   LOOP_SEQUENTIAL_REF(i,start,end,expected) {
+      if (i%3 == 0) {
+         EXPECT_EQ(scan_Result[i-start],expected);
+         ++expected;
+      }
+   } LOOP_SEQUENTIAL_REF_END
+
+   offset = starting_offset;
+
+   SCAN_EVERYWHERE_LOOP(i,start,end,pos,offset,i%3 == 0) {
+      scan_Result[i-start] = pos;
+   } SCAN_EVERYWHERE_LOOP_END(length,pos,offset)
+
+   EXPECT_EQ(offset,starting_offset+(end+2)/3-(start+2)/3);
+
+   expected = starting_offset;
+
+   LOOP_SEQUENTIAL_REF(i,start,end,expected) {
+      EXPECT_EQ(scan_Result[i-start],expected);
+
+      if (i%3 == 0) {
+         ++expected;
+      }
+   } LOOP_SEQUENTIAL_REF_END
+
+   scan_Result.free();
+}
+
+GPU_TEST(Scan, test_scan_workspace_reuse) {
+   // more scans than count slots, with lengths that grow and shrink the workspace
+   for (int iteration = 0; iteration < 100; ++iteration) {
+      const int starting_offset = iteration;
+      int offset = starting_offset;
+      int length = (iteration % 10) * 1000 + iteration;
+      int_ptr scan_Result(length > 0 ? length : 1);
+
+      SCAN_LOOP(i,0,length,pos,offset,i%2 == 1) {
+         scan_Result[pos-starting_offset] = i;
+      } SCAN_LOOP_END(length,pos,offset)
+
+      EXPECT_EQ(offset,starting_offset+length/2);
+
+      const int numFound = offset-starting_offset;
+
+      LOOP_SEQUENTIAL(i,0,numFound) {
+         EXPECT_EQ(scan_Result[i],2*i+1);
+      } LOOP_SEQUENTIAL_END
+
+      scan_Result.free();
+
+      // scans after the workspaces are freed allocate new ones
+      if (iteration == 50) {
+         care::release_scan_workspaces();
+      }
+   }
+}
+
+GPU_TEST(Scan, test_exclusive_inclusive_scan) {
+   // long enough to be split into several chunks by the host scan
+   const int length = 100003;
+   int_ptr data(length);
+   int_ptr exclusive(length);
+   int_ptr inclusive(length);
+
+   LOOP_SEQUENTIAL(i,0,length) {
+      data[i] = i%7;
+   } LOOP_SEQUENTIAL_END
+
+   exclusive_scan<int, RAJAExec>(data, exclusive, length, RAJA::operators::plus<int>{}, 5, false);
+   inclusive_scan<int, RAJAExec>(data, inclusive, length, RAJA::operators::plus<int>{}, false);
+
+   int expected = 5;
+
+   LOOP_SEQUENTIAL_REF(i,0,length,expected) {
+      EXPECT_EQ(exclusive[i],expected);
+      expected += i%7;
+      EXPECT_EQ(inclusive[i],expected-5);
+   } LOOP_SEQUENTIAL_REF_END
+
+   // in place
+   exclusive_scan<int, RAJAExec>(data, nullptr, length, RAJA::operators::plus<int>{}, 0, true);
+
+   expected = 0;
+
+   LOOP_SEQUENTIAL_REF(i,0,length,expected) {
+      EXPECT_EQ(data[i],expected);
+      expected += i%7;
+   } LOOP_SEQUENTIAL_REF_END
+
+   data.free();
+   exclusive.free();
+   inclusive.free();
+}
+
+GPU_TEST(Scan, test_scan_64) {
+   // positions past the range of an int
+   const std::int64_t starting_offset = 3000000000LL;
+   std::int64_t offset = starting_offset;
+   const int length = 100003;
+   chai::ManagedArray<std::int64_t> scan_Result(length);
+   chai::ManagedArray<std::int64_t> everywhere_Result(length);
+
+   SCAN_LOOP_64(i,0,length,pos,offset,i%3 == 0) {
+      scan_Result[i/3] = pos;
+   } SCAN_LOOP_64_END(length,pos,offset)
+
+   EXPECT_EQ(offset,starting_offset+(length+2)/3);
+
+   LOOP_SEQUENTIAL(i,0,(length+2)/3) {
+      EXPECT_EQ(scan_Result[i],starting_offset+i);
+   } LOOP_SEQUENTIAL_END
+
+   offset = starting_offset;
+
+   SCAN_EVERYWHERE_LOOP_64(i,0,length,pos,offset,i%3 == 0) {
+      everywhere_Result[i] = pos;
+   } SCAN_EVERYWHERE_LOOP_64_END(length,pos,offset)
+
+   EXPECT_EQ(offset,starting_offset+(length+2)/3);
+
+   LOOP_SEQUENTIAL(i,0,length) {
+      EXPECT_EQ(everywhere_Result[i],starting_offset+(i+2)/3);
+   } LOOP_SEQUENTIAL_END
+
+   // a 64 bit size
+   exclusive_scan<std::int64_t, RAJAExec>(everywhere_Result, nullptr, (std::int64_t) length, RAJA::operators::plus<std::int64_t>{}, (std::int64_t) 0, true);
+
+   std::int64_t expected = 0;
+
+   LOOP_SEQUENTIAL_REF(i,0,length,expected) {
+      EXPECT_EQ(everywhere_Result[i],expected);
+      expected += starting_offset+(i+2)/3;
+   } LOOP_SEQUENTIAL_REF_END
+
+   scan_Result.free();
+   everywhere_Result.free();
+}
+
+GPU_TEST(Scan, test_scan_partition) {
+   // long enough to be split into several chunks by the host scan
+   const int length = 100003;
+   int_ptr first(length);
+   int_ptr second(length);
+   int_ptr third(length);
+   care::CategoryCounts<3> offsets = {{10, 20, 30}};
+
+   // every fourth index is in no category
+   SCAN_PARTITION_LOOP(i,0,length,3,category,pos,offsets,i%4 == 3 ? -1 : i%4) {
+      if (category == 0) {
+         first[pos-10] = i;
+      }
+      else if (category == 1) {
+         second[pos-20] = i;
+      }
+      else {
+         third[pos-30] = i;
+      }
+   } SCAN_PARTITION_LOOP_END(length,pos,offsets)
+
+   const int numFirst = (length+3)/4;
+   const int numSecond = (length+2)/4;
+   const int numThird = (length+1)/4;
+
+   EXPECT_EQ(offsets[0],10+numFirst);
+   EXPECT_EQ(offsets[1],20+numSecond);
+   EXPECT_EQ(offsets[2],30+numThird);
+
+   LOOP_SEQUENTIAL(i,0,numFirst) {
+      EXPECT_EQ(first[i],4*i);
+   } LOOP_SEQUENTIAL_END
+
+   LOOP_SEQUENTIAL(i,0,numSecond) {
+      EXPECT_EQ(second[i],4*i+1);
+   } LOOP_SEQUENTIAL_END
+
+   LOOP_SEQUENTIAL(i,0,numThird) {
+      EXPECT_EQ(third[i],4*i+2);
+   } LOOP_SEQUENTIAL_END
+
+   // an empty range keeps the offsets
+   care::CategoryCounts<3> emptyOffsets = {{1, 2, 3}};
+
+   SCAN_PARTITION_LOOP(i,0,0,3,category,pos,emptyOffsets,i%3) {
+      first[pos] = i;
+   } SCAN_PARTITION_LOOP_END(0,pos,emptyOffsets)
+
+   EXPECT_EQ(emptyOffsets[0],1);
+   EXPECT_EQ(emptyOffsets[1],2);
+   EXPECT_EQ(emptyOffsets[2],3);
+
+   first.free();
+   second.free();
+   third.free();
+}
+
 #if CARE_HAVE_LLNL_GLOBALID
 
 using globalID_ptr = chai::ManagedArray<globalID>;
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#define GPU_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/array_utils.h"
+#include "care/SearchIndex.h"
+
+// The Eytzinger order must be a permutation that visits the sorted
+// positions in order during an in order traversal.
+static void inOrder(int k, int n, int & next, bool & passed)
+{
+   if (k <= n) {
+      inOrder(2 * k, n, next, passed);
+      passed = passed && care::SearchIndex<int>::eytzingerRank(k, n) == next++;
+      inOrder(2 * k + 1, n, next, passed);
+   }
+}
+
+TEST(SearchIndex, eytzingerRank)
+{
+   for (int n = 1; n <= 130; ++n) {
+      int next = 0;
+      bool passed = true;
+      inOrder(1, n, next, passed);
+      EXPECT_TRUE(passed) << "n = " << n;
+      EXPECT_EQ(next, n);
+   }
+}
+
+// Compares every search against BinarySearch for sorted maps with
+// duplicates, queries below, between, on and above every entry.
+template <typename Exec>
+static void testSearchIndex()
+{
+   const int sizes[] = {0, 1, 2, 7, 64, 100};
+
+   for (int size : sizes) {
+      const int start = size > 2 ? 2 : 0;
+      const int mapSize = size - start;
+      care::host_device_ptr<int> map(size > 0 ? size : 1, "map");
+
+      LOOP_SEQUENTIAL(i, 0, size) {
+         map[i] = 2 * (i / 2) + 4 * (i / 5);
+      } LOOP_SEQUENTIAL_END
+
+      care::SearchIndex<int> index(map, start, mapSize);
+
+      const int numQueries = 3 * size + 4;
+      care::host_device_ptr<int> queries(numQueries, "queries");
+      care::host_device_ptr<int> results(numQueries, "results");
+      care::host_device_ptr<int> upperResults(numQueries, "upperResults");
+
+      LOOP_SEQUENTIAL(i, 0, numQueries) {
+         queries[i] = i - 2;
+      } LOOP_SEQUENTIAL_END
+
+      care::BatchBinarySearch<int>(Exec{}, index, queries, numQueries, results);
+      care::BatchBinarySearch<int>(Exec{}, index, queries, numQueries, upperResults, true);
+
+      care::host_ptr<const int> hostMap = map;
+
+      for (int i = 0; i < numQueries; ++i) {
+         const int query = queries.pick(i);
+         const int expected = care_utils::BinarySearch<int>(hostMap, start, mapSize, query);
+         const int expectedUpper = care_utils::BinarySearch<int>(hostMap, start, mapSize, query, true);
+         const int result = results.pick(i);
+
+         // BinarySearch may return any of several equal entries
+         if (expected == -1) {
+            EXPECT_EQ(result, -1);
+         }
+         else {
+            ASSERT_GE(result, start);
+            EXPECT_EQ(hostMap[result], query);
+         }
+
+         EXPECT_EQ(upperResults.pick(i), expectedUpper);
+         EXPECT_EQ(index.hostFind(query, true), expectedUpper);
+
+         const int lowerBound = index.hostLowerBound(query);
+         EXPECT_EQ(lowerBound, care_utils::GallopSearch<int>(hostMap, start, mapSize, query));
+      }
+
+      upperResults.free();
+      results.free();
+      queries.free();
+      index.free();
+      map.free();
+   }
+}
+
+TEST(SearchIndex, BatchBinarySearch)
+{
+   testSearchIndex<RAJAExec>();
+   testSearchIndex<RAJA::seq_exec>();
+}
+
+#if defined(__GPUCC__)
+
+// Adapted from CHAI
+#define GPU_TEST(X, Y) \
+   static void gpu_test_##X##Y(); \
+   TEST(X, gpu_test_##Y) { gpu_test_##X##Y(); } \
+   static void gpu_test_##X##Y()
+
+GPU_TEST(SearchIndex, BatchBinarySearch)
+{
+   testSearchIndex<RAJAExec>();
+}
+
+#endif // __GPUCC__
+
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+#define GPU_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/unordered_map.h"
+
+// Maps scattered global IDs, some repeated, to local indices and checks
+// lookups of present and absent IDs inside a loop.
+static void testGlobalToLocal()
+{
+   const int n = 1000;
+   care::host_device_ptr<long long> globalIDs(n, "globalIDs");
+
+   LOOP_STREAM(i, 0, n) {
+      // every tenth entry repeats the ID of the entry before it
+      const int j = i % 10 == 9 ? i - 1 : i;
+      globalIDs[i] = 7919ll * j + 1000000007ll;
+   } LOOP_STREAM_END
+
+   care::unordered_map<long long> globalToLocal(globalIDs, n);
+
+   EXPECT_EQ(globalToLocal.size(), n - n / 10);
+   EXPECT_GE(globalToLocal.capacity(), 2 * globalToLocal.size());
+
+   RAJAReduceMin<bool> passed{true};
+
+   LOOP_REDUCE(i, 0, n) {
+      const int expected = i % 10 == 9 ? i - 1 : i;
+
+      if (globalToLocal.lookup(globalIDs[i], -1) != expected) {
+         passed.min(false);
+      }
+
+      if (globalToLocal.contains(globalIDs[i] + 1)) {
+         passed.min(false);
+      }
+   } LOOP_REDUCE_END
+
+   ASSERT_TRUE((bool) passed);
+
+   // Queries on the host outside of a loop, after a build on the device
+   EXPECT_EQ(globalToLocal.hostLookup(1000000007ll, -1), 0);
+   EXPECT_EQ(globalToLocal.hostLookup(7919ll * 8 + 1000000007ll, -1), 8);
+   EXPECT_TRUE(globalToLocal.hostContains(7919ll * 998 + 1000000007ll));
+   EXPECT_FALSE(globalToLocal.hostContains(1000000008ll));
+
+   globalToLocal.free();
+   EXPECT_TRUE(globalToLocal.empty());
+   EXPECT_EQ(globalToLocal.hostLookup(1000000007ll, -1), -1);
+
+   globalIDs.free();
+}
+
+TEST(unordered_map, global_to_local)
+{
+   testGlobalToLocal();
+}
+
+TEST(unordered_map, values)
+{
+   const int n = 4;
+   int keyData[n] = {30, -2, 30, 5};
+   double valueData[n] = {1.5, 2.5, 3.5, 4.5};
+   care::host_device_ptr<const int> keys(keyData, n, "keys");
+   care::host_device_ptr<const double> values(valueData, n, "values");
+
+   care::unordered_map<int, double> map(keys, values, n);
+
+   EXPECT_EQ(map.size(), 3);
+   EXPECT_EQ(map.hostLookup(30, 0.0), 1.5);
+   EXPECT_EQ(map.hostLookup(-2, 0.0), 2.5);
+   EXPECT_EQ(map.hostLookup(5, 0.0), 4.5);
+   EXPECT_EQ(map.hostLookup(6, -1.0), -1.0);
+
+   RAJAReduceSum<double> found{0.0};
+
+   LOOP_REDUCE(i, 0, 1) {
+      found += map.lookup(30, 0.0) + map.lookup(-2, 0.0) + map.lookup(5, 0.0) + map.lookup(6, -1.0);
+   } LOOP_REDUCE_END
+
+   EXPECT_EQ((double) found, 1.5 + 2.5 + 4.5 - 1.0);
+
+   map.free();
+
+   care::unordered_map<int, double> emptyMap(keys, values, 0);
+   EXPECT_TRUE(emptyMap.empty());
+   EXPECT_FALSE(emptyMap.hostContains(30));
+   emptyMap.free();
+}
+
+#if defined(__GPUCC__)
+
+// Adapted from CHAI
+#define GPU_TEST(X, Y) \
+   static void gpu_test_##X##Y(); \
+   TEST(X, gpu_test_##Y) { gpu_test_##X##Y(); } \
+   static void gpu_test_##X##Y()
+
+GPU_TEST(unordered_map, global_to_local)
+{
+   testGlobalToLocal();
+}
+
+#endif // __GPUCC__
+
@@ -0,0 +1,140 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// Copyright 2020 Lawrence Livermore National Security, LLC and other CARE developers.
+// See the top-level LICENSE file for details.
+//
+// SPDX-License-Identifier: BSD-3-Clause
+//////////////////////////////////////////////////////////////////////////////////////
+
+// Run the work stealing loops on the OpenMP threads
+#define OPENMP_ACTIVE
+
+#include "care/config.h"
+
+// other library headers
+#include "gtest/gtest.h"
+
+// care headers
+#include "care/care.h"
+
+// std library headers
+#include <atomic>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+// Uses several threads for the scope of a test, even on a machine with one core
+class WorkStealingThreads {
+   public:
+      explicit WorkStealingThreads(const int numThreads) {
+#if defined(_OPENMP)
+         m_num_threads = omp_get_max_threads();
+         omp_set_num_threads(numThreads);
+#else
+         (void) numThreads;
+#endif
+      }
+
+      ~WorkStealingThreads() {
+#if defined(_OPENMP)
+         omp_set_num_threads(m_num_threads);
+#endif
+      }
+
+   private:
+      int m_num_threads = 1;
+};
+
+// Every index must run exactly once, however the range is split and stolen.
+// Iterations near the start of the range are much more expensive, so the
+// threads given the end of the range run out and steal.
+TEST(WorkStealing, visitsEachIndexOnce)
+{
+   WorkStealingThreads threads(4);
+   const int start = 5;
+   const int end = 20005;
+   std::vector<std::atomic<int>> visits(end);
+
+   for (std::atomic<int> & visit : visits) {
+      visit.store(0);
+   }
+
+   std::atomic<int> * counts = visits.data();
+
+   care::work_stealing_forall(start, end, [=] (const int i) {
+      volatile double work = 0.0;
+
+      for (int k = 0; k < (i < 1000 ? 1000 : 10); ++k) {
+         work = work + k;
+      }
+
+      counts[i].fetch_add(1);
+   });
+
+   for (int i = 0; i < end; ++i) {
+      EXPECT_EQ(visits[i].load(), i < start ? 0 : 1);
+   }
+}
+
+TEST(WorkStealing, emptyRange)
+{
+   int calls = 0;
+   int * callsPtr = &calls;
+
+   care::work_stealing_forall(5, 5, [=] (const int) { ++*callsPtr; });
+   care::work_stealing_forall(5, 2, [=] (const int) { ++*callsPtr; });
+
+   EXPECT_EQ(calls, 0);
+}
+
+TEST(WorkStealing, dynamicLoop)
+{
+   const int length = 10000;
+   care::host_device_ptr<int> values(length, "values");
+
+   CARE_DYNAMIC_LOOP(i, 0, length) {
+      values[i] = 2 * i;
+   } CARE_DYNAMIC_LOOP_END
+
+   RAJAReduceMin<bool> passed{true};
+
+   LOOP_REDUCE(i, 0, length) {
+      if (values[i] != 2 * i) {
+         passed.min(false);
+      }
+   } LOOP_REDUCE_END
+
+   EXPECT_TRUE((bool) passed);
+
+   values.free();
+}
+
+// Each thread reduces into its own copy of the body. Iterations near the end
+// of the range are much more expensive, so the work is stolen from the last
+// thread and the reducers are updated from threads other than their owner.
+TEST(WorkStealing, dynamicLoopReductions)
+{
+   WorkStealingThreads threads(4);
+
+   const int length = 20000;
+   RAJAReduceSum<long long> sum(0);
+   RAJAReduceMin<int> minimum(length);
+   RAJAReduceMax<int> maximum(-1);
+
+   CARE_DYNAMIC_LOOP(i, 0, length) {
+      volatile int work = 0;
+
+      for (int k = 0; k < (i >= length - 2000 ? 2000 : 1); ++k) {
+         work = work + k;
+      }
+
+      sum += i;
+      minimum.min(i);
+      maximum.max(i);
+   } CARE_DYNAMIC_LOOP_END
+
+   EXPECT_EQ((long long) sum, (long long) length * (length - 1) / 2);
+   EXPECT_EQ((int) minimum, 0);
+   EXPECT_EQ((int) maximum, length - 1);
+}